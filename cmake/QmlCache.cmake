@@ -0,0 +1,66 @@
+# install_qml(file1 [file2 [...]] DESTINATION dir)
+#
+# Installs QML and JavaScript files, and whatever they use, together with the compilation units
+# qmlcachegen generates for them, "file.qmlc" and "file.jsc", so that the
+# engine doesn't have to compile them when they are first loaded.
+#
+# A cache is only used when it was generated by the same build of Qt from a
+# source with the same modification time (install() keeps those of the
+# sources); otherwise the engine falls back to compiling the source, as it
+# does when no cache was installed.
+#
+# Without qmlcachegen (Qt < 5.9), or with ENABLE_QML_CACHE off, only the
+# sources are installed.
+
+include(CMakeParseArguments)
+
+option(ENABLE_QML_CACHE "Install ahead-of-time compiled QML" ON)
+
+if(ENABLE_QML_CACHE)
+  if(TARGET Qt5::qmake)
+    get_target_property(qmlcache_qmake Qt5::qmake IMPORTED_LOCATION)
+    get_filename_component(qmlcache_qt_bin ${qmlcache_qmake} PATH)
+  endif()
+  find_program(qmlcachegen_exe qmlcachegen HINTS ${qmlcache_qt_bin})
+  if(NOT qmlcachegen_exe)
+    message(STATUS "qmlcachegen not found, QML will be compiled at run time")
+  endif()
+endif()
+
+function(install_qml)
+  cmake_parse_arguments(qml "" "DESTINATION" "" ${ARGN})
+  install(FILES ${qml_UNPARSED_ARGUMENTS} DESTINATION ${qml_DESTINATION})
+
+  if(NOT ENABLE_QML_CACHE OR NOT qmlcachegen_exe)
+    return()
+  endif()
+
+  set(caches "")
+  file(MAKE_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}/qmlcache)
+  foreach(source ${qml_UNPARSED_ARGUMENTS})
+    # Images and data that live with the QML are installed as they are.
+    if(source MATCHES "\\.(qml|js)$")
+      get_filename_component(name ${source} NAME)
+      get_filename_component(source_path ${source} ABSOLUTE)
+      set(cache ${CMAKE_CURRENT_BINARY_DIR}/qmlcache/${name}c)
+      add_custom_command(OUTPUT ${cache}
+                         COMMAND ${qmlcachegen_exe} -o ${cache} ${source_path}
+                         DEPENDS ${source_path}
+                         COMMENT "Compiling ${name}")
+      list(APPEND caches ${cache})
+    endif()
+  endforeach()
+
+  if(NOT caches)
+    return()
+  endif()
+
+  # Named after the directory and the first file, for a unique name.
+  file(RELATIVE_PATH target_dir ${CMAKE_SOURCE_DIR} ${CMAKE_CURRENT_SOURCE_DIR})
+  list(GET caches 0 target_file)
+  get_filename_component(target_file ${target_file} NAME_WE)
+  string(REGEX REPLACE "[^A-Za-z0-9_-]" "_" target
+         "qmlcache-${target_dir}-${target_file}")
+  add_custom_target(${target} ALL DEPENDS ${caches})
+  install(FILES ${caches} DESTINATION ${qml_DESTINATION})
+endfunction()
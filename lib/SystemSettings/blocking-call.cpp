@@ -0,0 +1,48 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "blocking-call.h"
+
+#include <QAtomicPointer>
+#include <QCoreApplication>
+#include <QThread>
+
+using namespace SystemSettings;
+
+static QAtomicPointer<const char> currentCall;
+
+BlockingCall::BlockingCall(const char *name):
+    m_previous(0),
+    m_guiThread(QCoreApplication::instance() &&
+                QThread::currentThread() ==
+                QCoreApplication::instance()->thread())
+{
+    if (m_guiThread)
+        m_previous = currentCall.fetchAndStoreOrdered(name);
+}
+
+BlockingCall::~BlockingCall()
+{
+    if (m_guiThread)
+        currentCall.storeRelease(m_previous);
+}
+
+const char *BlockingCall::current()
+{
+    return currentCall.loadAcquire();
+}
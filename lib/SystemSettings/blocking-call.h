@@ -0,0 +1,53 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYSTEM_SETTINGS_BLOCKING_CALL_H
+#define SYSTEM_SETTINGS_BLOCKING_CALL_H
+
+#include <QtGlobal>
+
+namespace SystemSettings {
+
+/* Names a call that blocks the GUI thread, such as a synchronous D-Bus
+ * call or a nested event loop, while it is in scope:
+ *
+ *     SystemSettings::BlockingCall blocking("FlightModeHelper::IsFlightMode");
+ *     reply.waitForFinished();
+ *
+ * When the stall watchdog (SS_STALL_WATCHDOG) sees the event loop stall,
+ * it attributes the stall to the innermost named call. The name must stay
+ * valid while the call is in scope; use a string literal. Calls made on
+ * other threads are ignored. */
+class BlockingCall
+{
+public:
+    explicit BlockingCall(const char *name);
+    ~BlockingCall();
+
+    // The innermost call on the GUI thread, or null. Safe from any thread.
+    static const char *current();
+
+private:
+    Q_DISABLE_COPY(BlockingCall)
+    const char *m_previous;
+    bool m_guiThread;
+};
+
+} // namespace
+
+#endif // SYSTEM_SETTINGS_BLOCKING_CALL_H
@@ -0,0 +1,196 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "dbus-stats.h"
+
+#include <QDBusPendingCallWatcher>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+
+using namespace SystemSettings;
+
+// Upper bounds of 1, 2, 4, ... 1024 ms, and one for anything slower.
+#define HISTOGRAM_BUCKETS 12
+
+namespace {
+
+struct Entry {
+    int sync = 0;
+    int async = 0;
+    qint64 total = 0;
+    qint64 longest = 0;
+    int histogram[HISTOGRAM_BUCKETS] = {};
+};
+
+QMutex statsMutex;
+// Keyed by panel, service and member, which is also the order of the dump.
+QMap<QString, Entry> stats;
+QString currentPanel;
+
+} // namespace
+
+DBusStats::Call::Call(const char *panel, const QString &service,
+                      const QString &member)
+{
+    if (!isEnabled())
+        return;
+
+    m_panel = panelName(panel);
+    m_service = service;
+    m_member = member;
+    m_timer.start();
+}
+
+DBusStats::Call::~Call()
+{
+    if (m_timer.isValid())
+        instance()->record(m_panel, m_service, m_member, false,
+                           m_timer.elapsed());
+}
+
+DBusStats::DBusStats(QObject *parent):
+    QObject(parent)
+{
+}
+
+DBusStats *DBusStats::instance()
+{
+    static DBusStats *dbusStats = new DBusStats();
+    return dbusStats;
+}
+
+bool DBusStats::isEnabled()
+{
+    static const bool enabled = qEnvironmentVariableIsSet("SS_DBUS_STATS");
+    return enabled;
+}
+
+void DBusStats::waitForFinished(QDBusPendingCall &call, const char *panel,
+                                const QString &service, const QString &member)
+{
+    Call stats(panel, service, member);
+    call.waitForFinished();
+}
+
+void DBusStats::watch(const QDBusPendingCall &call, const char *panel,
+                      const QString &service, const QString &member)
+{
+    if (!isEnabled())
+        return;
+
+    const QString name = panelName(panel);
+    QElapsedTimer timer;
+    timer.start();
+
+    QDBusPendingCallWatcher *watcher =
+        new QDBusPendingCallWatcher(call, instance());
+    QObject::connect(watcher, &QDBusPendingCallWatcher::finished,
+                     [=](QDBusPendingCallWatcher *w) {
+        instance()->record(name, service, member, true, timer.elapsed());
+        w->deleteLater();
+    });
+}
+
+void DBusStats::setCurrentPanel(const QString &panel)
+{
+    QMutexLocker locker(&statsMutex);
+    currentPanel = panel;
+}
+
+int DBusStats::bucket(qint64 msecs)
+{
+    int i = 0;
+    while (i < HISTOGRAM_BUCKETS - 1 && msecs >= (1 << i))
+        i++;
+    return i;
+}
+
+QString DBusStats::panelName(const char *panel)
+{
+    if (panel)
+        return QString::fromUtf8(panel);
+
+    QMutexLocker locker(&statsMutex);
+    return currentPanel.isEmpty() ? QStringLiteral("main") : currentPanel;
+}
+
+void DBusStats::record(const QString &panel, const QString &service,
+                       const QString &member, bool async, qint64 msecs)
+{
+    QMutexLocker locker(&statsMutex);
+    Entry &entry = stats[panel + '\n' + service + '\n' + member];
+    if (async)
+        entry.async++;
+    else
+        entry.sync++;
+    entry.total += msecs;
+    entry.longest = qMax(entry.longest, msecs);
+    entry.histogram[bucket(msecs)]++;
+}
+
+QByteArray DBusStats::toJson() const
+{
+    QJsonArray buckets;
+    for (int i = 0; i < HISTOGRAM_BUCKETS - 1; i++)
+        buckets.append(1 << i);
+
+    QJsonArray calls;
+    QMutexLocker locker(&statsMutex);
+    QMapIterator<QString, Entry> it(stats);
+    while (it.hasNext()) {
+        it.next();
+        const QStringList key = it.key().split('\n');
+        const Entry &entry = it.value();
+
+        QJsonArray histogram;
+        for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+            histogram.append(entry.histogram[i]);
+
+        QJsonObject call;
+        call["panel"] = key.at(0);
+        call["service"] = key.at(1);
+        call["member"] = key.at(2);
+        call["sync"] = entry.sync;
+        call["async"] = entry.async;
+        call["totalMs"] = entry.total;
+        call["longestMs"] = entry.longest;
+        call["histogram"] = histogram;
+        calls.append(call);
+    }
+    locker.unlock();
+
+    QJsonObject root;
+    root["bucketsMs"] = buckets;
+    root["calls"] = calls;
+    return QJsonDocument(root).toJson();
+}
+
+QString DBusStats::Dump() const
+{
+    return QString::fromUtf8(toJson());
+}
+
+void DBusStats::Reset()
+{
+    QMutexLocker locker(&statsMutex);
+    stats.clear();
+}
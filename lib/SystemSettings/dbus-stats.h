@@ -0,0 +1,91 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYSTEM_SETTINGS_DBUS_STATS_H
+#define SYSTEM_SETTINGS_DBUS_STATS_H
+
+#include <QDBusPendingCall>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+
+namespace SystemSettings {
+
+/* Counts the D-Bus calls made by each panel and records how long they take,
+ * per panel, service and member, in a histogram of power of two buckets
+ * (in milliseconds). Only enabled when SS_DBUS_STATS is set; the counts can
+ * then be dumped as JSON over the session bus:
+ *
+ *     gdbus call --session --dest <unique name of system-settings> \
+ *         --object-path /com/canonical/SystemSettings/DBusStats \
+ *         --method com.canonical.SystemSettings.DBusStats.Dump
+ *
+ * Calls made by shared code pass no panel, and are counted for the panel
+ * whose page was opened last. */
+class DBusStats: public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.canonical.SystemSettings.DBusStats")
+
+public:
+    // Times a synchronous call while in scope.
+    class Call
+    {
+    public:
+        Call(const char *panel, const QString &service, const QString &member);
+        ~Call();
+
+    private:
+        Q_DISABLE_COPY(Call)
+        QString m_panel;
+        QString m_service;
+        QString m_member;
+        QElapsedTimer m_timer;
+    };
+
+    static DBusStats *instance();
+    static bool isEnabled();
+
+    // Waits for call, counted as a synchronous call.
+    static void waitForFinished(QDBusPendingCall &call, const char *panel,
+                                const QString &service, const QString &member);
+    // Times an asynchronous call until its reply arrives.
+    static void watch(const QDBusPendingCall &call, const char *panel,
+                      const QString &service, const QString &member);
+    static void setCurrentPanel(const QString &panel);
+
+    /* The histogram bucket of a call taking msecs: bucket i counts calls
+     * under 2^i ms, the last one anything slower. */
+    static int bucket(qint64 msecs);
+
+    QByteArray toJson() const;
+
+public Q_SLOTS:
+    Q_SCRIPTABLE QString Dump() const;
+    Q_SCRIPTABLE void Reset();
+
+private:
+    explicit DBusStats(QObject *parent = 0);
+    static QString panelName(const char *panel);
+    void record(const QString &panel, const QString &service,
+                const QString &member, bool async, qint64 msecs);
+};
+
+} // namespace
+
+#endif // SYSTEM_SETTINGS_DBUS_STATS_H
@@ -42,6 +42,7 @@ const QLatin1String keyHasDynamicName("has-dynamic-name");
 const QLatin1String keyHasDynamicVisibility("has-dynamic-visibility");
 const QLatin1String keyHideByDefault("hide-by-default");
 const QLatin1String keyVisibleIfFileExists("visible-if-file-exists");
+const QLatin1String keyVisibleIf("visible-if");
 
 class ItemBasePrivate
 {
@@ -56,13 +57,15 @@ private:
     QString m_name;
     QStringList m_keywords;
     bool m_isVisible;
+    bool m_isReady;
 };
 
 } // namespace
 
 ItemBasePrivate::ItemBasePrivate(const QVariantMap &staticData):
     m_data(staticData),
-    m_isVisible(false)
+    m_isVisible(false),
+    m_isReady(true)
 {
 }
 
@@ -133,6 +136,20 @@ bool ItemBase::isVisible() const
     return d->m_isVisible;
 }
 
+void ItemBase::setReady(bool ready)
+{
+    Q_D(ItemBase);
+    if (ready == d->m_isReady) return;
+    d->m_isReady = ready;
+    Q_EMIT readyChanged();
+}
+
+bool ItemBase::isReady() const
+{
+    Q_D(const ItemBase);
+    return d->m_isReady;
+}
+
 const QVariantMap &ItemBase::staticData() const
 {
     Q_D(const ItemBase);
@@ -42,6 +42,7 @@ extern const QLatin1String keyHasDynamicName;
 extern const QLatin1String keyHasDynamicVisibility;
 extern const QLatin1String keyHideByDefault;
 extern const QLatin1String keyVisibleIfFileExists;
+extern const QLatin1String keyVisibleIf;
 
 class ItemBasePrivate;
 class ItemBase: public QObject
@@ -56,6 +57,8 @@ public:
     QStringList keywords() const;
     QString name() const;
     bool isVisible() const;
+    // False while the backend of the item is still being set up.
+    bool isReady() const;
     virtual QQmlComponent *entryComponent(QQmlEngine *engine,
                                           QObject *parent = 0);
     virtual QQmlComponent *pageComponent(QQmlEngine *engine,
@@ -66,6 +69,7 @@ protected:
     void setKeywords(const QStringList &keywords);
     void setName(const QString &name);
     void setVisible(bool visible);
+    void setReady(bool ready);
     const QVariantMap &staticData() const;
 
 Q_SIGNALS:
@@ -73,6 +77,7 @@ Q_SIGNALS:
     void keywordsChanged();
     void nameChanged();
     void visibilityChanged();
+    void readyChanged();
 
 private:
     ItemBasePrivate *d_ptr;
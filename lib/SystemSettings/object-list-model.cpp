@@ -0,0 +1,131 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "object-list-model.h"
+
+#include <QMetaMethod>
+#include <QMetaProperty>
+
+using namespace SystemSettings;
+
+ObjectListModelBase::ObjectListModelBase(QObject *parent):
+    QAbstractListModel(parent),
+    m_resolvedFor(0),
+    m_keySignal(-1)
+{
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(0);
+    QObject::connect(&m_flushTimer, SIGNAL(timeout()),
+                     this, SLOT(slotFlushChanges()));
+}
+
+ObjectListModelBase::~ObjectListModelBase()
+{
+}
+
+void ObjectListModelBase::addPropertyRole(const char *name, int role)
+{
+    QVector<int> &roles = m_propertyRoles[name];
+    if (!roles.contains(role))
+        roles.append(role);
+    m_resolvedFor = 0;
+}
+
+void ObjectListModelBase::setKeyProperty(const char *name)
+{
+    m_keyProperty = name;
+    m_resolvedFor = 0;
+}
+
+void ObjectListModelBase::resolveSignals(const QMetaObject *metaObject)
+{
+    m_signalRoles.clear();
+    m_keySignal = -1;
+
+    for (int i = 0; i < metaObject->propertyCount(); i++) {
+        QMetaProperty property = metaObject->property(i);
+        if (!property.hasNotifySignal())
+            continue;
+
+        const QByteArray name(property.name());
+        if (m_propertyRoles.contains(name))
+            m_signalRoles[property.notifySignalIndex()] += m_propertyRoles[name];
+        if (name == m_keyProperty)
+            m_keySignal = property.notifySignalIndex();
+    }
+    m_resolvedFor = metaObject;
+}
+
+void ObjectListModelBase::watchItem(QObject *item)
+{
+    const QMetaObject *metaObject = item->metaObject();
+    if (metaObject != m_resolvedFor)
+        resolveSignals(metaObject);
+
+    static const QMetaMethod slot = staticMetaObject.method(
+        staticMetaObject.indexOfSlot("slotItemPropertyChanged()"));
+
+    QList<int> signalIndexes = m_signalRoles.keys();
+    if (m_keySignal >= 0 && !m_signalRoles.contains(m_keySignal))
+        signalIndexes.append(m_keySignal);
+
+    Q_FOREACH(int index, signalIndexes)
+        QObject::connect(item, metaObject->method(index), this, slot);
+}
+
+void ObjectListModelBase::unwatchItem(QObject *item)
+{
+    QObject::disconnect(item, 0, this, SLOT(slotItemPropertyChanged()));
+    m_pendingChanges.remove(item);
+}
+
+void ObjectListModelBase::slotItemPropertyChanged()
+{
+    QObject *item = sender();
+    const int index = senderSignalIndex();
+
+    if (index == m_keySignal)
+        keyChanged(item);
+
+    const QVector<int> roles = m_signalRoles.value(index);
+    if (roles.isEmpty())
+        return;
+
+    QVector<int> &pending = m_pendingChanges[item];
+    Q_FOREACH(int role, roles) {
+        if (!pending.contains(role))
+            pending.append(role);
+    }
+    m_flushTimer.start();
+}
+
+void ObjectListModelBase::slotFlushChanges()
+{
+    QHash<QObject*, QVector<int> > changes;
+    changes.swap(m_pendingChanges);
+
+    QHashIterator<QObject*, QVector<int> > it(changes);
+    while (it.hasNext()) {
+        it.next();
+        const int row = rowOf(it.key());
+        if (row < 0)
+            continue;
+        const QModelIndex changed = index(row, 0);
+        Q_EMIT(dataChanged(changed, changed, it.value()));
+    }
+}
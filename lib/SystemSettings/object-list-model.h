@@ -0,0 +1,274 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYSTEM_SETTINGS_OBJECT_LIST_MODEL_H
+#define SYSTEM_SETTINGS_OBJECT_LIST_MODEL_H
+
+#include <QAbstractListModel>
+#include <QByteArray>
+#include <QDBusObjectPath>
+#include <QHash>
+#include <QSharedPointer>
+#include <QString>
+#include <QTimer>
+#include <QVariantMap>
+#include <QVector>
+
+namespace SystemSettings {
+
+/* The part of ObjectListModel that doesn't depend on the item type, and
+ * so can have slots: it turns the notify signals of the items' properties
+ * into dataChanged() for the roles showing them. Changes are coalesced
+ * until the event loop runs again, so that an item updating several
+ * properties at once is announced once, with all of their roles. */
+class ObjectListModelBase: public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit ObjectListModelBase(QObject *parent = 0);
+    ~ObjectListModelBase();
+
+protected:
+    // Changes of the item property name are shown in role.
+    void addPropertyRole(const char *name, int role);
+    // The property items can be looked up by, besides their path.
+    void setKeyProperty(const char *name);
+    QByteArray keyProperty() const { return m_keyProperty; }
+
+    void watchItem(QObject *item);
+    void unwatchItem(QObject *item);
+
+    virtual int rowOf(QObject *item) const = 0;
+    virtual void keyChanged(QObject *item) = 0;
+
+private Q_SLOTS:
+    void slotItemPropertyChanged();
+    void slotFlushChanges();
+
+private:
+    void resolveSignals(const QMetaObject *metaObject);
+
+    QHash<QByteArray, QVector<int> > m_propertyRoles;
+    QByteArray m_keyProperty;
+
+    // Roles, and whether the key changed, by notify signal index.
+    const QMetaObject *m_resolvedFor;
+    QHash<int, QVector<int> > m_signalRoles;
+    int m_keySignal;
+
+    QHash<QObject*, QVector<int> > m_pendingChanges;
+    QTimer m_flushTimer;
+};
+
+/* A list model of the objects of a D-Bus service that implement interface,
+ * as announced by the service's org.freedesktop.DBus.ObjectManager.
+ *
+ * Items are kept in row order in a vector, and indexed by object path and
+ * by their key property in hashes, so that finding and updating an item
+ * doesn't walk the list; removing one renumbers the rows after it. An
+ * object that is announced again has its new properties applied to the
+ * existing item, instead of being replaced.
+ *
+ * Item must be a QObject with a QString getPath() const and a
+ * setProperties(const QVariantMap &) that emits the notify signals of the
+ * properties that changed. Subclasses create the items in createItem(),
+ * and map the item properties to their roles with addPropertyRole(). */
+template <class Item>
+class ObjectListModel: public ObjectListModelBase
+{
+public:
+    typedef QSharedPointer<Item> ItemPointer;
+
+    explicit ObjectListModel(const QString &interface, QObject *parent = 0):
+        ObjectListModelBase(parent),
+        m_interface(interface)
+    {
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const
+    {
+        Q_UNUSED(parent);
+        return m_items.size();
+    }
+
+    ItemPointer itemAt(int row) const
+    {
+        return 0 <= row && row < m_items.size() ? m_items[row] : ItemPointer();
+    }
+
+    ItemPointer itemFromPath(const QString &path) const
+    {
+        return itemAt(m_rows.value(path, -1));
+    }
+
+    ItemPointer itemFromKey(const QString &key) const
+    {
+        return itemFromPath(m_pathsByKey.value(key));
+    }
+
+    QString interface() const { return m_interface; }
+
+    /* Follows the objects announced by manager, a proxy generated for
+     * org.freedesktop.DBus.ObjectManager. The objects it has already are
+     * passed to addObjects() by the caller, once GetManagedObjects() is
+     * answered. */
+    template <class Manager>
+    void watchManager(Manager *manager)
+    {
+        QObject::connect(manager, &Manager::InterfacesAdded, this,
+            [this](const QDBusObjectPath &path,
+                   const QMap<QString, QVariantMap> &interfaces) {
+                if (interfaces.contains(m_interface))
+                    addObject(path.path(), interfaces.value(m_interface));
+            });
+        QObject::connect(manager, &Manager::InterfacesRemoved, this,
+            [this](const QDBusObjectPath &path, const QStringList &interfaces) {
+                if (interfaces.contains(m_interface))
+                    removeObject(path.path());
+            });
+    }
+
+    // objects is the reply of GetManagedObjects().
+    template <class ObjectList>
+    void addObjects(const ObjectList &objects)
+    {
+        for (auto it = objects.constBegin(); it != objects.constEnd(); ++it) {
+            if (it.value().contains(m_interface))
+                addObject(it.key().path(), it.value().value(m_interface));
+        }
+    }
+
+    ItemPointer addObject(const QString &path, const QVariantMap &properties)
+    {
+        if (!acceptsObject(path))
+            return ItemPointer();
+
+        const int row = m_rows.value(path, -1);
+        if (row >= 0) {
+            m_items[row]->setProperties(properties);
+            return m_items[row];
+        }
+
+        /* createItem() may run a nested event loop, in which the same
+         * object can be announced again and added; that item has the newer
+         * properties, so it is kept and the one created here dropped. */
+        ItemPointer item = createItem(path, properties);
+        if (!item)
+            return item;
+
+        const int added = m_rows.value(path, -1);
+        if (added >= 0)
+            return m_items[added];
+
+        const int count = m_items.size();
+        beginInsertRows(QModelIndex(), count, count);
+        m_items.append(item);
+        m_rows.insert(path, count);
+        indexKey(item.data());
+        endInsertRows();
+
+        watchItem(item.data());
+        return item;
+    }
+
+    void removeObject(const QString &path)
+    {
+        const int row = m_rows.value(path, -1);
+        if (row < 0)
+            return;
+
+        beginRemoveRows(QModelIndex(), row, row);
+        ItemPointer item = m_items[row];
+        unwatchItem(item.data());
+        unindexKey(item.data());
+        m_items.remove(row);
+        m_rows.remove(path);
+        for (int i = row; i < m_items.size(); i++)
+            m_rows[m_items[i]->getPath()] = i;
+        endRemoveRows();
+    }
+
+    void clear()
+    {
+        beginResetModel();
+        Q_FOREACH(const ItemPointer &item, m_items)
+            unwatchItem(item.data());
+        m_items.clear();
+        m_rows.clear();
+        m_keys.clear();
+        m_pathsByKey.clear();
+        endResetModel();
+    }
+
+protected:
+    // Returns a new item for the object at path, or null to leave it out.
+    virtual ItemPointer createItem(const QString &path,
+                                   const QVariantMap &properties) = 0;
+
+    virtual bool acceptsObject(const QString &path) const
+    {
+        Q_UNUSED(path);
+        return true;
+    }
+
+    int rowOf(QObject *item) const
+    {
+        return m_rows.value(static_cast<Item*>(item)->getPath(), -1);
+    }
+
+    void keyChanged(QObject *item)
+    {
+        unindexKey(item);
+        indexKey(item);
+    }
+
+private:
+    void indexKey(QObject *item)
+    {
+        const QString key = keyOf(item);
+        if (key.isEmpty())
+            return;
+        m_keys.insert(item, key);
+        m_pathsByKey.insert(key, static_cast<Item*>(item)->getPath());
+    }
+
+    void unindexKey(QObject *item)
+    {
+        const QString key = m_keys.take(item);
+        const QString path = static_cast<Item*>(item)->getPath();
+        if (!key.isEmpty() && m_pathsByKey.value(key) == path)
+            m_pathsByKey.remove(key);
+    }
+
+    QString keyOf(QObject *item) const
+    {
+        return keyProperty().isEmpty() ? QString()
+            : item->property(keyProperty().constData()).toString();
+    }
+
+    QString m_interface;
+    QVector<ItemPointer> m_items;
+    QHash<QString, int> m_rows;
+    QHash<QObject*, QString> m_keys;
+    QHash<QString, QString> m_pathsByKey;
+};
+
+} // namespace
+
+#endif // SYSTEM_SETTINGS_OBJECT_LIST_MODEL_H
@@ -42,11 +42,25 @@ public:
     virtual bool reset() { return false; }
 };
 
+/* Items of plugins implementing this version must be cheap to create: the
+ * shell may create them while laying out the main page. Anything slow,
+ * such as D-Bus calls, belongs in prefetch(), which the shell calls once
+ * the main page is shown, or when the item is first needed. Until the
+ * item calls setReady(true), its entry is shown with the data from its
+ * manifest, and is hidden if it has a dynamic visibility. */
+class PluginInterface3: public PluginInterface2
+{
+public:
+    virtual void prefetch(ItemBase *item) { Q_UNUSED(item); }
+};
+
 } // namespace
 
 Q_DECLARE_INTERFACE(SystemSettings::PluginInterface,
                     "com.ubuntu.SystemSettings.PluginInterface")
 Q_DECLARE_INTERFACE(SystemSettings::PluginInterface2,
                     "com.ubuntu.SystemSettings.PluginInterface/2.0")
+Q_DECLARE_INTERFACE(SystemSettings::PluginInterface3,
+                    "com.ubuntu.SystemSettings.PluginInterface/3.0")
 
 #endif // SYSTEM_SETTINGS_PLUGIN_INTERFACE_H
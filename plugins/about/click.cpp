@@ -18,8 +18,8 @@
 */
 
 #include "click.h"
+#include "clickdatabase.h"
 
-#include <click.h>
 #include <gio/gio.h>
 #include <gio/gdesktopappinfo.h>
 #include <glib.h>
@@ -36,6 +36,18 @@ ClickModel::ClickModel(QObject *parent):
     m_totalClickSize(0)
 {
     m_clickPackages = buildClickList();
+
+    // The database is shared, and re-read when packages are (un)installed.
+    QObject::connect(ClickDatabase::instance(), SIGNAL(changed()),
+                     this, SLOT(refresh()));
+}
+
+void ClickModel::refresh()
+{
+    beginResetModel();
+    m_totalClickSize = 0;
+    m_clickPackages = buildClickList();
+    endResetModel();
 }
 
 /* Look through `hooks' for a desktop or ini file in `directory'
@@ -170,40 +182,7 @@ ClickModel::Click ClickModel::buildClick(QVariantMap manifest)
 
 QList<ClickModel::Click> ClickModel::buildClickList()
 {
-    ClickDB *clickdb;
-    GError *err = nullptr;
-    gchar *clickmanifest = nullptr;
-
-    clickdb = click_db_new();
-    click_db_read(clickdb, nullptr, &err);
-    if (err != nullptr) {
-        g_warning("Unable to read Click database: %s", err->message);
-        g_error_free(err);
-        g_object_unref(clickdb);
-        return QList<ClickModel::Click>();
-    }
-
-    clickmanifest = click_db_get_manifests_as_string(clickdb, FALSE, &err);
-    g_object_unref(clickdb);
-
-    if (err != nullptr) {
-        g_warning("Unable to get the manifests: %s", err->message);
-        g_error_free(err);
-        return QList<ClickModel::Click>();
-    }
-
-    QJsonParseError error;
-
-    QJsonDocument jsond =
-            QJsonDocument::fromJson(clickmanifest, &error);
-    g_free(clickmanifest);
-
-    if (error.error != QJsonParseError::NoError) {
-        qWarning() << error.errorString();
-        return QList<ClickModel::Click>();
-    }
-
-    QJsonArray data(jsond.array());
+    QJsonArray data(ClickDatabase::instance()->manifests());
 
     QJsonArray::ConstIterator begin(data.constBegin());
     QJsonArray::ConstIterator end(data.constEnd());
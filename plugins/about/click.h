@@ -54,6 +54,9 @@ public:
     QHash<int, QByteArray> roleNames() const;
     quint64 getClickSize() const;
 
+private Q_SLOTS:
+    void refresh();
+
 private:
     void populateFromDesktopFile(Click *newClick,
                                  QVariantMap hooks,
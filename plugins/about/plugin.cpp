@@ -29,7 +29,10 @@ static QObject *siSingletonProvider(QQmlEngine *engine, QJSEngine *scriptEngine)
 {
     Q_UNUSED(engine)
     Q_UNUSED(scriptEngine)
-    return new QSystemImage;
+    // Shared with the other panels, so the engine must not delete it.
+    QSystemImage *si = QSystemImage::instance();
+    QQmlEngine::setObjectOwnership(si, QQmlEngine::CppOwnership);
+    return si;
 }
 
 void BackendPlugin::registerTypes(const char *uri)
@@ -74,6 +74,20 @@ ItemPage {
                 right: parent.right
             }
 
+            ProgressBar {
+                objectName: "importProgressBar"
+                anchors {
+                    left: parent.left
+                    right: parent.right
+                    margins: units.gu(2)
+                }
+                height: units.gu(0.5)
+                visible: backgroundPanel.importing
+                minimumValue: 0
+                maximumValue: 1
+                value: backgroundPanel.importProgress
+            }
+
             WallpaperGrid {
                 id: uArtGrid
                 objectName: "UbuntuArtGrid"
@@ -143,7 +157,7 @@ ItemPage {
                     // cancels
                     backgroundPanel.rmFile(target.uri);
                 } else {
-                    backgroundPanel.prepareBackgroundFile(target.uri, true);
+                    backgroundPanel.importBackgroundFile(target.uri, true, false);
                 }
                 trans.state = ContentTransfer.Finalized;
             }
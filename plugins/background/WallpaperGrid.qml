@@ -150,12 +150,19 @@ Column {
                     height: parent.height
                     Image {
                         property bool current: current === modelData
+                        // Wallpaper shown by this tile
+                        property string uri: modelData
                         id: itemImage
                         objectName: "itemImg"
-                        source: modelData
+                        /* Decode a cached, tile-sized thumbnail rather
+                           than the full resolution wallpaper. Encoded, so
+                           that '#', '?' and '%' stay part of the id. */
+                        source: "image://wallpaper-thumbnail/" +
+                                encodeURIComponent(modelData)
                         width: parent.width
                         height: parent.height
-                        sourceSize.width: 512
+                        sourceSize.width: itemWidth
+                        sourceSize.height: itemHeight
                         fillMode: Image.PreserveAspectCrop
                         asynchronous: true
                         smooth: true
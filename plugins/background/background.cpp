@@ -19,18 +19,22 @@
 */
 
 #include "background.h"
+#include "backgroundimport.h"
 
 #include <QDir>
+#include <QGuiApplication>
+#include <QScreen>
 #include <QStandardPaths>
+#include <QtConcurrent>
 #include <QEvent>
 #include <QDBusReply>
-#include <unistd.h>
 #include <QDebug>
 
 #define SYSTEM_BACKGROUND_DIR "/usr/share/backgrounds"
 
 Background::Background(QObject *parent) :
-    QObject(parent)
+    QObject(parent),
+    m_importProgress(1)
 {
     QObject::connect(&m_accountsService,
                      SIGNAL (changed ()),
@@ -38,6 +42,10 @@ Background::Background(QObject *parent) :
                      SLOT (slotChanged()));
     updateUbuntuArt();
     updateCustomBackgrounds();
+
+    QObject::connect(&m_screenFiles, SIGNAL(finished()),
+                     this, SLOT(screenFilesWritten()));
+    writeMissingScreenFiles();
 }
 
 QString Background::getBackgroundFile()
@@ -45,7 +53,8 @@ QString Background::getBackgroundFile()
     QVariant answer = m_accountsService.getUserProperty(
                 "org.freedesktop.Accounts.User",
                 "BackgroundFile");
-    QString filename = answer.toString();
+    // The greeter and shell are pointed at the screen-sized copy, if any.
+    QString filename = BackgroundImport::originalFile(answer.toString());
 
     if (filename.isEmpty() || !QFile::exists(filename))
         return defaultBackgroundFile();
@@ -64,8 +73,9 @@ void Background::setBackgroundFile(const QUrl &backgroundFile)
     QString oldBackgroundFile = m_backgroundFile;
 
     m_backgroundFile = backgroundFile.url();
-    m_accountsService.customSetUserProperty("SetBackgroundFile",
-                                            backgroundFile.path());
+    m_accountsService.customSetUserProperty(
+        "SetBackgroundFile",
+        BackgroundImport::screenFile(backgroundFile.path()));
     Q_EMIT backgroundFileChanged();
 
     // If old background was a system copy that we still have on the system,
@@ -130,16 +140,17 @@ void Background::updateCustomBackgrounds()
     Q_EMIT customBackgroundsChanged();
 }
 
-QUrl Background::prepareBackgroundFile(const QUrl &url, bool shareWithGreeter)
+void Background::importBackgroundFile(const QUrl &url, bool shareWithGreeter,
+                                      bool select)
 {
-    QUrl prepared = url;
+    QString destination;
+    bool moveFile = false;
 
     if (getCustomBackgroundFolder() != getContentHubFolder() &&
         !url.path().startsWith(getCustomBackgroundFolder().path()) &&
         url != QUrl::fromLocalFile(defaultBackgroundFile()))
     {
         QDir backgroundFolder;
-        bool moveFile = false;
         if (url.path().startsWith(getContentHubFolder().path())) {
             backgroundFolder = getCustomBackgroundFolder();
             moveFile = true;
@@ -147,35 +158,181 @@ QUrl Background::prepareBackgroundFile(const QUrl &url, bool shareWithGreeter)
             backgroundFolder = getCopiedSystemBackgroundFolder();
         }
 
-        QUrl newPath = QUrl::fromLocalFile(backgroundFolder.path() + "/" + url.fileName());
+        QString newPath = backgroundFolder.path() + "/" + url.fileName();
 
-        if (QFile(newPath.path()).exists())
+        if (QFile(newPath).exists())
         {
             // The file already exists in the shared greeter data folder...
             // Likely we just pulled the same file from ContentHub again.
             // We don't want to show both versions in the picker grid, so just
             // promote it to greeter location so we still just have one copy.
-            if (QFile(newPath.path()).remove())
+            if (QFile(newPath).remove())
                 shareWithGreeter = true;
         }
 
         // Move file from local ContentHub dump to shared greeter data folder
         if (shareWithGreeter &&
             QDir::root().mkpath(backgroundFolder.path()))
-        {
-            if ((moveFile && QFile::rename(url.path(), newPath.path())) ||
-                (!moveFile && (link(url.path().toUtf8().data(),
-                                     newPath.path().toUtf8().data()) == 0 ||
-                               QFile::copy(url.path(), newPath.path()))))
-            {
-                updateUbuntuArt();
-                updateCustomBackgrounds();
-                prepared = newPath;
+            destination = newPath;
+    }
+
+    // Only backgrounds the greeter can see get a screen-sized copy.
+    QSize screenSize;
+    QScreen *screen = QGuiApplication::primaryScreen();
+    if (screen && (!destination.isEmpty() ||
+                   url.path().startsWith(getCustomBackgroundFolder().path())))
+        screenSize = screen->size() * screen->devicePixelRatio();
+
+    BackgroundImport *import = new BackgroundImport(url, destination, moveFile,
+                                                    screenSize, select, this);
+    QObject::connect(import, SIGNAL(progressChanged(qreal)),
+                     this, SLOT(importProgressed(qreal)));
+    QObject::connect(import, SIGNAL(finished()),
+                     this, SLOT(importFinished()));
+
+    m_imports.append(import);
+    if (m_imports.count() == 1)
+        Q_EMIT importingChanged();
+    m_importProgress = 0;
+    Q_EMIT importProgressChanged();
+
+    import->start();
+}
+
+/* Wallpapers imported before screen-sized copies were made get theirs the
+ * first time the panel is opened; up to date copies are only stat()ed. */
+void Background::writeMissingScreenFiles()
+{
+    QScreen *screen = QGuiApplication::primaryScreen();
+    if (!screen)
+        return;
+
+    QStringList files;
+    QFileInfoList infos;
+    infos << getCustomBackgroundFolder().entryInfoList(QDir::Files | QDir::NoSymLinks);
+    if (getCustomBackgroundFolder() != getContentHubFolder())
+        infos << getCopiedSystemBackgroundFolder().entryInfoList(QDir::Files | QDir::NoSymLinks);
+    Q_FOREACH(const QFileInfo &info, infos)
+        files.append(info.absoluteFilePath());
+    if (files.isEmpty())
+        return;
+
+    m_screenFiles.setFuture(QtConcurrent::run(
+        &BackgroundImport::writeScreenFiles, files,
+        screen->size() * screen->devicePixelRatio()));
+}
+
+void Background::screenFilesWritten()
+{
+    // Point the greeter and shell at the copy of the current wallpaper.
+    const QString current = m_accountsService.getUserProperty(
+                "org.freedesktop.Accounts.User",
+                "BackgroundFile").toString();
+    const QString screenFile = BackgroundImport::screenFile(current);
+    if (!current.isEmpty() && screenFile != current)
+        m_accountsService.customSetUserProperty("SetBackgroundFile",
+                                                screenFile);
+}
+
+bool Background::importing() const
+{
+    return !m_imports.isEmpty();
+}
+
+qreal Background::importProgress() const
+{
+    return m_importProgress;
+}
+
+void Background::importProgressed(qreal progress)
+{
+    // Progress of an earlier import would make the bar jump back and forth.
+    BackgroundImport *import = qobject_cast<BackgroundImport *>(sender());
+    if (!import || m_imports.isEmpty() || import != m_imports.last())
+        return;
+
+    if (qFuzzyCompare(progress, m_importProgress))
+        return;
+
+    m_importProgress = progress;
+    Q_EMIT importProgressChanged();
+}
+
+void Background::importFinished()
+{
+    BackgroundImport *import = qobject_cast<BackgroundImport *>(sender());
+    if (!import)
+        return;
+
+    m_imports.removeOne(import);
+    import->deleteLater();
+
+    QUrl prepared = import->result();
+    if (prepared.isEmpty()) {
+        // Leave the wallpaper where it was.
+        prepared = import->source();
+    } else if (prepared != import->source()) {
+        addImportedBackground(prepared);
+    }
+
+    if (import->select())
+        setBackgroundFile(prepared);
+
+    if (m_imports.isEmpty()) {
+        m_importProgress = 1;
+        Q_EMIT importProgressChanged();
+        Q_EMIT importingChanged();
+    }
+
+    Q_EMIT backgroundFileImported(import->source(), prepared);
+}
+
+void Background::addImportedBackground(const QUrl &url)
+{
+    const QString path = url.path();
+    const QString uri = url.toString();
+
+    if (path.startsWith(getCopiedSystemBackgroundFolder().path() + "/")) {
+        // Prefer copied versions, as updateUbuntuArt() does.
+        for (int i = 0; i < m_ubuntuArt.count(); i++) {
+            if (QUrl(m_ubuntuArt.at(i)).fileName() == url.fileName()) {
+                if (m_ubuntuArt.at(i) != uri) {
+                    m_ubuntuArt[i] = uri;
+                    Q_EMIT ubuntuArtChanged();
+                }
+                return;
             }
         }
     }
 
-    return prepared;
+    if (!m_customBackgrounds.contains(uri)) {
+        m_customBackgrounds.append(uri);
+        Q_EMIT customBackgroundsChanged();
+    }
+}
+
+void Background::removeBackground(const QUrl &url)
+{
+    const QString uri = url.toString();
+
+    if (m_customBackgrounds.removeAll(uri) > 0)
+        Q_EMIT customBackgroundsChanged();
+
+    int i = m_ubuntuArt.indexOf(uri);
+    if (i >= 0) {
+        // Fall back to the system version the copy was made from.
+        QString envDir(qgetenv("SYSTEM_SETTINGS_UBUNTU_ART_DIR"));
+        QDir systemDir(envDir.isEmpty() ?
+                       QString(qgetenv("SNAP") + SYSTEM_BACKGROUND_DIR) :
+                       envDir);
+
+        if (systemDir.exists(url.fileName()))
+            m_ubuntuArt[i] = QUrl::fromLocalFile(
+                systemDir.absoluteFilePath(url.fileName())).toString();
+        else
+            m_ubuntuArt.removeAt(i);
+        Q_EMIT ubuntuArtChanged();
+    }
 }
 
 QDir Background::getCustomBackgroundFolder()
@@ -262,8 +419,8 @@ void Background::rmFile(const QString &file)
     if (filePath.exists())
     {
         if (filePath.remove()) {
-            updateUbuntuArt();
-            updateCustomBackgrounds();
+            QFile::remove(BackgroundImport::screenFilePath(fileUri.path()));
+            removeBackground(fileUri);
         }
     }
 }
@@ -275,4 +432,5 @@ QString Background::defaultBackgroundFile() const
 }
 
 Background::~Background() {
+    m_screenFiles.waitForFinished();
 }
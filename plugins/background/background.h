@@ -22,9 +22,11 @@
 #define BACKGROUND_H
 
 #include "accountsservice.h"
+#include "backgroundimport.h"
 
 #include <QDBusInterface>
 #include <QDir>
+#include <QFutureWatcher>
 #include <QObject>
 #include <QProcess>
 #include <QUrl>
@@ -49,25 +51,45 @@ class Background : public QObject
                 READ defaultBackgroundFile
                 CONSTANT )
 
+    Q_PROPERTY( bool importing
+                READ importing
+                NOTIFY importingChanged )
+
+    Q_PROPERTY( qreal importProgress
+                READ importProgress
+                NOTIFY importProgressChanged )
+
 public:
     explicit Background(QObject *parent = 0);
     ~Background();
     QString backgroundFile();
     void setBackgroundFile(const QUrl &backgroundFile);
-    Q_INVOKABLE QUrl prepareBackgroundFile(const QUrl &url, bool shareWithGreeter);
+    Q_INVOKABLE void importBackgroundFile(const QUrl &url,
+                                          bool shareWithGreeter,
+                                          bool select);
     Q_INVOKABLE bool fileExists(const QString &file);
     Q_INVOKABLE void rmFile(const QString &file);
     QStringList customBackgrounds();
     QStringList ubuntuArt();
     QString defaultBackgroundFile() const;
+    bool importing() const;
+    qreal importProgress() const;
 
 public Q_SLOTS:
     void slotChanged();
 
+private Q_SLOTS:
+    void importProgressed(qreal progress);
+    void importFinished();
+    void screenFilesWritten();
+
 Q_SIGNALS:
     void backgroundFileChanged();
     void customBackgroundsChanged();
     void ubuntuArtChanged();
+    void importingChanged();
+    void importProgressChanged();
+    void backgroundFileImported(const QUrl &source, const QUrl &prepared);
 
 private:
     AccountsService m_accountsService;
@@ -75,11 +97,17 @@ private:
     QStringList m_customBackgrounds;
     void updateCustomBackgrounds();
     void updateUbuntuArt();
+    void addImportedBackground(const QUrl &url);
+    void removeBackground(const QUrl &url);
+    void writeMissingScreenFiles();
     QString m_backgroundFile;
     QString getBackgroundFile();
     QDir getCustomBackgroundFolder();
     QDir getCopiedSystemBackgroundFolder();
     QDir getContentHubFolder();
+    QList<BackgroundImport *> m_imports;
+    qreal m_importProgress;
+    QFutureWatcher<void> m_screenFiles;
 };
 
 #endif // BACKGROUND_H
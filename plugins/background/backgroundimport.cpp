@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2016 Canonical Ltd
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+*/
+
+#include "backgroundimport.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QSaveFile>
+#include <QtConcurrent>
+#include <QDebug>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Screen-sized copies live in a hidden folder next to their original.
+#define SCREEN_FILE_DIR ".screen"
+#define COPY_CHUNK_SIZE (4 * 1024 * 1024)
+
+BackgroundImport::BackgroundImport(const QUrl &source,
+                                   const QString &destination,
+                                   bool move, const QSize &screenSize,
+                                   bool select, QObject *parent) :
+    QObject(parent),
+    m_source(source),
+    m_destination(destination),
+    m_move(move),
+    m_screenSize(screenSize),
+    m_select(select),
+    m_percent(-1)
+{
+    QObject::connect(&m_watcher, SIGNAL(finished()),
+                     this, SIGNAL(finished()));
+}
+
+BackgroundImport::~BackgroundImport()
+{
+    // The worker thread uses this object until it is done.
+    m_watcher.waitForFinished();
+}
+
+void BackgroundImport::start()
+{
+    m_watcher.setFuture(QtConcurrent::run(this, &BackgroundImport::run));
+}
+
+QUrl BackgroundImport::source() const
+{
+    return m_source;
+}
+
+QUrl BackgroundImport::result() const
+{
+    return m_result;
+}
+
+bool BackgroundImport::select() const
+{
+    return m_select;
+}
+
+void BackgroundImport::run()
+{
+    QString file = m_source.path();
+
+    if (!m_destination.isEmpty()) {
+        if (!transfer(file, m_destination))
+            return;
+        file = m_destination;
+    }
+
+    // A missing screen-sized copy only costs the shell some decoding time.
+    if (m_screenSize.isValid())
+        writeScreenFile(file, m_screenSize);
+
+    m_result = QUrl::fromLocalFile(file);
+    setProgress(1, 1);
+}
+
+bool BackgroundImport::transfer(const QString &source,
+                                const QString &destination)
+{
+    const QByteArray from(QFile::encodeName(source));
+    const QByteArray to(QFile::encodeName(destination));
+
+    if (m_move) {
+        if (::rename(from.constData(), to.constData()) == 0)
+            return true;
+        if (errno != EXDEV) {
+            qWarning() << "Can't move" << source << "to" << destination
+                       << strerror(errno);
+            return false;
+        }
+        // Different file systems; copy and drop the original.
+        if (!copy(source, destination))
+            return false;
+        QFile::remove(source);
+        return true;
+    }
+
+    if (::link(from.constData(), to.constData()) == 0)
+        return true;
+
+    return copy(source, destination);
+}
+
+bool BackgroundImport::copy(const QString &source, const QString &destination)
+{
+    QFile in(source);
+    if (!in.open(QIODevice::ReadOnly)) {
+        qWarning() << "Can't read" << source << in.errorString();
+        return false;
+    }
+
+    // Written to a temporary file, so a half-copied wallpaper never shows up.
+    QSaveFile out(destination);
+    if (!out.open(QIODevice::WriteOnly)) {
+        qWarning() << "Can't write" << destination << out.errorString();
+        return false;
+    }
+
+    const qint64 total = in.size();
+    qint64 done = 0;
+
+#ifdef FICLONE
+    // Copy-on-write file systems can share the extents outright.
+    if (::ioctl(out.handle(), FICLONE, in.handle()) == 0) {
+        setProgress(total, total);
+        return out.commit();
+    }
+#endif
+
+#ifdef __NR_copy_file_range
+    // Otherwise let the kernel copy without bouncing through user space.
+    while (done < total) {
+        ssize_t n = ::syscall(__NR_copy_file_range, in.handle(), NULL,
+                              out.handle(), NULL,
+                              (size_t) qMin<qint64>(total - done,
+                                                    COPY_CHUNK_SIZE), 0);
+        if (n <= 0)
+            break;
+        done += n;
+        setProgress(done, total);
+    }
+#endif
+
+    // Older kernels, or files on different file systems.
+    if (done < total) {
+        if (!in.seek(done) || !out.seek(done)) {
+            out.cancelWriting();
+            return false;
+        }
+
+        while (done < total) {
+            QByteArray chunk(in.read(COPY_CHUNK_SIZE));
+            if (chunk.isEmpty() || out.write(chunk) != chunk.size()) {
+                qWarning() << "Can't copy" << source << "to" << destination
+                           << out.errorString();
+                out.cancelWriting();
+                return false;
+            }
+            done += chunk.size();
+            setProgress(done, total);
+        }
+    }
+
+    return out.commit();
+}
+
+bool BackgroundImport::writeScreenFile(const QString &file,
+                                       const QSize &screenSize)
+{
+    QFileInfo info(file);
+    QFileInfo screenInfo(screenFilePath(file));
+
+    if (screenInfo.exists() && screenInfo.lastModified() >= info.lastModified())
+        return true;
+
+    QImageReader reader(file);
+    reader.setAutoTransform(true);
+
+    /* The shell crops the wallpaper to fill the screen in either orientation,
+     * so the short side has to cover the screen's long side. */
+    const int bound = qMax(screenSize.width(), screenSize.height());
+    const QSize size = reader.size();
+
+    if (!size.isValid() || qMin(size.width(), size.height()) <= bound)
+        return false;
+
+    reader.setScaledSize(size.scaled(bound, bound,
+                                     Qt::KeepAspectRatioByExpanding));
+
+    const QByteArray format = reader.format();
+    QImage image = reader.read();
+    if (image.isNull()) {
+        qWarning() << "Can't read" << file << reader.errorString();
+        return false;
+    }
+
+    if (!QDir().mkpath(screenInfo.absolutePath()))
+        return false;
+
+    QSaveFile out(screenInfo.absoluteFilePath());
+    if (!out.open(QIODevice::WriteOnly))
+        return false;
+
+    QImageWriter writer(&out, format);
+    writer.setQuality(90);
+    if (!writer.write(image)) {
+        qWarning() << "Can't write" << screenInfo.absoluteFilePath()
+                   << writer.errorString();
+        out.cancelWriting();
+        return false;
+    }
+
+    return out.commit();
+}
+
+void BackgroundImport::writeScreenFiles(const QStringList &files,
+                                        const QSize &screenSize)
+{
+    Q_FOREACH(const QString &file, files)
+        writeScreenFile(file, screenSize);
+}
+
+void BackgroundImport::setProgress(qint64 done, qint64 total)
+{
+    // Only notify when the visible percentage changes.
+    const int percent = total > 0 ? (int) (done * 100 / total) : 100;
+    if (percent == m_percent)
+        return;
+
+    m_percent = percent;
+    Q_EMIT progressChanged(percent / 100.0);
+}
+
+QString BackgroundImport::screenFilePath(const QString &file)
+{
+    QFileInfo info(file);
+    return info.absolutePath() + "/" SCREEN_FILE_DIR "/" + info.fileName();
+}
+
+QString BackgroundImport::screenFile(const QString &file)
+{
+    QFileInfo info(file);
+    QFileInfo screenInfo(screenFilePath(file));
+
+    if (screenInfo.exists() && screenInfo.lastModified() >= info.lastModified())
+        return screenInfo.absoluteFilePath();
+
+    return file;
+}
+
+QString BackgroundImport::originalFile(const QString &file)
+{
+    QFileInfo info(file);
+    QDir dir(info.absoluteDir());
+
+    if (dir.dirName() != SCREEN_FILE_DIR || !dir.cdUp())
+        return file;
+
+    return dir.absoluteFilePath(info.fileName());
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2016 Canonical Ltd
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef BACKGROUNDIMPORT_H
+#define BACKGROUNDIMPORT_H
+
+#include <QFutureWatcher>
+#include <QObject>
+#include <QSize>
+#include <QString>
+#include <QUrl>
+
+/* Imports a wallpaper into a folder shared with the greeter on a worker
+ * thread. The file is moved, hard linked or cloned (falling back to an
+ * in-kernel copy) and a copy scaled to the screen is written next to it, so
+ * that the shell and greeter don't decode a full-size photo on every wake. */
+class BackgroundImport : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Copies source to destination; an empty destination imports in place.
+    BackgroundImport(const QUrl &source, const QString &destination,
+                     bool move, const QSize &screenSize, bool select,
+                     QObject *parent = 0);
+    ~BackgroundImport();
+
+    void start();
+
+    QUrl source() const;
+    QUrl result() const;
+    bool select() const;
+
+    // The screen-sized copy of file, if one is up to date, else file.
+    static QString screenFile(const QString &file);
+    // The file a screen-sized copy was made from, else file.
+    static QString originalFile(const QString &file);
+    static QString screenFilePath(const QString &file);
+
+    /* Writes the screen-sized copy of file, unless it is up to date or the
+     * file is no larger than the screen. Blocks; call on a worker thread. */
+    static bool writeScreenFile(const QString &file, const QSize &screenSize);
+    // For wallpapers imported before screen-sized copies were made.
+    static void writeScreenFiles(const QStringList &files,
+                                 const QSize &screenSize);
+
+Q_SIGNALS:
+    // Emitted from the worker thread.
+    void progressChanged(qreal progress);
+    void finished();
+
+private:
+    void run();
+    bool transfer(const QString &source, const QString &destination);
+    bool copy(const QString &source, const QString &destination);
+    void setProgress(qint64 done, qint64 total);
+
+    QUrl m_source;
+    QString m_destination;
+    bool m_move;
+    QSize m_screenSize;
+    bool m_select;
+    QUrl m_result;
+    int m_percent;
+    QFutureWatcher<void> m_watcher;
+};
+
+#endif // BACKGROUNDIMPORT_H
@@ -23,7 +23,7 @@
 #include <QtQml>
 #include <QtQml/QQmlContext>
 #include "background.h"
-
+#include "thumbnailer.h"
 
 void BackendPlugin::registerTypes(const char *uri)
 {
@@ -35,4 +35,8 @@ void BackendPlugin::registerTypes(const char *uri)
 void BackendPlugin::initializeEngine(QQmlEngine *engine, const char *uri)
 {
     QQmlExtensionPlugin::initializeEngine(engine, uri);
+
+    // The engine takes ownership of the provider.
+    if (!engine->imageProvider("wallpaper-thumbnail"))
+        engine->addImageProvider("wallpaper-thumbnail", new ThumbnailProvider);
 }
@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2016 Canonical Ltd
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+*/
+
+#include "thumbnailer.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <QUrl>
+#include <QDebug>
+
+QImage Thumbnailer::thumbnail(const QString &file, const QSize &size,
+                              QString *error)
+{
+    QFileInfo info(file);
+    if (!info.exists()) {
+        if (error)
+            *error = QString("No such file: %1").arg(file);
+        return QImage();
+    }
+
+    const QString uri = QString::fromUtf8(
+        QUrl::fromLocalFile(info.absoluteFilePath()).toEncoded());
+    const qint64 mtime = info.lastModified().toTime_t();
+    const int flavour = flavourSize(size);
+    const QString path = thumbnailPath(info.absoluteFilePath(), flavour);
+
+    QImage image = load(path, uri, mtime);
+    if (!image.isNull())
+        return image;
+
+    QImageReader reader(info.absoluteFilePath());
+    reader.setAutoTransform(true);
+
+    /* Let the decoder scale while decoding; for JPEG this skips most of
+     * the work of decoding the full resolution image. */
+    QSize sourceSize = reader.size();
+    bool scaled = sourceSize.isValid()
+        && (sourceSize.width() > flavour || sourceSize.height() > flavour);
+    if (scaled)
+        reader.setScaledSize(sourceSize.scaled(flavour, flavour,
+                                               Qt::KeepAspectRatio));
+
+    image = reader.read();
+    if (image.isNull()) {
+        if (error)
+            *error = reader.errorString();
+        return image;
+    }
+
+    // Images smaller than the flavour are not worth caching.
+    if (scaled)
+        save(image, path, uri, mtime);
+
+    return image;
+}
+
+int Thumbnailer::flavourSize(const QSize &size)
+{
+    const int requested = qMax(size.width(), size.height());
+
+    if (requested <= 128)
+        return 128;
+    else if (requested <= 256)
+        return 256;
+    else if (requested <= 512)
+        return 512;
+    return 1024;
+}
+
+QString Thumbnailer::thumbnailPath(const QString &file, const int flavourSize)
+{
+    QString flavour;
+    switch (flavourSize) {
+    case 128:
+        flavour = "normal";
+        break;
+    case 256:
+        flavour = "large";
+        break;
+    case 512:
+        flavour = "x-large";
+        break;
+    default:
+        flavour = "xx-large";
+        break;
+    }
+
+    const QByteArray uri = QUrl::fromLocalFile(file).toEncoded();
+    const QString hash = QString::fromLatin1(
+        QCryptographicHash::hash(uri, QCryptographicHash::Md5).toHex());
+
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+        + "/thumbnails/" + flavour + "/" + hash + ".png";
+}
+
+QImage Thumbnailer::load(const QString &thumbnailPath, const QString &uri,
+                         const qint64 mtime)
+{
+    QImageReader reader(thumbnailPath, "png");
+    if (!reader.canRead())
+        return QImage();
+
+    // Stale or colliding thumbnails are regenerated.
+    if (reader.text("Thumb::URI") != uri ||
+        reader.text("Thumb::MTime") != QString::number(mtime))
+        return QImage();
+
+    return reader.read();
+}
+
+bool Thumbnailer::save(const QImage &image, const QString &thumbnailPath,
+                       const QString &uri, const qint64 mtime)
+{
+    QFileInfo info(thumbnailPath);
+    if (!QDir().mkpath(info.absolutePath())) {
+        qWarning() << "Can't create thumbnail directory" << info.absolutePath();
+        return false;
+    }
+
+    // QSaveFile writes to a temporary file and renames it, as the spec asks.
+    QSaveFile file(thumbnailPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Can't write thumbnail" << thumbnailPath
+                   << file.errorString();
+        return false;
+    }
+    file.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner);
+
+    QImageWriter writer(&file, "png");
+    writer.setText("Thumb::URI", uri);
+    writer.setText("Thumb::MTime", QString::number(mtime));
+    writer.setText("Software", "ubuntu-system-settings");
+    if (!writer.write(image)) {
+        qWarning() << "Can't write thumbnail" << thumbnailPath
+                   << writer.errorString();
+        file.cancelWriting();
+        return false;
+    }
+
+    return file.commit();
+}
+
+ThumbnailResponse::ThumbnailResponse(const QString &file,
+                                     const QSize &requestedSize) :
+    m_file(file),
+    m_requestedSize(requestedSize),
+    m_cancelled(0)
+{
+    // The engine deletes the response once it has finished.
+    setAutoDelete(false);
+}
+
+QQuickTextureFactory *ThumbnailResponse::textureFactory() const
+{
+    return QQuickTextureFactory::textureFactoryForImage(m_image);
+}
+
+QString ThumbnailResponse::errorString() const
+{
+    return m_error;
+}
+
+void ThumbnailResponse::cancel()
+{
+    m_cancelled.store(1);
+}
+
+void ThumbnailResponse::run()
+{
+    // Tiles scrolled out of view before we got to them.
+    if (!m_cancelled.load())
+        m_image = Thumbnailer::thumbnail(m_file, m_requestedSize, &m_error);
+
+    Q_EMIT finished();
+}
+
+ThumbnailProvider::ThumbnailProvider() :
+    QQuickAsyncImageProvider()
+{
+    m_pool.setMaxThreadCount(qMax(QThread::idealThreadCount(), 2));
+}
+
+ThumbnailProvider::~ThumbnailProvider()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+QQuickImageResponse *ThumbnailProvider::requestImageResponse(
+    const QString &id, const QSize &requestedSize)
+{
+    const QString file = fileFromId(id);
+
+    /* Without a requested size, assume a grid tile rather than decoding the
+     * full image. */
+    QSize size = requestedSize.isValid() ? requestedSize : QSize(512, 512);
+
+    ThumbnailResponse *response = new ThumbnailResponse(file, size);
+    m_pool.start(response);
+    return response;
+}
+
+QString ThumbnailProvider::fileFromId(const QString &id)
+{
+    /* The id is the wallpaper's file URL (or a plain path). The engine
+     * decodes part of it, but leaves '%' encoded, so decoding the rest
+     * can't decode anything twice. */
+    const QString decoded = QUrl::fromPercentEncoding(id.toUtf8());
+    QUrl url(decoded);
+    return url.isLocalFile() ? url.toLocalFile() : decoded;
+}
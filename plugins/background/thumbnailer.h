@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2016 Canonical Ltd
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef THUMBNAILER_H
+#define THUMBNAILER_H
+
+#include <QAtomicInt>
+#include <QImage>
+#include <QQuickAsyncImageProvider>
+#include <QRunnable>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+
+/* Creates and looks up thumbnails following the freedesktop.org
+ * thumbnail specification: thumbnails are PNGs stored under
+ * $XDG_CACHE_HOME/thumbnails/<flavour>/<md5 of the file URI>.png and are
+ * valid as long as their Thumb::MTime matches the source file. */
+class Thumbnailer
+{
+public:
+    // Thumbnail for file fitting at least size, or a null image.
+    static QImage thumbnail(const QString &file, const QSize &size,
+                            QString *error = 0);
+
+    // Size of the spec flavour (128, 256, 512 or 1024) used for size.
+    static int flavourSize(const QSize &size);
+
+    static QString thumbnailPath(const QString &file, const int flavourSize);
+
+private:
+    static QImage load(const QString &thumbnailPath, const QString &uri,
+                       const qint64 mtime);
+    static bool save(const QImage &image, const QString &thumbnailPath,
+                     const QString &uri, const qint64 mtime);
+};
+
+class ThumbnailResponse : public QQuickImageResponse, public QRunnable
+{
+    Q_OBJECT
+public:
+    ThumbnailResponse(const QString &file, const QSize &requestedSize);
+
+    QQuickTextureFactory *textureFactory() const Q_DECL_OVERRIDE;
+    QString errorString() const Q_DECL_OVERRIDE;
+    void cancel() Q_DECL_OVERRIDE;
+    void run() Q_DECL_OVERRIDE;
+
+private:
+    QString m_file;
+    QSize m_requestedSize;
+    QImage m_image;
+    QString m_error;
+    QAtomicInt m_cancelled;
+};
+
+/* Serves wallpaper thumbnails to QML as image://wallpaper-thumbnail/<url>,
+ * generating missing ones on a pool of worker threads. The url is
+ * percent-encoded as a whole, with encodeURIComponent(). */
+class ThumbnailProvider : public QQuickAsyncImageProvider
+{
+public:
+    ThumbnailProvider();
+    ~ThumbnailProvider();
+
+    QQuickImageResponse *requestImageResponse(
+        const QString &id, const QSize &requestedSize) Q_DECL_OVERRIDE;
+
+    // The wallpaper file named by an image id.
+    static QString fileFromId(const QString &id);
+
+private:
+    QThreadPool m_pool;
+};
+
+#endif // THUMBNAILER_H
@@ -19,7 +19,8 @@
  */
 
 function setBackground(uri) {
-    backgroundPanel.backgroundFile = backgroundPanel.prepareBackgroundFile(uri, true);
+    // The panel sets the background once the file has been imported.
+    backgroundPanel.importBackgroundFile(uri, true, true);
 }
 
 function revertBackgroundToDefault () {
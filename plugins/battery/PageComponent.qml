@@ -77,18 +77,27 @@ ItemPage {
     /* Refresh the graph on a minute basis */
     Timer {
         interval: 60000; running: true; repeat: true
-        onTriggered: canvas.requestPaint()
+        onTriggered: {
+            batteryBackend.refreshHistory()
+            canvas.requestPaint()
+        }
     }
 
     Connections {
         target: Qt.application
         onActiveChanged: {
             if (Qt.application.state === Qt.ApplicationActive) {
+                batteryBackend.refreshHistory()
                 canvas.requestPaint()
             }
         }
     }
 
+    Connections {
+        target: batteryBackend
+        onHistoryChanged: canvas.requestPaint()
+    }
+
     Flickable {
         id: scrollWidget
         anchors.fill: parent
@@ -247,9 +256,15 @@ ItemPage {
                     gradient.addColorStop(0, "red");
                     ctx.strokeStyle = gradient
 
-                    /* Get infos from battery0, on a day (60*24*24=86400 seconds), with 150 points on the graph.
+                    /* Get infos from battery0, on a day (60*24*24=86400 seconds), with at most one point per
+                     * horizontal pixel of the graph.
                      * To ensure we get a valid starting point, we query the values up to two days ago */
-                    var chargeDatas = batteryBackend.getHistory(batteryBackend.deviceString, 86400 * 2, 150)
+                    var chargeDatas = batteryBackend.getHistory(batteryBackend.deviceString, 86400 * 2,
+                                                                Math.max(Math.round(width), 3))
+                    if (chargeDatas.length === 0) {
+                        ctx.restore();
+                        return
+                    }
 
                     /* time is the offset in seconds compared to the current time (negative value)
                        we display the charge on a day, which is 86400 seconds, the value is the % */
@@ -21,8 +21,11 @@
 #include "battery.h"
 #include <glib.h>
 #include <libupower-glib/upower.h>
+#include <QDateTime>
 #include <QtCore/QDebug>
 
+#include <SystemSettings/BlockingCall>
+
 Battery::Battery(QObject *parent) :
     QObject(parent),
     m_systemBusConnection (QDBusConnection::systemBus()),
@@ -32,10 +35,16 @@ Battery::Battery(QObject *parent) :
                    m_systemBusConnection),
     m_deviceString("")
 {
-    m_device = up_device_new();
+    connect(&m_history, SIGNAL(changed()), this, SIGNAL(historyChanged()));
+    connect(&m_history, SIGNAL(lastFullChargeChanged()),
+            this, SIGNAL(lastFullChargeChanged()));
 
     buildDeviceString();
-    getLastFullCharge();
+
+    /* Prefetch the history off the GUI thread so it is cached by the time
+     * the chart is painted. */
+    m_history.setObjectPath(m_deviceString);
+    m_history.refresh();
 
     m_powerdRunning = m_powerdIface.isValid();
 }
@@ -50,6 +59,7 @@ void Battery::buildDeviceString() {
     GPtrArray *devices;
     UpDeviceKind kind;
 
+    SystemSettings::BlockingCall blocking("Battery::buildDeviceString");
     client = up_client_new();
 
 #if !UP_CHECK_VERSION(0, 99, 0)
@@ -83,97 +93,53 @@ QString Battery::deviceString() const
 
 int Battery::lastFullCharge() const
 {
-    return m_lastFullCharge;
+    quint32 lastFullCharge = m_history.lastFullCharge();
+    if (lastFullCharge == 0)
+        return 0;
+    return QDateTime::currentDateTimeUtc().toTime_t() - lastFullCharge;
 }
 
-void Battery::getLastFullCharge()
+void Battery::refreshHistory()
 {
-    GPtrArray *values = nullptr;
-    gint32 offset = 0;
-    GTimeVal timeval;
-
-    g_get_current_time(&timeval);
-    offset = timeval.tv_sec;
-    up_device_set_object_path_sync(m_device, m_deviceString.toStdString().c_str(), nullptr, nullptr);
-    values = up_device_get_history_sync(m_device, "charge", 864000, 1000, nullptr, nullptr);
-
-    if (values == nullptr) {
-        qWarning() << "Can't get charge info";
-        return;
-    }
-
-    double maxCapacity = 100.0;
-    g_object_get (m_device, "capacity", &maxCapacity, nullptr);
-
-    for (uint i=0; i < values->len; i++) {
-        auto item = static_cast<UpHistoryItem *>(g_ptr_array_index(values, i));
-
-        /* Getting the next point after full charge, since upower registers only on state changes,
-           typically you get no data while the device is fully charged and plugged and you get a discharging
-           one when you unplugged, that's when the charge stops */
-        if (up_history_item_get_state(item) == UP_DEVICE_STATE_FULLY_CHARGED ||
-                up_history_item_get_value(item) >= maxCapacity) {
-            if (i < values->len-1) {
-                UpHistoryItem *nextItem = (UpHistoryItem *) g_ptr_array_index(values, i+1);
-                m_lastFullCharge = (int)((offset - (gint32) up_history_item_get_time(nextItem)));
-                Q_EMIT(lastFullChargeChanged());
-                g_ptr_array_unref (values);
-                return;
-            }
-        }
-    }
-    g_ptr_array_unref (values);
+    m_history.refresh();
 }
 
-/* TODO: refresh values over time for dynamic update */
+/* Returns the cached history, downsampled to at most resolution points. The
+ * cache is refreshed asynchronously by refreshHistory(), and historyChanged()
+ * is emitted when new samples arrive. */
 QVariantList Battery::getHistory(const QString &deviceString, const int timespan, const int resolution)
 {
     if (deviceString.isNull() || deviceString.isEmpty())
         return QVariantList();
 
-    GPtrArray *values = nullptr;
-    gint32 offset = 0;
-    GTimeVal timeval;
-    QVariantList listValues;
-    QVariantMap listItem;
-    gdouble currentValue = 0;
-
-    g_get_current_time(&timeval);
-    offset = timeval.tv_sec;
-    up_device_set_object_path_sync(m_device, deviceString.toStdString().c_str(), nullptr, nullptr);
-    values = up_device_get_history_sync(m_device, "charge", timespan, resolution, nullptr, nullptr);
+    bool refresh = false;
+    if (timespan > m_history.window()) {
+        // Filled in from further back, asynchronously.
+        m_history.setWindow(timespan);
+        refresh = true;
+    }
 
-    if (values == nullptr) {
-        qWarning() << "Can't get charge info";
-        return QVariantList();
+    if (deviceString != m_history.objectPath()) {
+        m_history.setObjectPath(deviceString);
+        refresh = true;
     }
 
-    for (uint i=values->len-1; i > 0; i--) {
-        auto item = static_cast<UpHistoryItem *>(g_ptr_array_index(values, i));
-
-        if (up_history_item_get_state(item) == UP_DEVICE_STATE_UNKNOWN)
-            continue;
-
-        /* TODO: find better way to filter out suspend/resume buggy values,
-         * we get empty charge report when that happens, in practice batteries don't run flat often,
-         * if charge was over 3% before it's likely a bug so we ignore the value */
-        if (up_history_item_get_state(item) == UP_DEVICE_STATE_EMPTY && currentValue > 3)
-            continue;
-
-        /* Getting the next point after full charge, since upower registers only on state changes,
-           typically you get no data while the device is fully charged and plugged and you get a discharging
-           one when you unplugged, that's when the charge stops */
-        if (up_history_item_get_state(item) == UP_DEVICE_STATE_FULLY_CHARGED ||
-                up_history_item_get_value(item) == 100.0) {
-            if (i > 1) {
-                UpHistoryItem *nextItem = (UpHistoryItem *) g_ptr_array_index(values, i-1);
-                m_lastFullCharge = (int)((offset - (gint32) up_history_item_get_time(nextItem)));
-                Q_EMIT(lastFullChargeChanged());
-            }
-        }
+    if (refresh)
+        m_history.refresh();
+
+    const quint32 offset = QDateTime::currentDateTimeUtc().toTime_t();
+    const quint32 since = offset > (quint32) timespan ? offset - timespan : 0;
+    const QVector<BatteryHistorySample> samples =
+        BatteryHistory::downsample(m_history.samples(since), resolution);
+
+    QVariantList listValues;
+    QVariantMap listItem;
+    gdouble currentValue = 0;
 
-        currentValue = up_history_item_get_value(item);
-        listItem.insert("time",(offset - (gint32) up_history_item_get_time(item)));
+    listValues.reserve(samples.size() + 1);
+    Q_FOREACH(const BatteryHistorySample &sample, samples) {
+        currentValue = sample.value;
+        listItem.insert("time", (qint64) offset - (qint64) sample.time);
         listItem.insert("value", currentValue);
         listValues += listItem;
     }
@@ -185,10 +151,8 @@ QVariantList Battery::getHistory(const QString &deviceString, const int timespan
     listItem.insert("value", currentValue);
     listValues += listItem;
 
-    g_ptr_array_unref (values);
     return listValues;
 }
 
 Battery::~Battery() {
-    g_object_unref(m_device);
 }
@@ -24,7 +24,7 @@
 #include <QDBusInterface>
 #include <QObject>
 
-#include <libupower-glib/upower.h>
+#include "batteryhistory.h"
 
 class Battery : public QObject
 {
@@ -48,21 +48,20 @@ public:
     QString deviceString() const;
     int lastFullCharge() const;
     Q_INVOKABLE QVariantList getHistory(const QString &deviceString, const int timespan, const int resolution);
+    Q_INVOKABLE void refreshHistory();
 
 Q_SIGNALS:
     void lastFullChargeChanged();
+    void historyChanged();
 
 private:
     QDBusConnection m_systemBusConnection;
     QString m_objectPath;
     QDBusInterface m_powerdIface;
     bool m_powerdRunning;
-    UpDevice *m_device;
     QString m_deviceString;
-    int m_lastFullCharge = 0;
+    BatteryHistory m_history;
     void buildDeviceString();
-    void getLastFullCharge();
-    bool updateLastFullCharge(UpHistoryItem *item, int offset);
 };
 
 #endif // BATTERY_H
@@ -0,0 +1,356 @@
+/*
+ * Copyright (C) 2016 Canonical Ltd
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+*/
+
+#include "batteryhistory.h"
+
+#include <glib.h>
+#include <libupower-glib/upower.h>
+
+#include <QDateTime>
+#include <QtConcurrent>
+#include <QtCore/QDebug>
+
+#include <cmath>
+
+namespace
+{
+/* Runs on a worker thread. UpDevice is not shared between threads, so
+ * every query uses its own proxy. */
+BatteryHistoryFetch fetchHistory(const QString &objectPath,
+                                 const int timespan)
+{
+    BatteryHistoryFetch fetch;
+    fetch.objectPath = objectPath;
+    const quint32 now = QDateTime::currentDateTimeUtc().toTime_t();
+    fetch.since = now > quint32(timespan) ? now - timespan : 0;
+
+    UpDevice *device = up_device_new();
+    if (!up_device_set_object_path_sync(device,
+                                        objectPath.toUtf8().constData(),
+                                        nullptr, nullptr)) {
+        qWarning() << "Can't set battery object path" << objectPath;
+        g_object_unref(device);
+        return fetch;
+    }
+
+    /* Resolution is the maximum number of points UPower returns; we ask for
+     * as many as it keeps and do our own downsampling for display. */
+    GPtrArray *values = up_device_get_history_sync(device, "charge", timespan,
+                                                   BatteryHistory::Capacity,
+                                                   nullptr, nullptr);
+    if (values == nullptr) {
+        qWarning() << "Can't get charge info";
+        g_object_unref(device);
+        return fetch;
+    }
+
+    g_object_get(device, "capacity", &fetch.capacity, nullptr);
+
+    // UPower returns the newest sample first.
+    fetch.samples.reserve(values->len);
+    for (int i = values->len - 1; i >= 0; i--) {
+        auto item = static_cast<UpHistoryItem *>(g_ptr_array_index(values, i));
+        if (up_history_item_get_state(item) == UP_DEVICE_STATE_UNKNOWN)
+            continue;
+
+        BatteryHistorySample sample;
+        sample.time = up_history_item_get_time(item);
+        sample.value = up_history_item_get_value(item);
+        sample.state = up_history_item_get_state(item);
+        fetch.samples.append(sample);
+    }
+    fetch.ok = true;
+
+    g_ptr_array_unref(values);
+    g_object_unref(device);
+    return fetch;
+}
+}
+
+BatteryHistory::BatteryHistory(QObject *parent) :
+    QObject(parent),
+    m_ring(Capacity)
+{
+    connect(&m_watcher, SIGNAL(finished()), this, SLOT(onFetchFinished()));
+}
+
+BatteryHistory::~BatteryHistory()
+{
+    // The worker holds no reference to us, but we must not outlive the watcher.
+    m_watcher.waitForFinished();
+}
+
+void BatteryHistory::setObjectPath(const QString &objectPath)
+{
+    if (objectPath == m_objectPath)
+        return;
+
+    m_objectPath = objectPath;
+    clear();
+    Q_EMIT changed();
+}
+
+QString BatteryHistory::objectPath() const
+{
+    return m_objectPath;
+}
+
+void BatteryHistory::setWindow(const int seconds)
+{
+    m_window = seconds;
+}
+
+int BatteryHistory::window() const
+{
+    return m_window;
+}
+
+bool BatteryHistory::isRefreshing() const
+{
+    return m_watcher.isRunning();
+}
+
+void BatteryHistory::refresh()
+{
+    if (m_objectPath.isEmpty())
+        return;
+
+    // Coalesce refreshes requested while a query is in flight.
+    if (m_watcher.isRunning()) {
+        m_refreshPending = true;
+        return;
+    }
+
+    /* The whole span when the window reaches further back than what was
+     * fetched; merge() keeps the samples we have. */
+    const quint32 now = QDateTime::currentDateTimeUtc().toTime_t();
+    int timespan = qMax(m_window, int(FullChargeLookback));
+    const quint32 since = now > quint32(timespan) ? now - timespan : 0;
+    if (m_count > 0 && m_fetchedSince != 0 && since >= m_fetchedSince) {
+        const quint32 newest = at(m_count - 1).time;
+        if (now > newest)
+            timespan = qMin<quint32>(now - newest + 1, timespan);
+        else
+            timespan = 1;
+    }
+
+    m_watcher.setFuture(QtConcurrent::run(fetchHistory, m_objectPath,
+                                          timespan));
+}
+
+void BatteryHistory::onFetchFinished()
+{
+    const BatteryHistoryFetch fetch = m_watcher.result();
+
+    // Discard results for a device we no longer track.
+    if (fetch.ok && fetch.objectPath == m_objectPath)
+        merge(fetch);
+
+    if (m_refreshPending) {
+        m_refreshPending = false;
+        refresh();
+    }
+}
+
+void BatteryHistory::merge(const BatteryHistoryFetch &fetch)
+{
+    m_capacity = fetch.capacity;
+    if (m_fetchedSince == 0 || fetch.since < m_fetchedSince)
+        m_fetchedSince = fetch.since;
+
+    const quint32 oldest = m_count > 0 ? at(0).time : 0;
+    const quint32 newest = m_count > 0 ? at(m_count - 1).time : 0;
+
+    // Samples older than ours go first, so the buffer is rebuilt.
+    QVector<BatteryHistorySample> kept;
+    if (m_count > 0 && !fetch.samples.isEmpty()
+            && fetch.samples.first().time < oldest) {
+        kept = samples();
+        m_head = 0;
+        m_count = 0;
+    }
+
+    bool appended = false;
+    Q_FOREACH(const BatteryHistorySample &sample, fetch.samples) {
+        if (!kept.isEmpty() && sample.time < oldest)
+            appended |= appendFiltered(sample);
+    }
+    Q_FOREACH(const BatteryHistorySample &sample, kept)
+        append(sample);
+    Q_FOREACH(const BatteryHistorySample &sample, fetch.samples) {
+        if (sample.time > newest)
+            appended |= appendFiltered(sample);
+    }
+
+    if (appended) {
+        updateLastFullCharge();
+        Q_EMIT changed();
+    }
+}
+
+bool BatteryHistory::appendFiltered(const BatteryHistorySample &sample)
+{
+    if (m_count > 0 && sample.time <= at(m_count - 1).time)
+        return false;
+
+    /* TODO: find better way to filter out suspend/resume buggy values,
+     * we get empty charge report when that happens, in practice batteries don't run flat often,
+     * if charge was over 3% before it's likely a bug so we ignore the value */
+    if (sample.state == UP_DEVICE_STATE_EMPTY && m_count > 0
+            && at(m_count - 1).value > 3)
+        return false;
+
+    append(sample);
+    return true;
+}
+
+void BatteryHistory::clear()
+{
+    m_head = 0;
+    m_count = 0;
+    m_fetchedSince = 0;
+    if (m_lastFullCharge != 0) {
+        m_lastFullCharge = 0;
+        Q_EMIT lastFullChargeChanged();
+    }
+}
+
+void BatteryHistory::append(const BatteryHistorySample &sample)
+{
+    if (m_count < Capacity) {
+        m_ring[(m_head + m_count) % Capacity] = sample;
+        m_count++;
+    } else {
+        // Full: overwrite the oldest sample.
+        m_ring[m_head] = sample;
+        m_head = (m_head + 1) % Capacity;
+    }
+}
+
+int BatteryHistory::count() const
+{
+    return m_count;
+}
+
+const BatteryHistorySample &BatteryHistory::at(const int i) const
+{
+    return m_ring.at((m_head + i) % Capacity);
+}
+
+QVector<BatteryHistorySample> BatteryHistory::samples(const quint32 since) const
+{
+    QVector<BatteryHistorySample> ret;
+
+    // Samples are ordered, so find the first one in range by bisection.
+    int lo = 0;
+    int hi = m_count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (at(mid).time < since)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    ret.reserve(m_count - lo);
+    for (int i = lo; i < m_count; i++)
+        ret.append(at(i));
+    return ret;
+}
+
+quint32 BatteryHistory::lastFullCharge() const
+{
+    return m_lastFullCharge;
+}
+
+void BatteryHistory::updateLastFullCharge()
+{
+    quint32 lastFullCharge = 0;
+
+    /* Getting the next point after full charge, since upower registers only on state changes,
+       typically you get no data while the device is fully charged and plugged and you get a discharging
+       one when you unplugged, that's when the charge stops */
+    for (int i = m_count - 2; i >= 0; i--) {
+        const BatteryHistorySample &sample = at(i);
+        if (sample.state == UP_DEVICE_STATE_FULLY_CHARGED
+                || sample.value >= m_capacity) {
+            lastFullCharge = at(i + 1).time;
+            break;
+        }
+    }
+
+    if (lastFullCharge != m_lastFullCharge) {
+        m_lastFullCharge = lastFullCharge;
+        Q_EMIT lastFullChargeChanged();
+    }
+}
+
+QVector<BatteryHistorySample> BatteryHistory::downsample(
+    const QVector<BatteryHistorySample> &input, const int threshold)
+{
+    const int size = input.size();
+    if (threshold >= size || threshold < 3)
+        return input;
+
+    QVector<BatteryHistorySample> sampled;
+    sampled.reserve(threshold);
+
+    // Bucket size. Leave room for the first and last points.
+    const double every = double(size - 2) / (threshold - 2);
+
+    int a = 0;
+    sampled.append(input.at(a));
+
+    for (int i = 0; i < threshold - 2; i++) {
+        // Average of the next bucket, the third point of the triangle.
+        int avgStart = int(std::floor((i + 1) * every)) + 1;
+        int avgEnd = qMin(int(std::floor((i + 2) * every)) + 1, size);
+        double avgX = 0;
+        double avgY = 0;
+        for (int j = avgStart; j < avgEnd; j++) {
+            avgX += input.at(j).time;
+            avgY += input.at(j).value;
+        }
+        const int avgLength = qMax(avgEnd - avgStart, 1);
+        avgX /= avgLength;
+        avgY /= avgLength;
+
+        // Pick the point of the current bucket with the largest triangle.
+        const int rangeStart = int(std::floor(i * every)) + 1;
+        const int rangeEnd = int(std::floor((i + 1) * every)) + 1;
+        const double pointAX = input.at(a).time;
+        const double pointAY = input.at(a).value;
+
+        double maxArea = -1;
+        int next = rangeStart;
+        for (int j = rangeStart; j < rangeEnd; j++) {
+            const double area = std::fabs(
+                (pointAX - avgX) * (input.at(j).value - pointAY)
+                - (pointAX - input.at(j).time) * (avgY - pointAY));
+            if (area > maxArea) {
+                maxArea = area;
+                next = j;
+            }
+        }
+
+        sampled.append(input.at(next));
+        a = next;
+    }
+
+    sampled.append(input.at(size - 1));
+    return sampled;
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2016 Canonical Ltd
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef BATTERY_HISTORY_H
+#define BATTERY_HISTORY_H
+
+#include <QFutureWatcher>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+struct BatteryHistorySample
+{
+    quint32 time;   // Seconds since the epoch.
+    float value;    // Charge, in percent.
+    quint8 state;   // UpDeviceState.
+};
+Q_DECLARE_TYPEINFO(BatteryHistorySample, Q_PRIMITIVE_TYPE);
+
+/* Result of one UPower history query, produced on a worker thread. The
+ * samples are in chronological order (oldest first). */
+struct BatteryHistoryFetch
+{
+    bool ok = false;
+    QString objectPath;
+    quint32 since = 0; // Start of the queried span.
+    double capacity = 100.0;
+    QVector<BatteryHistorySample> samples;
+};
+
+/* Keeps a bounded, chronologically ordered ring buffer of charge samples
+ * for one UPower device. The history is fetched off the GUI thread and
+ * subsequent refreshes only ask UPower for the samples that were recorded
+ * since the newest one we already have, unless the window grew past what
+ * was fetched, in which case the older samples are filled in. */
+class BatteryHistory : public QObject
+{
+    Q_OBJECT
+public:
+    explicit BatteryHistory(QObject *parent = 0);
+    ~BatteryHistory();
+
+    // Number of samples kept before the oldest ones are overwritten.
+    static const int Capacity = 4096;
+    // Seconds of history searched for the last full charge.
+    static const int FullChargeLookback = 86400 * 10;
+
+    void setObjectPath(const QString &objectPath);
+    QString objectPath() const;
+
+    // Window of history, in seconds, kept and fetched on first refresh.
+    void setWindow(const int seconds);
+    int window() const;
+
+    void refresh();
+    bool isRefreshing() const;
+    // Adds the samples of a query; called with the result of refresh().
+    void merge(const BatteryHistoryFetch &fetch);
+
+    int count() const;
+    const BatteryHistorySample &at(const int i) const;
+
+    // Samples no older than since (seconds since the epoch), oldest first.
+    QVector<BatteryHistorySample> samples(const quint32 since = 0) const;
+
+    /* Seconds since the epoch of the first sample recorded after the most
+     * recent full charge, or 0 if there was none in the window. */
+    quint32 lastFullCharge() const;
+
+    /* Largest-Triangle-Three-Buckets downsampling: reduces input to at most
+     * threshold points while keeping the visual shape of the series. */
+    static QVector<BatteryHistorySample> downsample(
+        const QVector<BatteryHistorySample> &input, const int threshold);
+
+Q_SIGNALS:
+    void changed();
+    void lastFullChargeChanged();
+
+private Q_SLOTS:
+    void onFetchFinished();
+
+private:
+    void clear();
+    void append(const BatteryHistorySample &sample);
+    bool appendFiltered(const BatteryHistorySample &sample);
+    void updateLastFullCharge();
+
+    QString m_objectPath;
+    int m_window = 86400 * 2;
+    double m_capacity = 100.0;
+    QVector<BatteryHistorySample> m_ring;
+    int m_head = 0; // Index of the oldest sample.
+    int m_count = 0;
+    quint32 m_fetchedSince = 0; // 0 until the first query is merged.
+    quint32 m_lastFullCharge = 0;
+    bool m_refreshPending = false;
+    QFutureWatcher<BatteryHistoryFetch> m_watcher;
+};
+
+#endif // BATTERY_HISTORY_H
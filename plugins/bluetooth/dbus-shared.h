@@ -20,6 +20,8 @@
 #ifndef USS_DBUS_SHARED_H
 #define USS_DBUS_SHARED_H
 
+#include <SystemSettings/DBusStats>
+
 #define DBUS_AGENT_PATH "/com/canonical/SettingsBluetoothAgent"
 #define DBUS_ADAPTER_AGENT_PATH "/com/canonical/SettingsBluetoothAgent/adapteragent"
 #define DBUS_AGENT_CAPABILITY "KeyboardDisplay"
@@ -29,8 +31,9 @@
 #define BLUEZ_ADAPTER_IFACE "org.bluez.Adapter1"
 #define BLUEZ_DEVICE_IFACE "org.bluez.Device1"
 
-#define watchCall(call, func) \
+#define watchCall(call, member, func) \
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(call, this); \
+    SystemSettings::DBusStats::watch(*watcher, "bluetooth", BLUEZ_SERVICE, member); \
     QObject::connect(watcher, &QDBusPendingCallWatcher::finished, func)
 
 #endif // USS_DBUS_SHARED_H
@@ -25,6 +25,8 @@
 #include <QTime>
 #include <QCoreApplication>
 
+#include <SystemSettings/BlockingCall>
+
 #include "dbus-shared.h"
 
 namespace
@@ -34,7 +36,7 @@ namespace
 }
 
 DeviceModel::DeviceModel(QDBusConnection &dbus, QObject *parent):
-    QAbstractListModel(parent),
+    SystemSettings::ObjectListModel<Device>(BLUEZ_DEVICE_IFACE, parent),
     m_dbus(dbus),
     m_bluezManager("org.bluez", "/", m_dbus),
     m_bluezAgentManager("org.bluez", "/org/bluez", m_dbus),
@@ -45,7 +47,19 @@ DeviceModel::DeviceModel(QDBusConnection &dbus, QObject *parent):
     m_discoveryBlockCount(0),
     m_activeDevices(0)
 {
+    addPropertyRole("name", Qt::DisplayRole);
+    addPropertyRole("address", Qt::DisplayRole);
+    addPropertyRole("paired", Qt::DisplayRole);
+    addPropertyRole("iconName", IconRole);
+    addPropertyRole("type", TypeRole);
+    addPropertyRole("strength", StrengthRole);
+    addPropertyRole("connection", ConnectionRole);
+    addPropertyRole("address", AddressRole);
+    addPropertyRole("trusted", TrustedRole);
+    setKeyProperty("address");
+
     if (m_bluezManager.isValid()) {
+        watchManager(&m_bluezManager);
 
         connect(&m_bluezManager, SIGNAL(InterfacesAdded(const QDBusObjectPath&, InterfaceList)),
                 this, SLOT(slotInterfacesAdded(const QDBusObjectPath&, InterfaceList)));
@@ -53,7 +67,7 @@ DeviceModel::DeviceModel(QDBusConnection &dbus, QObject *parent):
         connect(&m_bluezManager, SIGNAL(InterfacesRemoved(const QDBusObjectPath&, const QStringList&)),
                 this, SLOT(slotInterfacesRemoved(const QDBusObjectPath&, const QStringList&)));
 
-        watchCall(m_bluezManager.GetManagedObjects(), [=](QDBusPendingCallWatcher *watcher) {
+        watchCall(m_bluezManager.GetManagedObjects(), "GetManagedObjects", [=](QDBusPendingCallWatcher *watcher) {
             QDBusPendingReply<ManagedObjectList> reply = *watcher;
 
             if (reply.isError()) {
@@ -89,7 +103,7 @@ DeviceModel::DeviceModel(QDBusConnection &dbus, QObject *parent):
         auto call = m_bluezAgentManager.RegisterAgent(QDBusObjectPath(DBUS_ADAPTER_AGENT_PATH),
                                                       DBUS_AGENT_CAPABILITY);
 
-        watchCall(call, [=](QDBusPendingCallWatcher *watcher) {
+        watchCall(call, "RegisterAgent", [=](QDBusPendingCallWatcher *watcher) {
             QDBusPendingReply<void> reply = *watcher;
 
             if (reply.isError()) {
@@ -119,7 +133,7 @@ DeviceModel::~DeviceModel()
 
     if (m_bluezAgentManager.isValid()) {
         auto call = m_bluezAgentManager.UnregisterAgent(QDBusObjectPath(DBUS_ADAPTER_AGENT_PATH));
-        watchCall(call, [=](QDBusPendingCallWatcher *watcher) {
+        watchCall(call, "UnregisterAgent", [=](QDBusPendingCallWatcher *watcher) {
             QDBusPendingReply<void> reply = *watcher;
 
             if (reply.isError()) {
@@ -135,7 +149,7 @@ DeviceModel::~DeviceModel()
 void DeviceModel::setupAsDefaultAgent()
 {
     auto call = m_bluezAgentManager.RequestDefaultAgent(QDBusObjectPath(DBUS_ADAPTER_AGENT_PATH));
-    watchCall(call, [=](QDBusPendingCallWatcher *watcher) {
+    watchCall(call, "RequestDefaultAgent", [=](QDBusPendingCallWatcher *watcher) {
         QDBusPendingReply<void> reply = *watcher;
 
         if (reply.isError()) {
@@ -147,28 +161,12 @@ void DeviceModel::setupAsDefaultAgent()
     });
 }
 
+// New devices are added by ObjectListModel.
 void DeviceModel::slotInterfacesAdded(const QDBusObjectPath &objectPath, InterfaceList ifacesAndProps)
 {
-    Q_UNUSED(ifacesAndProps);
-
-    auto candidatedPath = objectPath.path();
-
-    if (!m_bluezAdapter) {
-        // Maybe we have a new adapter we can start to use?
-        if (ifacesAndProps.contains(BLUEZ_ADAPTER_IFACE))
-            setAdapterFromPath(candidatedPath, ifacesAndProps.value(BLUEZ_ADAPTER_IFACE));
-
-        return;
-    }
-
-    // At this point we can only get new devices
-    if (!candidatedPath.startsWith(m_bluezAdapter->path()))
-        return;
-
-    if (!ifacesAndProps.contains(BLUEZ_DEVICE_IFACE))
-        return;
-
-    addDevice(candidatedPath, ifacesAndProps.value(BLUEZ_DEVICE_IFACE));
+    // Maybe we have a new adapter we can start to use?
+    if (!m_bluezAdapter && ifacesAndProps.contains(BLUEZ_ADAPTER_IFACE))
+        setAdapterFromPath(objectPath.path(), ifacesAndProps.value(BLUEZ_ADAPTER_IFACE));
 }
 
 void DeviceModel::slotInterfacesRemoved(const QDBusObjectPath &objectPath, const QStringList &interfaces)
@@ -181,31 +179,12 @@ void DeviceModel::slotInterfacesRemoved(const QDBusObjectPath &objectPath, const
     if (candidatedPath == m_bluezAdapter->path() &&
         interfaces.contains(BLUEZ_ADAPTER_IFACE)) {
         clearAdapter();
-        return;
     }
-
-    if (!candidatedPath.startsWith(m_bluezAdapter->path()))
-        return;
-
-    if (!interfaces.contains(BLUEZ_DEVICE_IFACE))
-        return;
-
-    auto device = getDeviceFromPath(candidatedPath);
-    if (!device)
-        return;
-
-    const int row = findRowFromAddress(device->getAddress());
-    if ((row >= 0))
-        removeRow(row);
 }
 
-int DeviceModel::findRowFromAddress(const QString &address) const
+bool DeviceModel::acceptsObject(const QString &objectPath) const
 {
-    for (int i=0, n=m_devices.size(); i<n; i++)
-        if (m_devices[i]->getAddress() == address)
-            return i;
-
-    return -1;
+    return m_bluezAdapter && objectPath.startsWith(m_bluezAdapter->path());
 }
 
 void DeviceModel::restartDiscoveryTimer()
@@ -230,7 +209,7 @@ void DeviceModel::stopDiscovery()
 {
     if (m_bluezAdapter && m_isPowered && m_isDiscovering) {
 
-         watchCall(m_bluezAdapter->StopDiscovery(), [=](QDBusPendingCallWatcher *watcher) {
+         watchCall(m_bluezAdapter->StopDiscovery(), "StopDiscovery", [=](QDBusPendingCallWatcher *watcher) {
             QDBusPendingReply<void> reply = *watcher;
             if (reply.isError()) {
                 qWarning() << "Failed to stop device discovery:"
@@ -246,7 +225,7 @@ void DeviceModel::startDiscovery()
 {
     if (m_bluezAdapter && m_isPowered && !m_isDiscovering) {
 
-        watchCall(m_bluezAdapter->StartDiscovery(), [=](QDBusPendingCallWatcher *watcher) {
+        watchCall(m_bluezAdapter->StartDiscovery(), "StartDiscovery", [=](QDBusPendingCallWatcher *watcher) {
             QDBusPendingReply<void> reply = *watcher;
             if (reply.isError()) {
                 qWarning() << "Failed to start device discovery:"
@@ -283,9 +262,7 @@ void DeviceModel::clearAdapter()
         m_bluezAdapterProperties.reset(0);
         m_adapterName.clear();
 
-        beginResetModel();
-        m_devices.clear();
-        endResetModel();
+        clear();
     }
 }
 
@@ -329,7 +306,7 @@ void DeviceModel::slotAdapterPropertiesChanged(const QString &interface, const Q
 
 void DeviceModel::updateDevices()
 {
-    watchCall(m_bluezManager.GetManagedObjects(), [=](QDBusPendingCallWatcher *watcher) {
+    watchCall(m_bluezManager.GetManagedObjects(), "GetManagedObjects", [=](QDBusPendingCallWatcher *watcher) {
         QDBusPendingReply<ManagedObjectList> reply = *watcher;
 
         if (reply.isError()) {
@@ -339,24 +316,9 @@ void DeviceModel::updateDevices()
             return;
         }
 
-        auto objectList = reply.argumentAt<0>();
-
-        for (auto objectPath : objectList.keys()) {
-            auto candidatePath = objectPath.path();
-
-            if (!candidatePath.startsWith(m_bluezAdapter->path()))
-                continue;
-
-            InterfaceList ifaces = objectList.value(objectPath);
-
-            if (!ifaces.contains(BLUEZ_DEVICE_IFACE))
-                continue;
-
-            auto properties = ifaces.value(BLUEZ_DEVICE_IFACE);
-
-            addDevice(candidatePath, properties);
-        }
+        addObjects(reply.argumentAt<0>());
 
+        watcher->deleteLater();
     });
 }
 
@@ -496,7 +458,7 @@ void DeviceModel::slotDeviceConnectionChanged()
         unblockDiscovery();
 }
 
-QSharedPointer<Device> DeviceModel::addDevice(const QString &path, const QVariantMap &properties)
+QSharedPointer<Device> DeviceModel::createItem(const QString &path, const QVariantMap &properties)
 {
     QSharedPointer<Device> device(new Device(path, m_dbus));
     device->setProperties(properties);
@@ -515,6 +477,7 @@ QSharedPointer<Device> DeviceModel::addDevice(const QString &path, const QVarian
     // just a matter of time for the device to become valid and we wait a
     // bit here. This is safe because in any other case the properties are
     // already updated.
+    SystemSettings::BlockingCall blocking("DeviceModel::addDevice");
     uint8_t tries = 0;
     while (!device->isValid() && tries < 10) {
         const QTime timeout = QTime::currentTime().addMSecs(100);
@@ -528,90 +491,29 @@ QSharedPointer<Device> DeviceModel::addDevice(const QString &path, const QVarian
     if (!device->isValid())
         return QSharedPointer<Device>(nullptr);
 
-    QObject::connect(device.data(), SIGNAL(deviceChanged()),
-                     this, SLOT(slotDeviceChanged()));
     QObject::connect(device.data(), SIGNAL(pairingDone(bool)),
                      this, SLOT(slotDevicePairingDone(bool)));
     QObject::connect(device.data(), SIGNAL(connectionChanged()),
                      this, SLOT(slotDeviceConnectionChanged()));
 
-    return addDevice(device);
-}
-
-QSharedPointer<Device> DeviceModel::addDevice(QSharedPointer<Device> &device)
-{
-    int row = findRowFromAddress(device->getAddress());
-
-    if (row >= 0) { // update existing device
-        m_devices[row] = device;
-        emitRowChanged(row);
-    } else { // add new device
-        row = m_devices.size();
-        beginInsertRows(QModelIndex(), row, row);
-        m_devices.append(device);
-        endInsertRows();
-    }
-
     return device;
 }
 
-void DeviceModel::removeRow(int row)
-{
-    if (0<=row && row<m_devices.size()) {
-        beginRemoveRows(QModelIndex(), row, row);
-        m_devices.removeAt(row);
-        endRemoveRows();
-    }
-}
-
-void DeviceModel::emitRowChanged(int row)
-{
-    if (0<=row && row<m_devices.size()) {
-        QModelIndex qmi = index(row, 0);
-        Q_EMIT(dataChanged(qmi, qmi));
-    }
-}
-
-void DeviceModel::slotDeviceChanged()
-{
-    const Device * device = qobject_cast<Device*>(sender());
-
-    // find the row that goes with this device
-    int row = -1;
-    if (device != nullptr)
-        for (int i=0, n=m_devices.size(); row==-1 && i<n; i++)
-            if (m_devices[i].data() == device)
-                row = i;
-
-    if (row != -1)
-        emitRowChanged(row);
-}
-
 QSharedPointer<Device> DeviceModel::getDeviceFromAddress(const QString &address)
 {
-    QSharedPointer<Device> device;
-
-    const int row = findRowFromAddress(address);
-    if (row >= 0)
-        device = m_devices[row];
-
-    return device;
+    return itemFromKey(address);
 }
 
 QSharedPointer<Device> DeviceModel::getDeviceFromPath(const QString &path)
 {
-    for (auto device : m_devices)
-        if (device->getPath() == path)
-            return device;
-
-    return QSharedPointer<Device>();
+    return itemFromPath(path);
 }
 
 QSharedPointer<Device> DeviceModel::addDeviceFromPath(const QDBusObjectPath &path)
 {
     qWarning() << "Creating device object for path" << path.path();
     QVariantMap noProps;
-    return addDevice(path.path(), noProps);
+    return addObject(path.path(), noProps);
 }
 
 void DeviceModel::slotRemoveFinished(QDBusPendingCallWatcher *call)
@@ -638,13 +540,6 @@ void DeviceModel::removeDevice (const QString &path)
                      this, SLOT(slotRemoveFinished(QDBusPendingCallWatcher*)));
 }
 
-int DeviceModel::rowCount(const QModelIndex &parent) const
-{
-    Q_UNUSED(parent);
-
-    return m_devices.size();
-}
-
 QHash<int,QByteArray> DeviceModel::roleNames() const
 {
     static QHash<int,QByteArray> names;
@@ -666,9 +561,7 @@ QVariant DeviceModel::data(const QModelIndex &index, int role) const
 {
     QVariant ret;
 
-    if ((0<=index.row()) && (index.row()<m_devices.size())) {
-
-        auto device = m_devices[index.row()];
+    if (auto device = itemAt(index.row())) {
         QString displayName;
 
         switch (role) {
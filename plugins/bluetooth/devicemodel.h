@@ -33,6 +33,8 @@
 #include <QSharedPointer>
 #include <QSortFilterProxyModel>
 
+#include <SystemSettings/ObjectListModel>
+
 #include "device.h"
 
 #include "freedesktop_objectmanager.h"
@@ -40,7 +42,7 @@
 #include "bluez_adapter1.h"
 #include "bluez_agentmanager1.h"
 
-class DeviceModel: public QAbstractListModel
+class DeviceModel: public SystemSettings::ObjectListModel<Device>
 {
     Q_OBJECT
 
@@ -61,7 +63,6 @@ public:
     };
 
     // implemented virtual methods from QAbstractTableModel
-    int rowCount(const QModelIndex &parent = QModelIndex()) const;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
     QHash<int,QByteArray> roleNames() const;
 
@@ -121,13 +122,10 @@ private:
     void clearAdapter();
     void setAdapterFromPath(const QString &objectPath, const QVariantMap &properties);
 
-    QList<QSharedPointer<Device> > m_devices;
     void updateDevices();
-    QSharedPointer<Device> addDevice(QSharedPointer<Device> &device);
-    QSharedPointer<Device> addDevice(const QString &objectPath, const QVariantMap &properties);
-    void removeRow(int i);
-    int findRowFromAddress(const QString &address) const;
-    void emitRowChanged(int row);
+    QSharedPointer<Device> createItem(const QString &objectPath,
+                                      const QVariantMap &properties);
+    bool acceptsObject(const QString &objectPath) const;
 
     void setDiscovering(bool value);
     void setupAsDefaultAgent();
@@ -141,7 +139,6 @@ private Q_SLOTS:
     void slotPropertyChanged(const QString &key, const QDBusVariant &value);
     void slotDiscoveryTimeout();
     void slotEnableDiscoverable();
-    void slotDeviceChanged();
     void slotDevicePairingDone(bool success);
     void slotDeviceConnectionChanged();
 };
@@ -20,13 +20,16 @@
 #ifndef USS_DBUS_SHARED_H
 #define USS_DBUS_SHARED_H
 
+#include <SystemSettings/DBusStats>
+
 #define AETHERCAST_PATH "/org/aethercast"
 #define AETHERCAST_SERVICE "org.aethercast"
 #define AETHERCAST_DEVICE_IFACE "org.aethercast.Device"
 #define AETHERCAST_MANAGER_IFACE "org.aethercast.Manager"
 
-#define watchCall(call, func) \
+#define watchCall(call, member, func) \
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(call, this); \
+    SystemSettings::DBusStats::watch(*watcher, "brightness", AETHERCAST_SERVICE, member); \
     QObject::connect(watcher, &QDBusPendingCallWatcher::finished, func)
 
 #endif // USS_DBUS_SHARED_H
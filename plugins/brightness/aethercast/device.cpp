@@ -52,7 +52,7 @@ void Device::initDevice(const QString &path, QDBusConnection &bus)
 
     Q_EMIT(pathChanged());
 
-    watchCall(m_aethercastDeviceProperties->GetAll(AETHERCAST_DEVICE_IFACE), [=](QDBusPendingCallWatcher *watcher) {
+    watchCall(m_aethercastDeviceProperties->GetAll(AETHERCAST_DEVICE_IFACE), "GetAll", [=](QDBusPendingCallWatcher *watcher) {
         QDBusPendingReply<QVariantMap> reply = *watcher;
 
         if (reply.isError()) {
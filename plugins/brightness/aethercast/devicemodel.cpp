@@ -32,19 +32,26 @@ namespace
 }
 
 DeviceModel::DeviceModel(QDBusConnection &dbus, QObject *parent):
-    QAbstractListModel(parent),
+    SystemSettings::ObjectListModel<Device>(AETHERCAST_DEVICE_IFACE, parent),
     m_dbus(dbus),
     m_aethercastManager(AETHERCAST_SERVICE, "/org/aethercast", m_dbus)
 {
-    if (m_aethercastManager.isValid()) {
+    addPropertyRole("name", Qt::DisplayRole);
+    addPropertyRole("address", Qt::DisplayRole);
+    addPropertyRole("state", StateRole);
+    addPropertyRole("address", AddressRole);
+    setKeyProperty("address");
 
-        connect(&m_aethercastManager, SIGNAL(InterfacesAdded(const QDBusObjectPath&, InterfaceList)),
-                this, SLOT(slotInterfacesAdded(const QDBusObjectPath&, InterfaceList)));
+    connect(this, SIGNAL(rowsInserted(const QModelIndex&, int, int)),
+            this, SLOT(slotCountChanged()));
+    connect(this, SIGNAL(rowsRemoved(const QModelIndex&, int, int)),
+            this, SLOT(slotCountChanged()));
+    connect(this, SIGNAL(modelReset()), this, SLOT(slotCountChanged()));
 
-        connect(&m_aethercastManager, SIGNAL(InterfacesRemoved(const QDBusObjectPath&, const QStringList&)),
-                this, SLOT(slotInterfacesRemoved(const QDBusObjectPath&, const QStringList&)));
+    if (m_aethercastManager.isValid()) {
+        watchManager(&m_aethercastManager);
 
-        watchCall(m_aethercastManager.GetManagedObjects(), [=](QDBusPendingCallWatcher *watcher) {
+        watchCall(m_aethercastManager.GetManagedObjects(), "GetManagedObjects", [=](QDBusPendingCallWatcher *watcher) {
             QDBusPendingReply<ManagedObjectList> reply = *watcher;
 
             if (reply.isError()) {
@@ -54,13 +61,7 @@ DeviceModel::DeviceModel(QDBusConnection &dbus, QObject *parent):
                 return;
             }
 
-            auto objectList = reply.argumentAt<0>();
-
-            for (QDBusObjectPath path : objectList.keys()) {
-                InterfaceList ifaces = objectList.value(path);
-                addDevice(path.path(), ifaces.value(AETHERCAST_DEVICE_IFACE));
-                break;
-            }
+            addObjects(reply.argumentAt<0>());
 
             watcher->deleteLater();
         });
@@ -72,56 +73,14 @@ DeviceModel::~DeviceModel()
     qWarning() << "Releasing device model ..";
 }
 
-void DeviceModel::slotInterfacesAdded(const QDBusObjectPath &objectPath, InterfaceList ifacesAndProps)
-{
-    Q_UNUSED(ifacesAndProps);
-
-    auto candidatedPath = objectPath.path();
-
-    // At this point we can only get new devices
-    if (!candidatedPath.startsWith(m_aethercastManager.path()))
-        return;
-
-    if (!ifacesAndProps.contains(AETHERCAST_DEVICE_IFACE))
-        return;
-
-    addDevice(candidatedPath, ifacesAndProps.value(AETHERCAST_DEVICE_IFACE));
-}
-
-void DeviceModel::slotInterfacesRemoved(const QDBusObjectPath &objectPath, const QStringList &interfaces)
+bool DeviceModel::acceptsObject(const QString &objectPath) const
 {
-    auto candidatedPath = objectPath.path();
-
-    if (!m_aethercastManager.isValid())
-        return;
-
-    if (candidatedPath == m_aethercastManager.path() &&
-        interfaces.contains(AETHERCAST_MANAGER_IFACE)) {
-        return;
-    }
-
-    if (!candidatedPath.startsWith(m_aethercastManager.path()))
-        return;
-
-    if (!interfaces.contains(AETHERCAST_DEVICE_IFACE))
-        return;
-
-    auto device = getDeviceFromPath(candidatedPath);
-    if (!device)
-        return;
-
-    const int row = findRowFromAddress(device->getAddress());
-    if ((row >= 0))
-        removeRow(row);
+    return objectPath.startsWith(m_aethercastManager.path());
 }
 
-int DeviceModel::findRowFromAddress(const QString &address) const
+void DeviceModel::slotCountChanged()
 {
-    for (int i=0, n=m_devices.size(); i<n; i++)
-        if (m_devices[i]->getAddress() == address)
-            return i;
-
-    return -1;
+    Q_EMIT(countChanged(rowCount()));
 }
 
 void DeviceModel::setProperties(const QMap<QString,QVariant> &properties)
@@ -146,85 +105,21 @@ void DeviceModel::slotPropertyChanged(const QString      &key,
     updateProperty (key, value.variant());
 }
 
-void DeviceModel::addDevice(const QString &path, const QVariantMap &properties)
+QSharedPointer<Device> DeviceModel::createItem(const QString &path, const QVariantMap &properties)
 {
     QSharedPointer<Device> device(new Device(path, m_dbus));
     device->setProperties(properties);
-
-    if (device) {
-        QObject::connect(device.data(), SIGNAL(deviceChanged()),
-                         this, SLOT(slotDeviceChanged()));
-        addDevice(device);
-    }
-}
-
-void DeviceModel::addDevice(QSharedPointer<Device> &device)
-{
-    int row = findRowFromAddress(device->getAddress());
-
-    if (row >= 0) { // update existing device
-        m_devices[row] = device;
-        emitRowChanged(row);
-    } else { // add new device
-        row = m_devices.size();
-        beginInsertRows(QModelIndex(), row, row);
-        m_devices.append(device);
-        endInsertRows();
-    }
-    emit countChanged(rowCount());
-}
-
-void DeviceModel::removeRow(int row)
-{
-    if (0<=row && row<m_devices.size()) {
-        beginRemoveRows(QModelIndex(), row, row);
-        m_devices.removeAt(row);
-        endRemoveRows();
-    }
-    emit countChanged(rowCount());
-}
-
-void DeviceModel::emitRowChanged(int row)
-{
-    if (0<=row && row<m_devices.size()) {
-        QModelIndex qmi = index(row, 0);
-        Q_EMIT(dataChanged(qmi, qmi));
-    }
-}
-
-void DeviceModel::slotDeviceChanged()
-{
-    const Device * device = qobject_cast<Device*>(sender());
-
-    // find the row that goes with this device
-    int row = -1;
-    if (device != nullptr)
-        for (int i=0, n=m_devices.size(); row==-1 && i<n; i++)
-            if (m_devices[i].data() == device)
-                row = i;
-
-    if (row != -1)
-        emitRowChanged(row);
+    return device;
 }
 
 QSharedPointer<Device> DeviceModel::getDeviceFromAddress(const QString &address)
 {
-    QSharedPointer<Device> device;
-
-    const int row = findRowFromAddress(address);
-    if (row >= 0)
-        device = m_devices[row];
-
-    return device;
+    return itemFromKey(address);
 }
 
 QSharedPointer<Device> DeviceModel::getDeviceFromPath(const QString &path)
 {
-    for (auto device : m_devices)
-        if (device->getPath() == path)
-            return device;
-
-    return QSharedPointer<Device>();
+    return itemFromPath(path);
 }
 
 void DeviceModel::slotRemoveFinished(QDBusPendingCallWatcher *call)
@@ -237,13 +132,6 @@ void DeviceModel::slotRemoveFinished(QDBusPendingCallWatcher *call)
     call->deleteLater();
 }
 
-int DeviceModel::rowCount(const QModelIndex &parent) const
-{
-    Q_UNUSED(parent);
-
-    return m_devices.size();
-}
-
 QHash<int,QByteArray> DeviceModel::roleNames() const
 {
     static QHash<int,QByteArray> names;
@@ -261,9 +149,7 @@ QVariant DeviceModel::data(const QModelIndex &index, int role) const
 {
     QVariant ret;
 
-    if ((0<=index.row()) && (index.row()<m_devices.size())) {
-
-        auto device = m_devices[index.row()];
+    if (auto device = itemAt(index.row())) {
         QString displayName;
 
         switch (role) {
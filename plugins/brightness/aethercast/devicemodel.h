@@ -32,6 +32,8 @@
 #include <QSharedPointer>
 #include <QSortFilterProxyModel>
 
+#include <SystemSettings/ObjectListModel>
+
 #include "device.h"
 
 #include "freedesktop_objectmanager.h"
@@ -39,7 +41,7 @@
 #include "aethercast_device.h"
 #include "aethercast_manager.h"
 
-class DeviceModel: public QAbstractListModel
+class DeviceModel: public SystemSettings::ObjectListModel<Device>
 {
     Q_OBJECT
     Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
@@ -58,7 +60,6 @@ public:
     };
 
     // implemented virtual methods from QAbstractTableModel
-    int rowCount(const QModelIndex &parent = QModelIndex()) const;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
     QHash<int,QByteArray> roleNames() const;
 
@@ -75,22 +76,16 @@ private:
     void setProperties(const QMap<QString,QVariant> &properties);
     void updateProperty(const QString &key, const QVariant &value);
 
-    QList<QSharedPointer<Device> > m_devices;
-    void updateDevices();
-    void addDevice(QSharedPointer<Device> &device);
-    void addDevice(const QString &objectPath, const QVariantMap &properties);
-    void removeRow(int i);
-    int findRowFromAddress(const QString &address) const;
-    void emitRowChanged(int row);
+    QSharedPointer<Device> createItem(const QString &objectPath,
+                                      const QVariantMap &properties);
+    bool acceptsObject(const QString &objectPath) const;
 
 private Q_SLOTS:
-    void slotInterfacesAdded(const QDBusObjectPath &objectPath, InterfaceList ifacesAndProps);
-    void slotInterfacesRemoved(const QDBusObjectPath &objectPath, const QStringList &interfaces);
+    void slotCountChanged();
     void slotAdapterPropertiesChanged(const QString &interface, const QVariantMap &changedProperties,
                                       const QStringList &invalidatedProperties);
     void slotRemoveFinished(QDBusPendingCallWatcher *call);
     void slotPropertyChanged(const QString &key, const QDBusVariant &value);
-    void slotDeviceChanged();
 };
 
 class DeviceFilter: public QSortFilterProxyModel
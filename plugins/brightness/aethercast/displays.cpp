@@ -42,7 +42,7 @@ Displays::Displays(const QDBusConnection &dbus, QObject *parent):
                      this, SLOT(slotPropertiesChanged(const QString&, const QVariantMap&, const QStringList&)));
 
 
-    watchCall(m_aethercastProperties->GetAll(AETHERCAST_MANAGER_IFACE), [=](QDBusPendingCallWatcher *watcher) {
+    watchCall(m_aethercastProperties->GetAll(AETHERCAST_MANAGER_IFACE), "GetAll", [=](QDBusPendingCallWatcher *watcher) {
         QDBusPendingReply<QVariantMap> reply = *watcher;
 
         if (reply.isError()) {
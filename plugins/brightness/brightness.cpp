@@ -26,6 +26,9 @@
 #include <QDBusMetaType>
 #include <QDebug>
 
+#include <SystemSettings/BlockingCall>
+#include <SystemSettings/DBusStats>
+
 // Returned data from getBrightnessParams
 struct BrightnessParams {
         int dim; // Dim brightness
@@ -72,6 +75,9 @@ Brightness::Brightness(QObject *parent) :
         return;
     }
 
+    SystemSettings::BlockingCall blocking("Brightness::getBrightnessParams");
+    SystemSettings::DBusStats::Call stats("brightness", m_powerdIface.service(),
+                                          "getBrightnessParams");
     QDBusMessage reply(m_powerdIface.call("getBrightnessParams"));
 
     if (reply.type() != QDBusMessage::ReplyMessage)
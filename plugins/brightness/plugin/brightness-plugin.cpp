@@ -22,7 +22,6 @@
 #include <hybris/properties/properties.h>
 
 #include <QDebug>
-#include <QDBusInterface>
 #include <QStringList>
 #include <SystemSettings/ItemBase>
 
@@ -40,7 +39,6 @@ class BrightnessItem: public ItemBase
 public:
     explicit BrightnessItem(const QVariantMap &staticData, QObject *parent = 0);
     void setDisplayName(const QString &name);
-    void setVisibility(bool visible);
 
 };
 
@@ -48,14 +46,7 @@ public:
 BrightnessItem::BrightnessItem(const QVariantMap &staticData, QObject *parent):
     ItemBase(staticData, parent)
 {
-    QDBusInterface m_powerdIface ("com.canonical.powerd",
-                                  "/com/canonical/powerd",
-                                  "com.canonical.powerd",
-                                  QDBusConnection::systemBus());
-
-    // Hide the plugin if powerd isn't running; it's currently redundant
-    setVisibility(m_powerdIface.isValid());
-
+    // Whether powerd runs is in the manifest's "visible-if".
     char widi[PROP_VALUE_MAX] = "";
     property_get("ubuntu.widi.supported", widi, "0");
     // We want to log this property to help aid debugging
@@ -73,11 +64,6 @@ void BrightnessItem::setDisplayName(const QString &name)
     setName(name);
 }
 
-void BrightnessItem::setVisibility(bool visible)
-{
-    setVisible(visible);
-}
-
 ItemBase *BrightnessPlugin::createItem(const QVariantMap &staticData,
                                  QObject *parent)
 {
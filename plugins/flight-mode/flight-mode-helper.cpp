@@ -26,6 +26,9 @@
 #include <QDBusInterface>
 #include <QDBusReply>
 
+#include <SystemSettings/BlockingCall>
+#include <SystemSettings/DBusStats>
+
 FlightModeHelper::FlightModeHelper(QObject *parent)
     : QObject(parent)
 {
@@ -33,8 +36,11 @@ FlightModeHelper::FlightModeHelper(QObject *parent)
                                               QLatin1String("/org/freedesktop/URfkill"),
                                               QDBusConnection::systemBus(),
                                               this);
+    SystemSettings::BlockingCall blocking("FlightModeHelper::IsFlightMode");
     auto reply = m_urfkill->IsFlightMode();
-    reply.waitForFinished();
+    SystemSettings::DBusStats::waitForFinished(reply, "flight-mode",
+                                               m_urfkill->service(),
+                                               "IsFlightMode");
     if (reply.isError()) {
         qWarning("Failed to get flight-mode status: %s", qPrintable(reply.error().message()));
         m_isFlightMode = false;
@@ -21,7 +21,9 @@
 
 #include "hotspot-plugin.h"
 
-#include <QDBusInterface>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
 #include <QDBusPendingReply>
 #include <QProcessEnvironment>
 #include <QtDBus>
@@ -39,6 +41,10 @@ class HotspotItem: public ItemBase
 public:
     explicit HotspotItem(const QVariantMap &staticData, QObject *parent = 0);
     void setVisibility(bool visible);
+    void checkSupport();
+
+private:
+    void checkModem();
 };
 
 
@@ -57,37 +63,56 @@ HotspotItem::HotspotItem(const QVariantMap &staticData, QObject *parent):
         }
     }
 
-    bool supportedDevice(false);
+    // Not ready until checkSupport() has an answer.
+    setReady(false);
+}
+
+void HotspotItem::checkSupport()
+{
+    if (isReady()) return;
 
     // TODO: Remove check for mako (lp:1434591).
-    QDBusInterface m_SystemServiceIface("com.canonical.SystemImage",
-                                        "/Service",
-                                        "com.canonical.SystemImage",
-                                        QDBusConnection::systemBus());
-    QDBusPendingReply<QMap<QString, QString> > reply = m_SystemServiceIface.call("Information");
-    reply.waitForFinished();
-    if (reply.isValid()) {
-        QMap<QString, QString> result = reply.argumentAt<0>();
-        QString device = result["device_name"];
-        if (device == "mako" || device == "flo") {
-            setVisibility(false);
-            return;
+    QDBusMessage message = QDBusMessage::createMethodCall(
+        "com.canonical.SystemImage", "/Service",
+        "com.canonical.SystemImage", "Information");
+    QDBusPendingCall call = QDBusConnection::systemBus().asyncCall(message);
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(call, this);
+    QObject::connect(watcher, &QDBusPendingCallWatcher::finished,
+                     [this](QDBusPendingCallWatcher *watcher) {
+        QDBusPendingReply<QMap<QString, QString> > reply = *watcher;
+        watcher->deleteLater();
+
+        if (reply.isValid()) {
+            QMap<QString, QString> result = reply.argumentAt<0>();
+            QString device = result["device_name"];
+            if (device == "mako" || device == "flo") {
+                setVisibility(false);
+                setReady(true);
+                return;
+            }
         }
-    }
-
-    QDBusInterface m_NetStatusPropertiesIface(
-            "com.ubuntu.connectivity1",
-            "/com/ubuntu/connectivity1/NetworkingStatus",
-            "org.freedesktop.DBus.Properties",
-            QDBusConnection::sessionBus());
-    QDBusPendingReply<QVariant> modemReply = m_NetStatusPropertiesIface.call(
-        "Get", "com.ubuntu.connectivity1.NetworkingStatus", "ModemAvailable");
-    modemReply.waitForFinished();
-    if (modemReply.isValid()) {
-        supportedDevice = modemReply.argumentAt<0>().toBool();
-    }
+        checkModem();
+    });
+}
 
-    setVisibility(supportedDevice);
+void HotspotItem::checkModem()
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(
+        "com.ubuntu.connectivity1",
+        "/com/ubuntu/connectivity1/NetworkingStatus",
+        "org.freedesktop.DBus.Properties", "Get");
+    message << QString("com.ubuntu.connectivity1.NetworkingStatus")
+            << QString("ModemAvailable");
+    QDBusPendingCall call = QDBusConnection::sessionBus().asyncCall(message);
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(call, this);
+    QObject::connect(watcher, &QDBusPendingCallWatcher::finished,
+                     [this](QDBusPendingCallWatcher *watcher) {
+        QDBusPendingReply<QVariant> reply = *watcher;
+        watcher->deleteLater();
+
+        setVisibility(reply.isValid() && reply.argumentAt<0>().toBool());
+        setReady(true);
+    });
 }
 
 void HotspotItem::setVisibility(bool visible)
@@ -101,4 +126,9 @@ ItemBase *HotspotPlugin::createItem(const QVariantMap &staticData,
     return new HotspotItem(staticData, parent);
 }
 
+void HotspotPlugin::prefetch(ItemBase *item)
+{
+    static_cast<HotspotItem*>(item)->checkSupport();
+}
+
 #include "hotspot-plugin.moc"
@@ -25,15 +25,16 @@
 #include <QObject>
 #include <SystemSettings/PluginInterface>
 
-class HotspotPlugin: public QObject, public SystemSettings::PluginInterface2
+class HotspotPlugin: public QObject, public SystemSettings::PluginInterface3
 {
     Q_OBJECT
-    Q_PLUGIN_METADATA(IID "com.ubuntu.SystemSettings.PluginInterface/2.0")
-    Q_INTERFACES(SystemSettings::PluginInterface2)
+    Q_PLUGIN_METADATA(IID "com.ubuntu.SystemSettings.PluginInterface/3.0")
+    Q_INTERFACES(SystemSettings::PluginInterface2 SystemSettings::PluginInterface3)
 
 public:
     SystemSettings::ItemBase *createItem(const QVariantMap &staticData,
                                          QObject *parent = 0);
+    void prefetch(SystemSettings::ItemBase *item);
 };
 
 #endif // SYSTEM_SETTINGS_HOTSPOT_PLUGIN_H
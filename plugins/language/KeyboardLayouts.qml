@@ -26,8 +26,25 @@ import Ubuntu.SystemSettings.LanguagePlugin 1.0
 
 ItemPage {
     id: root
-    title: i18n.tr("Keyboard layouts")
-    flickable: subsetView
+
+    header: PageHeader {
+        title: i18n.tr("Keyboard layouts")
+        flickable: subsetView
+        trailingActionBar {
+            actions: [
+                Action {
+                    iconName: "select"
+                    text: i18n.tr("Select all")
+                    onTriggered: subsetView.checkAll()
+                },
+                Action {
+                    iconName: "select-none"
+                    text: i18n.tr("Deselect all")
+                    onTriggered: subsetView.uncheckAll()
+                }
+            ]
+        }
+    }
 
     property var plugin
     property bool currentLayoutsDraggable: false
@@ -162,7 +162,7 @@ ItemPage {
                 text: externalKeyboardPresent ? i18n.tr("On-screen keyboard") :
                                                 i18n.tr("Keyboard layouts")
                 value: oskPlugin.keyboardLayoutsModel.subset.length == 1 ?
-                       oskPlugin.keyboardLayoutsModel.superset[oskPlugin.keyboardLayoutsModel.subset[0]][0] :
+                       oskPlugin.keyboardLayoutsModel.display(oskPlugin.keyboardLayoutsModel.subset[0]) :
                        oskPlugin.keyboardLayoutsModel.subset.length
                 onClicked: pageStack.addPageToNextColumn(root, Qt.resolvedUrl("KeyboardLayouts.qml"), {
                     plugin: oskPlugin
@@ -208,7 +208,7 @@ ItemPage {
 
                 text: i18n.tr("Spell checking")
                 value: plugin.spellCheckingModel.subset.length == 1 ?
-                       plugin.spellCheckingModel.superset[plugin.spellCheckingModel.subset[0]][0] :
+                       plugin.spellCheckingModel.display(plugin.spellCheckingModel.subset[0]) :
                        plugin.spellCheckingModel.subset.length
 
                 onClicked: pageStack.addPageToNextColumn(root, spellChecking)
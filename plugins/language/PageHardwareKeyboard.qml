@@ -62,7 +62,7 @@ ItemPage {
             ListItem.SingleValue {
                 text: i18n.tr("Layouts and other sources")
                 value: plugin.keyboardLayoutsModel.subset.length == 1 ?
-                       plugin.keyboardLayoutsModel.superset[plugin.keyboardLayoutsModel.subset[0]][0] :
+                       plugin.keyboardLayoutsModel.display(plugin.keyboardLayoutsModel.subset[0]) :
                        plugin.keyboardLayoutsModel.subset.length
                 progression: true
 
@@ -26,8 +26,24 @@ import Ubuntu.Components.ListItems 1.3 as ListItem
 import Ubuntu.SystemSettings.LanguagePlugin 1.0
 
 ItemPage {
-    title: i18n.tr("Spell checking")
-    flickable: scrollWidget
+    header: PageHeader {
+        title: i18n.tr("Spell checking")
+        flickable: scrollWidget
+        trailingActionBar {
+            actions: [
+                Action {
+                    iconName: "select"
+                    text: i18n.tr("Select all")
+                    onTriggered: scrollWidget.checkAll()
+                },
+                Action {
+                    iconName: "select-none"
+                    text: i18n.tr("Deselect all")
+                    onTriggered: scrollWidget.uncheckAll()
+                }
+            ]
+        }
+    }
 
     UbuntuLanguagePlugin {
         id: plugin
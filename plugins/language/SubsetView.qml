@@ -45,6 +45,15 @@ ListView {
         text: section == "true" ? subsetLabel : supersetLabel
     }
 
+    // Updates every element in one batch rather than one per delegate.
+    function checkAll() {
+        model.setAllChecked(true, 0)
+    }
+
+    function uncheckAll() {
+        model.setAllChecked(false, delay)
+    }
+
     delegate: ListItem.Standard {
         text: model.display
         control: CheckBox {
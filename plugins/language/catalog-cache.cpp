@@ -0,0 +1,161 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catalog-cache.h"
+
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtDebug>
+
+#include <unicode/coll.h>
+#include <unicode/locid.h>
+#include <unicode/unistr.h>
+#include <unicode/uvernum.h>
+
+// Bump when the layout of the cache file changes.
+static const quint32 CATALOG_CACHE_MAGIC = 0x55535343; // "USSC"
+static const quint32 CATALOG_CACHE_VERSION = 1;
+
+CatalogCache::CatalogCache(const QString &name) :
+    m_name(name)
+{
+}
+
+void
+CatalogCache::addKey(const QString &value)
+{
+    m_key += value;
+}
+
+void
+CatalogCache::addDirectoryKey(const QString &path)
+{
+    QFileInfo info(path);
+
+    m_key += info.absoluteFilePath();
+    m_key += info.exists()
+        ? QString::number(info.lastModified().toMSecsSinceEpoch())
+        : QString();
+}
+
+void
+CatalogCache::addIcuKey()
+{
+    m_key += QStringLiteral("icu-" U_ICU_VERSION);
+}
+
+QString
+CatalogCache::fileName() const
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+        + "/ubuntu-system-settings/" + m_name + ".cache";
+}
+
+const QStringList &
+CatalogCache::key() const
+{
+    return m_key;
+}
+
+bool
+CatalogCache::load(QByteArray *payload) const
+{
+    QFile file(fileName());
+
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic;
+    quint32 version;
+    QStringList key;
+    stream >> magic >> version;
+
+    if (magic != CATALOG_CACHE_MAGIC || version != CATALOG_CACHE_VERSION)
+        return false;
+
+    stream >> key;
+
+    if (key != m_key)
+        return false;
+
+    stream >> *payload;
+
+    return stream.status() == QDataStream::Ok;
+}
+
+bool
+CatalogCache::save(const QByteArray &payload) const
+{
+    const QString path(fileName());
+
+    if (!QDir().mkpath(QFileInfo(path).absolutePath())) {
+        qWarning() << "Cannot create cache directory for" << path;
+        return false;
+    }
+
+    // QSaveFile so a concurrent reader never sees a partial cache.
+    QSaveFile file(path);
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write cache" << path << file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << CATALOG_CACHE_MAGIC << CATALOG_CACHE_VERSION << m_key << payload;
+
+    return file.commit();
+}
+
+CollationKeys::CollationKeys(const QString &locale) :
+    m_collator(nullptr)
+{
+    UErrorCode status = U_ZERO_ERROR;
+    m_collator = icu::Collator::createInstance(icu::Locale(qPrintable(locale)), status);
+
+    if (U_FAILURE(status)) {
+        qWarning() << "Cannot create collator for" << locale << u_errorName(status);
+        delete m_collator;
+        m_collator = nullptr;
+    }
+}
+
+CollationKeys::~CollationKeys()
+{
+    delete m_collator;
+}
+
+QByteArray
+CollationKeys::key(const QString &string) const
+{
+    // Fall back to code point order.
+    if (m_collator == nullptr)
+        return string.toUtf8();
+
+    icu::UnicodeString unicodeString(
+        reinterpret_cast<const UChar *>(string.utf16()), string.length());
+    QByteArray key(m_collator->getSortKey(unicodeString, nullptr, 0), '\0');
+    m_collator->getSortKey(unicodeString,
+                           reinterpret_cast<uint8_t *>(key.data()), key.size());
+
+    return key;
+}
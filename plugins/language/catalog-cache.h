@@ -0,0 +1,81 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CATALOG_CACHE_H
+#define CATALOG_CACHE_H
+
+#include <QtCore>
+
+#include <unicode/uversion.h>
+
+U_NAMESPACE_BEGIN
+class Collator;
+U_NAMESPACE_END
+
+/* A single-file, on-disk cache for data that is expensive to compute but
+ * only changes when some set of inputs changes (e.g. the contents of a
+ * directory or the UI locale). The inputs are folded into a key; a cached
+ * payload is only returned if it was stored under the same key. */
+class CatalogCache
+{
+public:
+
+    explicit CatalogCache(const QString &name);
+
+    // Adds an input to the cache key.
+    void addKey(const QString &value);
+
+    // Adds a directory's path and modification time to the cache key.
+    void addDirectoryKey(const QString &path);
+
+    /* Adds the ICU version to the cache key, for payloads holding ICU
+     * display names or collation keys. */
+    void addIcuKey();
+
+    bool load(QByteArray *payload) const;
+    bool save(const QByteArray &payload) const;
+
+    QString fileName() const;
+    const QStringList &key() const;
+
+private:
+
+    QString m_name;
+    QStringList m_key;
+};
+
+/* Computes ICU collation keys for a locale. Comparing two keys bytewise
+ * gives the same order as collating the strings, so lists can be sorted
+ * (and their order persisted) without collating on every comparison. */
+class CollationKeys
+{
+public:
+
+    explicit CollationKeys(const QString &locale);
+    ~CollationKeys();
+
+    QByteArray key(const QString &string) const;
+
+private:
+
+    Q_DISABLE_COPY(CollationKeys)
+
+    icu::Collator *m_collator;
+};
+
+#endif // CATALOG_CACHE_H
@@ -26,6 +26,7 @@
 #include <gio/gio.h>
 
 #include "hardwarekeyboard-plugin.h"
+#include "keyboard-layout-catalog.h"
 
 #define INPUT_SOURCE_TYPE_XKB "xkb"
 #define SOURCES_CONFIG_SCHEMA_ID "org.gnome.desktop.input-sources"
@@ -39,21 +40,13 @@ HardwareKeyboardPlugin::HardwareKeyboardPlugin(QObject *parent) :
     m_sourcesSettings(g_settings_new(SOURCES_CONFIG_SCHEMA_ID))
 {
     qDBusRegisterMetaType<StringMapList>();
-    m_xkbInfo = gnome_xkb_info_new();
 
-    updateKeyboardLayouts();
     updateKeyboardLayoutsModel();
 }
 
 
 HardwareKeyboardPlugin::~HardwareKeyboardPlugin()
 {
-    if (m_xkbInfo != nullptr) {
-        g_object_unref(m_xkbInfo);
-    }
-
-    qDeleteAll(m_keyboardLayouts);
-
     g_object_unref(m_sourcesSettings);
 }
 
@@ -96,8 +89,8 @@ HardwareKeyboardPlugin::keyboardLayoutsModelChanged()
     it.toBack();
     while (it.hasPrevious()) {
         QMap<QString, QString> m = QMap<QString, QString>();
-        KeyboardLayout* layout = m_keyboardLayouts.at(it.previous());
-        m.insert(INPUT_SOURCE_TYPE_XKB, layout->name());
+        const KeyboardLayout &layout(m_keyboardLayoutsModel.layouts().at(it.previous()));
+        m.insert(INPUT_SOURCE_TYPE_XKB, layout.name());
         finalMaps.prepend(m);
     }
 
@@ -114,86 +107,10 @@ HardwareKeyboardPlugin::keyboardLayoutsModelChanged()
     g_settings_set_value(m_sourcesSettings, SOURCES_KEY, g_variant_builder_end(&builder));
 }
 
-static bool
-compareLayouts(const KeyboardLayout *layout0,
-               const KeyboardLayout *layout1)
-{
-    QString name0(layout0->displayName());
-    QString name1(layout1->displayName());
-
-    if (name0 == name1) {
-        name0 = layout0->language();
-        name1 = layout1->language();
-
-        if (name0 == name1) {
-            name0 = layout0->name();
-            name1 = layout1->name();
-        }
-    }
-
-    return QString::localeAwareCompare(name0, name1) < 0;
-}
-
-void
-HardwareKeyboardPlugin::updateKeyboardLayouts()
-{
-    GList *sources, *tmp;
-    gchar *source_id = NULL;
-    const gchar *display_name;
-    const gchar *short_name;
-    const gchar *xkb_layout;
-    const gchar *xkb_variant;
-    sources = gnome_xkb_info_get_all_layouts(m_xkbInfo);
-
-    m_keyboardLayouts.clear();
-
-    for (tmp = sources; tmp != NULL; tmp = tmp->next) {
-        g_free (source_id);
-        source_id = g_strconcat(INPUT_SOURCE_TYPE_XKB, tmp->data, NULL);
-
-        gnome_xkb_info_get_layout_info(m_xkbInfo, (const gchar *)tmp->data,
-        &display_name, &short_name, &xkb_layout, &xkb_variant);
-
-        KeyboardLayout *layout(new KeyboardLayout((const gchar *)tmp->data,
-                                                  short_name,
-                                                  display_name,
-                                                  xkb_variant));
-        if (!layout->language().isEmpty())
-            m_keyboardLayouts += layout;
-        else
-            delete layout;
-
-    }
-    g_free(source_id);
-    g_list_free(sources);
-    qSort(m_keyboardLayouts.begin(), m_keyboardLayouts.end(), compareLayouts);
-}
-
 void
 HardwareKeyboardPlugin::updateKeyboardLayoutsModel()
 {
-    QStringList customRoles;
-    customRoles += "language";
-    customRoles += "icon";
-
-    m_keyboardLayoutsModel.setCustomRoles(customRoles);
-
-    QVariantList superset;
-
-    for (QList<KeyboardLayout *>::const_iterator
-         i(m_keyboardLayouts.begin()); i != m_keyboardLayouts.end(); ++i) {
-        QVariantList element;
-
-        if (!(*i)->displayName().isEmpty())
-            element += (*i)->displayName();
-        else
-            element += (*i)->name();
-
-        element += (*i)->shortName();
-        superset += QVariant(element);
-    }
-
-    m_keyboardLayoutsModel.setSuperset(superset);
+    m_keyboardLayoutsModel.setLayouts(KeyboardLayoutCatalog::hardwareLayouts());
 
     enabledLayoutsChanged();
 
@@ -216,12 +133,10 @@ HardwareKeyboardPlugin::enabledLayoutsChanged()
         StringMapList list = qdbus_cast<StringMapList>(arg);
 
         for (int i = 0; i < list.length(); ++i) {
-            for (int j = 0; j < m_keyboardLayouts.length(); j++) {
-                if (m_keyboardLayouts[j]->name() == list.at(i)[INPUT_SOURCE_TYPE_XKB]) {
-                    subset += j;
-                    break;
-                }
-            }
+            int index(m_keyboardLayoutsModel.indexOf(list.at(i)[INPUT_SOURCE_TYPE_XKB]));
+
+            if (index >= 0)
+                subset += index;
         }
         m_keyboardLayoutsModel.setSubset(subset);
     } else {
@@ -26,19 +26,13 @@
 #include <gio/gio.h>
 #include <QDBusArgument>
 
-#define GNOME_DESKTOP_USE_UNSTABLE_API
-#include <libgnome-desktop/gnome-xkb-info.h>
-
 #include "accountsservice.h"
-#include "subset-model.h"
-#include "keyboard-layout.h"
+#include "keyboard-layouts-model.h"
 
 typedef void *gpointer;
 typedef char gchar;
 typedef struct _GSettings GSettings;
 
-class KeyboardLayout;
-
 class HardwareKeyboardPlugin : public QObject
 {
 private:
@@ -64,12 +58,9 @@ public:
 
 private:
     void updateEnabledLayouts();
-    void updateKeyboardLayouts();
     void updateKeyboardLayoutsModel();
 
-    GnomeXkbInfo *m_xkbInfo;
-    QList<KeyboardLayout *> m_keyboardLayouts;
-    SubsetModel m_keyboardLayoutsModel;
+    KeyboardLayoutsModel m_keyboardLayoutsModel;
     AccountsService m_accountsService;
     GSettings *m_sourcesSettings;
 };
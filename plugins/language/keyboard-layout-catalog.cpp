@@ -0,0 +1,162 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keyboard-layout-catalog.h"
+#include "catalog-cache.h"
+
+#include <algorithm>
+
+#define GNOME_DESKTOP_USE_UNSTABLE_API
+#include <libgnome-desktop/gnome-xkb-info.h>
+
+#define XKB_RULES_DIR "/usr/share/X11/xkb/rules"
+
+QList<KeyboardLayout>
+KeyboardLayoutCatalog::onScreenLayouts(const QStringList &layoutPaths)
+{
+    CatalogCache cache("osk-layout-catalog");
+    cache.addKey(QLocale().name());
+    cache.addIcuKey();
+
+    Q_FOREACH(const QString &path, layoutPaths)
+        cache.addDirectoryKey(path);
+
+    return layouts(cache, buildOnScreenLayouts, layoutPaths);
+}
+
+QList<KeyboardLayout>
+KeyboardLayoutCatalog::hardwareLayouts()
+{
+    // Display names are translated, so they depend on the UI locale too.
+    CatalogCache cache("xkb-layout-catalog");
+    cache.addKey(QLocale().name());
+    cache.addIcuKey();
+    cache.addDirectoryKey(XKB_RULES_DIR);
+
+    return layouts(cache, buildHardwareLayouts, QStringList());
+}
+
+QList<KeyboardLayout>
+KeyboardLayoutCatalog::layouts(const CatalogCache &cache,
+                               BuildFunction build,
+                               const QStringList &layoutPaths)
+{
+    // Shared by every page instance in this process.
+    static QHash<QString, QList<KeyboardLayout>> catalogs;
+
+    const QString catalogKey(cache.fileName() + '\n' + cache.key().join('\n'));
+    QHash<QString, QList<KeyboardLayout>>::const_iterator i(catalogs.constFind(catalogKey));
+
+    if (i != catalogs.constEnd())
+        return i.value();
+
+    QList<KeyboardLayout> layouts;
+    QByteArray payload;
+
+    if (cache.load(&payload)) {
+        QDataStream stream(payload);
+        stream >> layouts;
+
+        if (stream.status() != QDataStream::Ok)
+            layouts.clear();
+    }
+
+    if (layouts.isEmpty()) {
+        layouts = build(layoutPaths);
+
+        QDataStream stream(&payload, QIODevice::WriteOnly);
+        stream << layouts;
+        cache.save(payload);
+    }
+
+    catalogs.insert(catalogKey, layouts);
+
+    return layouts;
+}
+
+QList<KeyboardLayout>
+KeyboardLayoutCatalog::buildOnScreenLayouts(const QStringList &layoutPaths)
+{
+    QList<KeyboardLayout> layouts;
+
+    for (int i = 0; i < layoutPaths.count(); i++) {
+        QDir layoutsDir(layoutPaths.at(i));
+        layoutsDir.setFilter(QDir::Dirs);
+        layoutsDir.setSorting(QDir::Name);
+
+        QFileInfoList fileInfoList(layoutsDir.entryInfoList());
+
+        for (QFileInfoList::const_iterator
+             i(fileInfoList.begin()); i != fileInfoList.end(); ++i) {
+            KeyboardLayout layout(*i);
+
+            if (!layout.language().isEmpty())
+                layouts += layout;
+        }
+    }
+
+    sort(layouts);
+
+    return layouts;
+}
+
+QList<KeyboardLayout>
+KeyboardLayoutCatalog::buildHardwareLayouts(const QStringList &layoutPaths)
+{
+    Q_UNUSED(layoutPaths);
+
+    GnomeXkbInfo *xkbInfo(gnome_xkb_info_new());
+    GList *sources, *tmp;
+    const gchar *display_name;
+    const gchar *short_name;
+    const gchar *xkb_layout;
+    const gchar *xkb_variant;
+    QList<KeyboardLayout> layouts;
+
+    sources = gnome_xkb_info_get_all_layouts(xkbInfo);
+
+    for (tmp = sources; tmp != NULL; tmp = tmp->next) {
+        gnome_xkb_info_get_layout_info(xkbInfo, (const gchar *)tmp->data,
+        &display_name, &short_name, &xkb_layout, &xkb_variant);
+
+        KeyboardLayout layout((const gchar *)tmp->data,
+                              short_name,
+                              display_name,
+                              xkb_variant);
+        if (!layout.language().isEmpty())
+            layouts += layout;
+    }
+
+    g_list_free(sources);
+    g_object_unref(xkbInfo);
+
+    sort(layouts);
+
+    return layouts;
+}
+
+void
+KeyboardLayoutCatalog::sort(QList<KeyboardLayout> &layouts)
+{
+    CollationKeys collationKeys(QLocale().name());
+
+    for (QList<KeyboardLayout>::iterator i(layouts.begin()); i != layouts.end(); ++i)
+        i->setSortKey(collationKeys.key(i->displayName()));
+
+    std::sort(layouts.begin(), layouts.end());
+}
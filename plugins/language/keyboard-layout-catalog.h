@@ -0,0 +1,55 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEYBOARD_LAYOUT_CATALOG_H
+#define KEYBOARD_LAYOUT_CATALOG_H
+
+#include <QtCore>
+#include "keyboard-layout.h"
+
+class CatalogCache;
+
+/* Sorted keyboard layouts for the on-screen and hardware keyboards.
+ * Computing a layout's display name and collation key is expensive, so the
+ * lists are computed once per UI locale, kept for the lifetime of the
+ * process and persisted with CatalogCache. */
+class KeyboardLayoutCatalog
+{
+public:
+
+    // Layouts found as subdirectories of the given maliit layout paths.
+    static QList<KeyboardLayout> onScreenLayouts(const QStringList &layoutPaths);
+
+    // XKB layouts known to libgnome-desktop.
+    static QList<KeyboardLayout> hardwareLayouts();
+
+private:
+
+    typedef QList<KeyboardLayout> (*BuildFunction)(const QStringList &layoutPaths);
+
+    static QList<KeyboardLayout> layouts(const CatalogCache &cache,
+                                         BuildFunction build,
+                                         const QStringList &layoutPaths);
+
+    static QList<KeyboardLayout> buildOnScreenLayouts(const QStringList &layoutPaths);
+    static QList<KeyboardLayout> buildHardwareLayouts(const QStringList &layoutPaths);
+
+    static void sort(QList<KeyboardLayout> &layouts);
+};
+
+#endif // KEYBOARD_LAYOUT_CATALOG_H
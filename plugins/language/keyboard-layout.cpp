@@ -25,21 +25,18 @@
 KeyboardLayout::KeyboardLayout(const QString &name,
                                const QString &language,
                                const QString &displayName,
-                               const QString &shortName,
-                               QObject       *parent) :
-    QObject(parent),
+                               const QString &shortName) :
     m_name(name),
     m_language(language),
     m_displayName(displayName),
     m_shortName(language)
 {
     Q_UNUSED(shortName);
-    m_shortName[0] = m_shortName[0].toUpper();
+    if (!m_shortName.isEmpty())
+        m_shortName[0] = m_shortName[0].toUpper();
 }
 
-KeyboardLayout::KeyboardLayout(const QFileInfo &fileInfo,
-                               QObject         *parent) :
-    QObject(parent),
+KeyboardLayout::KeyboardLayout(const QFileInfo &fileInfo) :
     m_name(fileInfo.fileName())
 {
     icu::Locale locale(qPrintable(m_name));
@@ -52,7 +49,8 @@ KeyboardLayout::KeyboardLayout(const QFileInfo &fileInfo,
     m_language = locale.getLanguage();
     m_displayName = string.c_str();
     m_shortName = m_language.left(2);
-    m_shortName[0] = m_shortName[0].toUpper();
+    if (!m_shortName.isEmpty())
+        m_shortName[0] = m_shortName[0].toUpper();
 }
 
 const QString &
@@ -78,3 +76,41 @@ KeyboardLayout::shortName() const
 {
     return m_shortName;
 }
+
+const QByteArray &
+KeyboardLayout::sortKey() const
+{
+    return m_sortKey;
+}
+
+void
+KeyboardLayout::setSortKey(const QByteArray &sortKey)
+{
+    m_sortKey = sortKey;
+}
+
+bool
+KeyboardLayout::operator<(const KeyboardLayout &layout) const
+{
+    if (m_sortKey != layout.m_sortKey)
+        return m_sortKey < layout.m_sortKey;
+
+    if (m_language != layout.m_language)
+        return m_language < layout.m_language;
+
+    return m_name < layout.m_name;
+}
+
+QDataStream &
+operator<<(QDataStream &stream, const KeyboardLayout &layout)
+{
+    return stream << layout.m_name << layout.m_language << layout.m_displayName
+                  << layout.m_shortName << layout.m_sortKey;
+}
+
+QDataStream &
+operator>>(QDataStream &stream, KeyboardLayout &layout)
+{
+    return stream >> layout.m_name >> layout.m_language >> layout.m_displayName
+                  >> layout.m_shortName >> layout.m_sortKey;
+}
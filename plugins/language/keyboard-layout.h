@@ -23,46 +23,41 @@
 
 #include <QtCore>
 
-class KeyboardLayout : public QObject
+class KeyboardLayout
 {
-private:
-
-    Q_OBJECT
-
-    Q_PROPERTY(QString name
-               READ name
-               CONSTANT)
-
-    Q_PROPERTY(QString language
-               READ language
-               CONSTANT)
-
-    Q_PROPERTY(QString displayName
-               READ displayName
-               CONSTANT)
-
 public:
 
     explicit KeyboardLayout(const QString &name        = QString(),
                             const QString &language    = QString(),
                             const QString &displayName = QString(),
-                            const QString &shortName   = QString(),
-                            QObject       *parent      = nullptr);
+                            const QString &shortName   = QString());
 
-    explicit KeyboardLayout(const QFileInfo &fileInfo,
-                            QObject         *parent   = nullptr);
+    explicit KeyboardLayout(const QFileInfo &fileInfo);
 
     const QString &name() const;
     const QString &language() const;
     const QString &displayName() const;
     const QString &shortName() const;
 
+    // ICU collation key of the display name, see KeyboardLayoutCatalog.
+    const QByteArray &sortKey() const;
+    void setSortKey(const QByteArray &sortKey);
+
+    bool operator<(const KeyboardLayout &layout) const;
+
 private:
 
     QString m_name;
     QString m_language;
     QString m_displayName;
     QString m_shortName;
+    QByteArray m_sortKey;
+
+    friend QDataStream &operator<<(QDataStream &stream, const KeyboardLayout &layout);
+    friend QDataStream &operator>>(QDataStream &stream, KeyboardLayout &layout);
 };
 
+QDataStream &operator<<(QDataStream &stream, const KeyboardLayout &layout);
+QDataStream &operator>>(QDataStream &stream, KeyboardLayout &layout);
+
 #endif // KEYBOARD_LAYOUT_H
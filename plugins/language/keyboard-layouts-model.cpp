@@ -0,0 +1,98 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keyboard-layouts-model.h"
+
+#define LANGUAGE_COLUMN 0
+#define ICON_COLUMN     1
+
+KeyboardLayoutsModel::KeyboardLayoutsModel(QObject *parent) :
+    SubsetModel(parent)
+{
+    QStringList customRoles;
+    customRoles += "language";
+    customRoles += "icon";
+
+    setCustomRoles(customRoles);
+}
+
+const QList<KeyboardLayout> &
+KeyboardLayoutsModel::layouts() const
+{
+    return m_layouts;
+}
+
+void
+KeyboardLayoutsModel::setLayouts(const QList<KeyboardLayout> &layouts)
+{
+    m_layouts = layouts;
+    m_indicesByName.clear();
+    m_supersetCache.clear();
+
+    for (int i(0); i < m_layouts.length(); i++)
+        m_indicesByName.insert(m_layouts[i].name(), i);
+
+    resetSuperset(m_layouts.length());
+
+    Q_EMIT supersetChanged();
+}
+
+int
+KeyboardLayoutsModel::indexOf(const QString &name) const
+{
+    return m_indicesByName.value(name, -1);
+}
+
+const QVariantList &
+KeyboardLayoutsModel::superset() const
+{
+    if (m_supersetCache.isEmpty() && !m_layouts.isEmpty()) {
+        m_supersetCache.reserve(m_layouts.length());
+
+        for (int i(0); i < m_layouts.length(); i++) {
+            QVariantList element;
+            element += elementData(i, LANGUAGE_COLUMN);
+            element += elementData(i, ICON_COLUMN);
+            m_supersetCache += QVariant(element);
+        }
+    }
+
+    return m_supersetCache;
+}
+
+int
+KeyboardLayoutsModel::supersetSize() const
+{
+    return m_layouts.length();
+}
+
+QVariant
+KeyboardLayoutsModel::elementData(int element, int column) const
+{
+    const KeyboardLayout &layout(m_layouts[element]);
+
+    switch (column) {
+    case LANGUAGE_COLUMN:
+        return !layout.displayName().isEmpty() ? layout.displayName() : layout.name();
+
+    case ICON_COLUMN:
+        return layout.shortName();
+    }
+
+    return QVariant();
+}
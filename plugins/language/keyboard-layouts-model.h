@@ -0,0 +1,58 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEYBOARD_LAYOUTS_MODEL_H
+#define KEYBOARD_LAYOUTS_MODEL_H
+
+#include "subset-model.h"
+#include "keyboard-layout.h"
+
+/* A SubsetModel whose elements are KeyboardLayouts. The "language" and
+ * "icon" roles are read straight from the layouts; the QVariantList
+ * superset is only built if something asks for it. */
+class KeyboardLayoutsModel : public SubsetModel
+{
+private:
+
+    Q_OBJECT
+
+public:
+
+    explicit KeyboardLayoutsModel(QObject *parent = nullptr);
+
+    const QList<KeyboardLayout> &layouts() const;
+    void setLayouts(const QList<KeyboardLayout> &layouts);
+
+    // Index of the layout with the given name, or -1.
+    int indexOf(const QString &name) const;
+
+    virtual const QVariantList &superset() const;
+
+protected:
+
+    virtual int supersetSize() const;
+    virtual QVariant elementData(int element, int column) const;
+
+private:
+
+    QList<KeyboardLayout> m_layouts;
+    QHash<QString, int> m_indicesByName;
+    mutable QVariantList m_supersetCache;
+};
+
+#endif // KEYBOARD_LAYOUTS_MODEL_H
@@ -0,0 +1,154 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "language-catalog.h"
+#include "catalog-cache.h"
+
+#include <QtDebug>
+
+#include <algorithm>
+
+#include <unicode/locid.h>
+#include <unicode/unistr.h>
+
+bool
+LanguageCatalogEntry::operator<(const LanguageCatalogEntry &e) const
+{
+    // Likely locales should precede unlikely ones of the same language.
+    if (QString::compare(language, e.language, Qt::CaseInsensitive) == 0) {
+        if (likely || e.likely)
+            return likely && !e.likely;
+    }
+
+    return sortKey < e.sortKey;
+}
+
+QDataStream &
+operator<<(QDataStream &stream, const LanguageCatalogEntry &entry)
+{
+    return stream << entry.localeName << entry.displayName << entry.language
+                  << entry.likely << entry.sortKey;
+}
+
+QDataStream &
+operator>>(QDataStream &stream, LanguageCatalogEntry &entry)
+{
+    return stream >> entry.localeName >> entry.displayName >> entry.language
+                  >> entry.likely >> entry.sortKey;
+}
+
+QString
+LanguageCatalog::langpackRoot()
+{
+    return QString::fromLocal8Bit(qgetenv("SNAP") + "/usr/share/locale-langpack");
+}
+
+QList<LanguageCatalogEntry>
+LanguageCatalog::languages()
+{
+    QList<LanguageCatalogEntry> entries;
+    QDir langpackDir(langpackRoot());
+
+    if (!langpackDir.exists()) {
+        qWarning() << "Cannot find any language packs, bailing out";
+        return entries;
+    }
+
+    const QString uiLocale(QLocale().name());
+
+    CatalogCache cache("language-catalog");
+    cache.addDirectoryKey(langpackDir.absolutePath());
+    cache.addKey(uiLocale);
+    cache.addIcuKey();
+
+    QByteArray payload;
+
+    if (cache.load(&payload)) {
+        QDataStream stream(payload);
+        stream >> entries;
+
+        if (stream.status() == QDataStream::Ok)
+            return entries;
+
+        entries.clear();
+    }
+
+    entries = build(langpackDir, uiLocale);
+
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream << entries;
+    cache.save(payload);
+
+    return entries;
+}
+
+QList<LanguageCatalogEntry>
+LanguageCatalog::build(const QDir &langpackDir, const QString &uiLocale)
+{
+    const QStringList langpackNames = langpackDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::Readable);
+
+    QStringList tmpLocales;
+    Q_FOREACH(const QString &langpack, langpackNames) {
+        QLocale tmpLoc(langpack == "pt" ? "pt_PT" : langpack); // "pt" work around for https://bugreports.qt.io/browse/QTBUG-47891
+        tmpLocales.append(tmpLoc.name() + QStringLiteral(".UTF-8"));
+    }
+
+    CollationKeys collationKeys(uiLocale);
+    QSet<QString> localeNames = tmpLocales.toSet();
+    QList<LanguageCatalogEntry> entries;
+
+    Q_FOREACH(const QString &loc, localeNames) {
+        icu::Locale locale(qPrintable(loc));
+        icu::UnicodeString unicodeString;
+        std::string string;
+
+        locale.getDisplayName(locale, unicodeString);
+        unicodeString.toUTF8String(string);
+
+        LanguageCatalogEntry entry;
+        entry.localeName = loc;
+        entry.displayName = QString::fromStdString(string);
+        entry.language = locale.getLanguage();
+
+        // Filter out locales for which we have no display name.
+        if (entry.displayName.isEmpty())
+            continue;
+
+        /* workaround iso-codes casing being inconsistant */
+        entry.displayName[0] = entry.displayName[0].toUpper();
+
+        // Ignore "C"
+        // https://github.com/ubports/ubports-touch/issues/182
+        if (entry.displayName == "C")
+            continue;
+
+        QLocale tmpLoc(entry.language);
+        entry.likely = tmpLoc.name() == loc.left(loc.indexOf('.')) || // likely if: en_US -> en -> en_US, NOT likely if: en_GB -> en -> en_US
+                (loc.startsWith("pt_PT") && !loc.startsWith("pt_BR")); // "pt" work around for https://bugreports.qt.io/browse/QTBUG-47891
+
+        /* Compute the collation key once per entry instead of collating
+         * the display names again on every comparison. */
+        entry.sortKey = collationKeys.key(entry.displayName);
+
+        entries += entry;
+    }
+
+    std::sort(entries.begin(), entries.end());
+
+    return entries;
+}
@@ -0,0 +1,61 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LANGUAGE_CATALOG_H
+#define LANGUAGE_CATALOG_H
+
+#include <QtCore>
+
+struct LanguageCatalogEntry
+{
+    QString localeName;
+    QString displayName;
+    QString language;
+
+    // Should be true if locale is the default for its language.
+    // e.g. 'en_US' is the likely locale for 'en', 'en_CA' is not.
+    bool likely;
+
+    // ICU collation key of displayName in the UI locale.
+    QByteArray sortKey;
+
+    bool operator<(const LanguageCatalogEntry &e) const;
+};
+
+QDataStream &operator<<(QDataStream &stream, const LanguageCatalogEntry &entry);
+QDataStream &operator>>(QDataStream &stream, LanguageCatalogEntry &entry);
+
+/* The sorted list of languages for which a langpack is installed. Building
+ * it requires an ICU locale and display name per langpack and a collated
+ * sort, so the result is cached on disk, keyed by the langpack directory,
+ * the UI locale and the ICU version. */
+class LanguageCatalog
+{
+public:
+
+    static QList<LanguageCatalogEntry> languages();
+
+    static QString langpackRoot();
+
+private:
+
+    static QList<LanguageCatalogEntry> build(const QDir &langpackDir,
+                                             const QString &uiLocale);
+};
+
+#endif // LANGUAGE_CATALOG_H
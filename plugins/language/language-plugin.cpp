@@ -20,56 +20,9 @@
 #include <QStandardPaths>
 #include <QtDebug>
 #include "language-plugin.h"
-#include "keyboard-layout.h"
+#include "language-catalog.h"
 
 #include <act/act.h>
-#include <unicode/locid.h>
-#include <unicode/unistr.h>
-
-struct LanguageLocale
-{
-public:
-
-    // Should be true if locale is the default for its language.
-    // e.g. 'en_US' is the likely locale for 'en', 'en_CA' is not.
-    bool likely;
-
-    QString localeName;
-    QString displayName;
-    icu::Locale locale;
-
-public:
-
-    explicit LanguageLocale(const QString &name);
-
-    bool operator<(const LanguageLocale &l) const;
-};
-
-LanguageLocale::LanguageLocale(const QString &name) :
-    likely(false),
-    localeName(name),
-    locale(qPrintable(name))
-{
-    std::string string;
-    icu::UnicodeString unicodeString;
-    locale.getDisplayName(locale, unicodeString);
-    unicodeString.toUTF8String(string);
-    displayName = string.c_str();
-    /* workaround iso-codes casing being inconsistant */
-    if (displayName.length() > 0)
-        displayName[0] = displayName[0].toUpper();
-}
-
-bool LanguageLocale::operator<(const LanguageLocale &l) const
-{
-    // Likely locales should precede unlikely ones of the same language.
-    if (strcasecmp(locale.getLanguage(), l.locale.getLanguage()) == 0) {
-        if (likely || l.likely)
-            return likely && !l.likely;
-    }
-
-    return QString::localeAwareCompare(displayName, l.displayName) < 0;
-}
 
 void managerLoaded(GObject    *object,
                    GParamSpec *pspec,
@@ -160,48 +113,10 @@ LanguagePlugin::updateLanguageNamesAndCodes()
     m_languageCodes.clear();
     m_indicesByLocale.clear();
 
-    const QByteArray langpackRoot = qgetenv("SNAP") + "/usr/share/locale-langpack";
-    QDir langpackDir(langpackRoot);
-
-    if (!langpackDir.exists()) {
-        qWarning() << "Cannot find any language packs, bailing out";
-        return;
-    }
-
-    const QStringList langpackNames = langpackDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::Readable);
-
-    QStringList tmpLocales;
-    Q_FOREACH(const QString &langpack, langpackNames) {
-        QLocale tmpLoc(langpack == "pt" ? "pt_PT" : langpack); // "pt" work around for https://bugreports.qt.io/browse/QTBUG-47891
-        tmpLocales.append(tmpLoc.name() + QStringLiteral(".UTF-8"));
-    }
-
-    QSet<QString> localeNames = tmpLocales.toSet();
-    QList<LanguageLocale> languageLocales;
-
-    Q_FOREACH(const QString &loc, localeNames) {
-        LanguageLocale languageLocale(loc);
-
-        // Filter out locales for which we have no display name.
-        if (languageLocale.displayName.isEmpty())
-            continue;
-
-        // Ignore "C"
-        // https://github.com/ubports/ubports-touch/issues/182
-        if (languageLocale.displayName == "C")
-            continue;
-
-        QLocale tmpLoc(languageLocale.locale.getLanguage());
-        languageLocale.likely = tmpLoc.name() == loc.left(loc.indexOf('.')) || // likely if: en_US -> en -> en_US, NOT likely if: en_GB -> en -> en_US
-                (loc.startsWith("pt_PT") && !loc.startsWith("pt_BR")); // "pt" work around for https://bugreports.qt.io/browse/QTBUG-47891
-
-        languageLocales += languageLocale;
-    }
-
-    qSort(languageLocales);
+    const QList<LanguageCatalogEntry> languageLocales(LanguageCatalog::languages());
 
     for (int i(0); i < languageLocales.length(); i++) {
-        const LanguageLocale &languageLocale(languageLocales[i]);
+        const LanguageCatalogEntry &languageLocale(languageLocales[i]);
 
         m_languageNames += languageLocale.displayName;
         m_languageCodes += languageLocale.localeName;
@@ -33,8 +33,6 @@ typedef struct _GSettings GSettings;
 typedef void *gpointer;
 typedef char gchar;
 
-class KeyboardLayout;
-
 class LanguagePlugin : public QObject
 {
 private:
@@ -22,6 +22,7 @@
 #include <QStandardPaths>
 #include <QtDebug>
 #include "onscreenkeyboard-plugin.h"
+#include "keyboard-layout-catalog.h"
 
 #define UBUNTU_KEYBOARD_SCHEMA_ID "com.canonical.keyboard.maliit"
 
@@ -51,7 +52,6 @@ OnScreenKeyboardPlugin::OnScreenKeyboardPlugin(QObject *parent) :
         m_layoutPaths.append(path);
     }
     updateEnabledLayouts();
-    updateKeyboardLayouts();
     updateKeyboardLayoutsModel();
 }
 
@@ -62,10 +62,6 @@ OnScreenKeyboardPlugin::~OnScreenKeyboardPlugin()
         g_signal_handlers_disconnect_by_data(m_maliitSettings, this);
         g_object_unref(m_maliitSettings);
     }
-
-    for (QList<KeyboardLayout *>::const_iterator
-         i(m_keyboardLayouts.begin()); i != m_keyboardLayouts.end(); ++i)
-        delete *i;
 }
 
 SubsetModel *
@@ -77,6 +73,7 @@ OnScreenKeyboardPlugin::keyboardLayoutsModel()
 void
 OnScreenKeyboardPlugin::keyboardLayoutsModelChanged()
 {
+    const QList<KeyboardLayout> &layouts(m_keyboardLayoutsModel.layouts());
     GVariantBuilder builder;
     gchar *current;
     bool removed(true);
@@ -88,9 +85,9 @@ OnScreenKeyboardPlugin::keyboardLayoutsModelChanged()
          i(m_keyboardLayoutsModel.subset().begin());
          i != m_keyboardLayoutsModel.subset().end(); ++i) {
         g_variant_builder_add(&builder, "s",
-                              qPrintable(m_keyboardLayouts[*i]->name()));
+                              qPrintable(layouts[*i].name()));
 
-        if (m_keyboardLayouts[*i]->name() == current)
+        if (layouts[*i].name() == current)
             removed = false;
     }
 
@@ -109,7 +106,7 @@ OnScreenKeyboardPlugin::keyboardLayoutsModelChanged()
                     i = m_keyboardLayoutsModel.subset().size() - 1;
 
                 int index(m_keyboardLayoutsModel.subset()[i]);
-                const QString &name(m_keyboardLayouts[index]->name());
+                const QString &name(layouts[index].name());
 
                 g_settings_set_string(m_maliitSettings,
                                       KEY_CURRENT_LAYOUT, qPrintable(name));
@@ -120,7 +117,7 @@ OnScreenKeyboardPlugin::keyboardLayoutsModelChanged()
 
         if (!found) {
             int index(m_keyboardLayoutsModel.subset().front());
-            const QString &name(m_keyboardLayouts[index]->name());
+            const QString &name(layouts[index].name());
 
             g_settings_set_string(m_maliitSettings,
                                   KEY_CURRENT_LAYOUT, qPrintable(name));
@@ -134,26 +131,6 @@ OnScreenKeyboardPlugin::keyboardLayoutsModelChanged()
                          KEY_ENABLED_LAYOUTS, g_variant_builder_end(&builder));
 }
 
-static bool
-compareLayouts(const KeyboardLayout *layout0,
-               const KeyboardLayout *layout1)
-{
-    QString name0(layout0->displayName());
-    QString name1(layout1->displayName());
-
-    if (name0 == name1) {
-        name0 = layout0->language();
-        name1 = layout1->language();
-
-        if (name0 == name1) {
-            name0 = layout0->name();
-            name1 = layout1->name();
-        }
-    }
-
-    return QString::localeAwareCompare(name0, name1) < 0;
-}
-
 void
 OnScreenKeyboardPlugin::updateEnabledLayouts()
 {
@@ -185,32 +162,6 @@ OnScreenKeyboardPlugin::updateEnabledLayouts()
                          KEY_ENABLED_LAYOUTS, g_variant_builder_end(&builder));
 }
 
-void
-OnScreenKeyboardPlugin::updateKeyboardLayouts()
-{
-    m_keyboardLayouts.clear();
-
-    for (int i = 0; i < m_layoutPaths.count(); i++) {
-        QDir layoutsDir(m_layoutPaths.at(i));
-        layoutsDir.setFilter(QDir::Dirs);
-        layoutsDir.setSorting(QDir::Name);
-
-        QFileInfoList fileInfoList(layoutsDir.entryInfoList());
-
-        for (QFileInfoList::const_iterator
-             i(fileInfoList.begin()); i != fileInfoList.end(); ++i) {
-            KeyboardLayout *layout(new KeyboardLayout(*i));
-
-            if (!layout->language().isEmpty())
-                m_keyboardLayouts += layout;
-            else
-                delete layout;
-        }
-    }
-
-    qSort(m_keyboardLayouts.begin(), m_keyboardLayouts.end(), compareLayouts);
-}
-
 void enabledLayoutsChanged(GSettings *settings,
                            gchar     *key,
                            gpointer   user_data);
@@ -218,28 +169,8 @@ void enabledLayoutsChanged(GSettings *settings,
 void
 OnScreenKeyboardPlugin::updateKeyboardLayoutsModel()
 {
-    QStringList customRoles;
-    customRoles += "language";
-    customRoles += "icon";
-
-    m_keyboardLayoutsModel.setCustomRoles(customRoles);
-
-    QVariantList superset;
-
-    for (QList<KeyboardLayout *>::const_iterator
-         i(m_keyboardLayouts.begin()); i != m_keyboardLayouts.end(); ++i) {
-        QVariantList element;
-
-        if (!(*i)->displayName().isEmpty())
-            element += (*i)->displayName();
-        else
-            element += (*i)->name();
-
-        element += (*i)->shortName();
-        superset += QVariant(element);
-    }
-
-    m_keyboardLayoutsModel.setSuperset(superset);
+    m_keyboardLayoutsModel.setLayouts(
+        KeyboardLayoutCatalog::onScreenLayouts(m_layoutPaths));
 
     enabledLayoutsChanged();
 
@@ -262,12 +193,10 @@ OnScreenKeyboardPlugin::enabledLayoutsChanged()
     g_settings_get(m_maliitSettings, KEY_ENABLED_LAYOUTS, "as", &iter);
 
     while (g_variant_iter_next(iter, "&s", &layout)) {
-        for (int i(0); i < m_keyboardLayouts.length(); i++) {
-            if (m_keyboardLayouts[i]->name() == layout) {
-                subset += i;
-                break;
-            }
-        }
+        int index(m_keyboardLayoutsModel.indexOf(layout));
+
+        if (index >= 0)
+            subset += index;
     }
 
     g_variant_iter_free(iter);
@@ -24,15 +24,12 @@
 
 #include <QtCore>
 #include <gio/gio.h>
-#include "subset-model.h"
-#include "keyboard-layout.h"
+#include "keyboard-layouts-model.h"
 
 typedef struct _GSettings GSettings;
 typedef void *gpointer;
 typedef char gchar;
 
-class KeyboardLayout;
-
 class OnScreenKeyboardPlugin : public QObject
 {
 private:
@@ -57,7 +54,6 @@ public:
 private:
 
     void updateEnabledLayouts();
-    void updateKeyboardLayouts();
     void updateKeyboardLayoutsModel();
 
     void enabledLayoutsChanged();
@@ -67,8 +63,7 @@ private:
                                       gpointer   user_data);
 
     GSettings *m_maliitSettings;
-    QList<KeyboardLayout *> m_keyboardLayouts;
-    SubsetModel m_keyboardLayoutsModel;
+    KeyboardLayoutsModel m_keyboardLayoutsModel;
     QStringList m_layoutPaths;
 };
 
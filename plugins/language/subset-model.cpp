@@ -20,6 +20,8 @@
 
 #include "subset-model.h"
 
+#include <algorithm>
+
 #define CHECKED_ROLE  (Qt::CheckStateRole)
 #define ENABLED_ROLE  (Qt::UserRole + 0)
 #define SUBSET_ROLE   (Qt::UserRole + 1)
@@ -28,18 +30,19 @@
 #define CUSTOM_ROLE   (Qt::UserRole + 4)
 
 bool
-changeLessThan(const SubsetModel::Change *change0,
-               const SubsetModel::Change *change1)
+changeLessThan(const SubsetModel::Change &change0,
+               const SubsetModel::Change &change1)
 {
-    return change0->finish < change1->finish;
+    return change0.finish < change1.finish;
 }
 
 SubsetModel::SubsetModel(QObject *parent) :
     QAbstractListModel(parent),
     m_allowEmpty(true),
-    m_checked(0),
-    m_ignore(QDateTime::currentMSecsSinceEpoch())
+    m_checked(0)
 {
+    m_timer.setSingleShot(true);
+    connect(&m_timer, SIGNAL(timeout()), SLOT(timerExpired()));
 }
 
 const QStringList &
@@ -68,37 +71,67 @@ void
 SubsetModel::setSuperset(const QVariantList &superset)
 {
     if (superset != m_superset) {
-        beginResetModel();
+        m_superset = superset;
+        resetSuperset(m_superset.length());
 
-        for (QList<State *>::iterator i(m_state.begin()); i != m_state.end(); ++i)
-            delete *i;
+        Q_EMIT supersetChanged();
+    }
+}
 
-        m_ignore = QDateTime::currentMSecsSinceEpoch();
-        m_superset = superset;
-        m_subset.clear();
-        m_state.clear();
-        m_checked = 0;
+void
+SubsetModel::resetSuperset(int size)
+{
+    beginResetModel();
 
-        for (int i(0); i < m_superset.length(); i++) {
-            State *state(new State);
-            state->checked = false;
-            state->check = m_ignore;
-            state->uncheck = m_ignore;
+    qint64 time(QDateTime::currentMSecsSinceEpoch());
+    State state = { time, time };
+
+    // Pending changes refer to the old elements.
+    m_change.clear();
+    m_timer.stop();
+
+    m_subset.clear();
+    m_state.fill(state, size);
+    m_checkedBits.fill(false, size);
+    m_subsetBits.fill(false, size);
+    m_checked = 0;
+
+    if (!m_allowEmpty && size > 0) {
+        m_subset += 0;
+        m_checkedBits.setBit(0);
+        m_subsetBits.setBit(0);
+        m_checked = 1;
+    }
 
-            m_state += state;
-        }
+    endResetModel();
 
-        if (!m_allowEmpty && !m_superset.isEmpty()) {
-            m_subset += 0;
-            m_state[0]->checked = true;
-            m_checked = 1;
-        }
+    Q_EMIT subsetChanged();
+}
 
-        endResetModel();
+int
+SubsetModel::supersetSize() const
+{
+    return m_superset.length();
+}
 
-        Q_EMIT subsetChanged();
-        Q_EMIT supersetChanged();
-    }
+QVariant
+SubsetModel::elementData(int element, int column) const
+{
+    QVariantList list(m_superset[element].toList());
+
+    if (0 <= column && column < list.length())
+        return list[column];
+
+    return QVariant();
+}
+
+QVariant
+SubsetModel::display(int element) const
+{
+    if (element < 0 || element >= supersetSize())
+        return QVariant();
+
+    return elementData(element, 0);
 }
 
 const QList<int> &
@@ -113,30 +146,31 @@ SubsetModel::setSubset(const QList<int> &subset)
     if (subset != m_subset) {
         beginResetModel();
 
-        m_ignore = QDateTime::currentMSecsSinceEpoch();
+        qint64 time(QDateTime::currentMSecsSinceEpoch());
+        State state = { time, time };
+
+        m_change.clear();
+        m_timer.stop();
+
         m_subset.clear();
+        m_state.fill(state);
+        m_checkedBits.fill(false);
+        m_subsetBits.fill(false);
         m_checked = 0;
 
-        for (QList<State *>::iterator i(m_state.begin()); i != m_state.end(); ++i) {
-            (*i)->checked = false;
-            (*i)->check = m_ignore;
-            (*i)->uncheck = m_ignore;
-        }
-
         for (QList<int>::const_iterator i(subset.begin()); i != subset.end(); ++i) {
-            if (0 <= *i && *i < m_superset.length()) {
+            if (0 <= *i && *i < m_state.size() && !m_subsetBits.testBit(*i)) {
                 m_subset += *i;
-
-                if (!m_state[*i]->checked) {
-                    m_state[*i]->checked = true;
-                    m_checked++;
-                }
+                m_subsetBits.setBit(*i);
+                m_checkedBits.setBit(*i);
+                m_checked++;
             }
         }
 
-        if (!m_allowEmpty && m_checked == 0 && !m_superset.isEmpty()) {
+        if (!m_allowEmpty && m_checked == 0 && !m_state.isEmpty()) {
             m_subset += 0;
-            m_state[0]->checked = true;
+            m_subsetBits.setBit(0);
+            m_checkedBits.setBit(0);
             m_checked = 1;
         }
 
@@ -159,33 +193,18 @@ SubsetModel::setAllowEmpty(bool allowEmpty)
         m_allowEmpty = allowEmpty;
 
         // Check the first element if we can't have an empty subset.
-        if (!m_allowEmpty && m_state.length() > 0 && m_checked == 0) {
+        if (!m_allowEmpty && !m_state.isEmpty() && m_checked == 0) {
             m_subset += 0;
-            m_state[0]->checked = true;
+            m_subsetBits.setBit(0);
+            m_checkedBits.setBit(0);
             m_checked = 1;
         }
 
         if (m_checked == 1) {
-            int single(-1);
-
-            for (int i(0); i < m_state.length(); i++) {
-                if (m_state[i]->checked) {
-                    single = i;
-                    break;
-                }
-            }
+            int single(firstChecked());
 
-            for (int i(0); i < m_subset.length(); i++) {
-                if (m_subset[i] == single) {
-                    QModelIndex row(index(i, 0));
-                    Q_EMIT dataChanged(row, row, QVector<int>(1, ENABLED_ROLE));
-                }
-            }
-
-            if (single >= 0) {
-                QModelIndex row(index(m_subset.length() + single, 0));
-                Q_EMIT dataChanged(row, row, QVector<int>(1, ENABLED_ROLE));
-            }
+            if (single >= 0)
+                elementChanged(single, ENABLED_ROLE);
         }
 
         Q_EMIT allowEmptyChanged();
@@ -195,7 +214,8 @@ SubsetModel::setAllowEmpty(bool allowEmpty)
 bool
 SubsetModel::checked(int element)
 {
-    return m_state[element]->checked;
+    return 0 <= element && element < m_checkedBits.size()
+        && m_checkedBits.testBit(element);
 }
 
 void
@@ -203,15 +223,18 @@ SubsetModel::setChecked(int  element,
                         bool checked,
                         int  timeout)
 {
+    if (element < 0 || element >= m_state.size())
+        return;
+
     qint64 time(QDateTime::currentMSecsSinceEpoch());
 
     if (checked)
-        m_state[element]->check = time;
+        m_state[element].check = time;
     else
-        m_state[element]->uncheck = time;
+        m_state[element].uncheck = time;
 
-    if (checked != m_state[element]->checked) {
-        m_state[element]->checked = checked;
+    if (checked != m_checkedBits.testBit(element)) {
+        m_checkedBits.setBit(element, checked);
 
         if (checked)
             m_checked++;
@@ -219,48 +242,113 @@ SubsetModel::setChecked(int  element,
             m_checked--;
 
         if (!m_allowEmpty && (m_checked == 1 || (m_checked == 2 && checked))) {
-            int single(-1);
+            int single(firstChecked(element));
 
-            for (int i(0); i < m_state.length(); i++) {
-                if (i != element && m_state[i]->checked) {
-                    single = i;
-                    break;
-                }
-            }
+            if (single >= 0)
+                elementChanged(single, ENABLED_ROLE);
+        }
 
-            for (int i(0); i < m_subset.length(); i++) {
-                if (m_subset[i] == single) {
-                    QModelIndex row(index(i, 0));
-                    Q_EMIT dataChanged(row, row, QVector<int>(1, ENABLED_ROLE));
-                }
-            }
+        elementChanged(element, CHECKED_ROLE);
 
-            if (single >= 0) {
-                QModelIndex row(index(m_subset.length() + single, 0));
-                Q_EMIT dataChanged(row, row, QVector<int>(1, ENABLED_ROLE));
-            }
-        }
+        scheduleChanges(QVector<int>(1, element), checked, time, timeout);
+    }
+}
 
-        for (int i(0); i < m_subset.length(); i++) {
-            if (m_subset[i] == element) {
-                QModelIndex row(index(i, 0));
-                Q_EMIT dataChanged(row, row, QVector<int>(1, CHECKED_ROLE));
-            }
+void
+SubsetModel::setAllChecked(bool checked,
+                           int  timeout)
+{
+    qint64 time(QDateTime::currentMSecsSinceEpoch());
+    QVector<int> changed;
+
+    // The element that stays checked if the subset may not be empty.
+    int keep(-1);
+
+    if (!checked && !m_allowEmpty) {
+        if (!m_subset.isEmpty() && m_checkedBits.testBit(m_subset.first()))
+            keep = m_subset.first();
+        else
+            keep = firstChecked();
+    }
+
+    for (int i(0); i < m_state.size(); i++) {
+        if (i == keep)
+            continue;
+
+        if (checked)
+            m_state[i].check = time;
+        else
+            m_state[i].uncheck = time;
+
+        if (checked != m_checkedBits.testBit(i)) {
+            m_checkedBits.setBit(i, checked);
+            changed += i;
         }
+    }
+
+    if (changed.isEmpty())
+        return;
+
+    m_checked = checked ? m_state.size() : (keep >= 0 ? 1 : 0);
+
+    QVector<int> roles;
+    roles += CHECKED_ROLE;
+    roles += ENABLED_ROLE;
+    Q_EMIT dataChanged(index(0, 0), index(rowCount() - 1, 0), roles);
 
-        QModelIndex row(index(m_subset.length() + element, 0));
-        Q_EMIT dataChanged(row, row, QVector<int>(1, CHECKED_ROLE));
+    scheduleChanges(changed, checked, time, timeout);
+}
+
+void
+SubsetModel::scheduleChanges(const QVector<int> &elements,
+                             bool                checked,
+                             qint64              start,
+                             int                 timeout)
+{
+    Change change;
+    change.element = -1;
+    change.checked = checked;
+    change.start = start;
+    change.finish = start + timeout;
 
-        Change *change(new Change);
-        change->element = element;
-        change->checked = checked;
-        change->start = time;
-        change->finish = time + timeout;
+    // All changes share a finish time, so they form one contiguous run.
+    QVector<Change>::iterator i(std::upper_bound(m_change.begin(), m_change.end(),
+                                                 change, changeLessThan));
+    int position(i - m_change.begin());
+
+    m_change.insert(position, elements.size(), change);
+
+    for (int j(0); j < elements.size(); j++)
+        m_change[position + j].element = elements[j];
+
+    // Re-arm the single timer for the earliest pending change.
+    if (position == 0 || !m_timer.isActive())
+        m_timer.start(qMax<qint64>(0, m_change.first().finish - start));
+}
 
-        m_change.insert(qUpperBound(m_change.begin(), m_change.end(), change, changeLessThan), change);
+int
+SubsetModel::firstChecked(int except) const
+{
+    for (int i(0); i < m_checkedBits.size(); i++) {
+        if (i != except && m_checkedBits.testBit(i))
+            return i;
+    }
+
+    return -1;
+}
+
+void
+SubsetModel::elementChanged(int element, int role)
+{
+    QVector<int> roles(1, role);
 
-        QTimer::singleShot(timeout, this, SLOT(timerExpired()));
+    if (m_subsetBits.testBit(element)) {
+        QModelIndex row(index(m_subset.indexOf(element), 0));
+        Q_EMIT dataChanged(row, row, roles);
     }
+
+    QModelIndex row(index(m_subset.length() + element, 0));
+    Q_EMIT dataChanged(row, row, roles);
 }
 
 QHash<int, QByteArray>
@@ -285,7 +373,7 @@ SubsetModel::rowCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent);
 
-    return m_subset.length() + m_superset.length();
+    return m_subset.length() + supersetSize();
 }
 
 Qt::ItemFlags
@@ -300,12 +388,15 @@ QVariant
 SubsetModel::data(const QModelIndex &index,
                   int                role) const
 {
+    if (index.row() < 0 || index.row() >= rowCount())
+        return QVariant();
+
     switch (role) {
     case CHECKED_ROLE:
-        return m_state[elementAtIndex(index)]->checked ? Qt::Checked : Qt::Unchecked;
+        return m_checkedBits.testBit(elementAtIndex(index)) ? Qt::Checked : Qt::Unchecked;
 
     case ENABLED_ROLE:
-        return m_allowEmpty || m_checked != 1 || !m_state[elementAtIndex(index)]->checked;
+        return m_allowEmpty || m_checked != 1 || !m_checkedBits.testBit(elementAtIndex(index));
 
     case SUBSET_ROLE:
     case SUPERSET_ROLE:
@@ -316,14 +407,7 @@ SubsetModel::data(const QModelIndex &index,
         break;
     }
 
-    int column(role - CUSTOM_ROLE);
-    int element(elementAtIndex(index));
-    QVariantList list(m_superset[element].toList());
-
-    if (0 <= column && column < list.length())
-        return list[column];
-
-    return QVariant();
+    return elementData(elementAtIndex(index), role - CUSTOM_ROLE);
 }
 
 bool
@@ -357,37 +441,75 @@ SubsetModel::setData(const QModelIndex &index,
 void
 SubsetModel::timerExpired()
 {
-    Change *change(m_change.first());
-
-    m_change.removeFirst();
-
-    if (change->start > m_ignore) {
-        if (change->checked) {
-            if (change->start > m_state[change->element]->uncheck) {
-                if (!m_subset.contains(change->element)) {
-                    beginInsertRows(QModelIndex(), m_subset.length(), m_subset.length());
-                    m_subset += change->element;
-                    endInsertRows();
-
-                    Q_EMIT subsetChanged();
-                }
+    qint64 time(QDateTime::currentMSecsSinceEpoch());
+    QVector<int> appended;
+    QBitArray removed(m_state.size());
+    int due(0);
+
+    /* Apply every change that is due, then update the rows in as few
+     * contiguous ranges as possible. The first change is always due, the
+     * timer may fire a little early. */
+    while (due < m_change.size() && (due == 0 || m_change[due].finish <= time)) {
+        const Change &change(m_change[due++]);
+        const State &state(m_state[change.element]);
+
+        if (change.checked) {
+            if (change.start > state.uncheck && !m_subsetBits.testBit(change.element)) {
+                m_subsetBits.setBit(change.element);
+                appended += change.element;
             }
         } else {
-            if (change->start > m_state[change->element]->check) {
-                for (int i(0); i < m_subset.length(); i++) {
-                    while (i < m_subset.length() && m_subset[i] == change->element) {
-                        beginRemoveRows(QModelIndex(), i, i);
-                        m_subset.removeAt(i);
-                        endRemoveRows();
-                    }
-                }
-
-                Q_EMIT subsetChanged();
+            if (change.start > state.check && m_subsetBits.testBit(change.element)) {
+                m_subsetBits.clearBit(change.element);
+
+                int position(appended.indexOf(change.element));
+
+                if (position >= 0)
+                    appended.remove(position);
+                else
+                    removed.setBit(change.element);
             }
         }
     }
 
-    delete change;
+    m_change.remove(0, due);
+
+    bool changed(false);
+
+    for (int last(m_subset.length() - 1); last >= 0; last--) {
+        if (!removed.testBit(m_subset[last]))
+            continue;
+
+        int first(last);
+
+        while (first > 0 && removed.testBit(m_subset[first - 1]))
+            first--;
+
+        beginRemoveRows(QModelIndex(), first, last);
+        m_subset.erase(m_subset.begin() + first, m_subset.begin() + last + 1);
+        endRemoveRows();
+
+        changed = true;
+        last = first;
+    }
+
+    if (!appended.isEmpty()) {
+        beginInsertRows(QModelIndex(), m_subset.length(),
+                        m_subset.length() + appended.size() - 1);
+
+        for (int i(0); i < appended.size(); i++)
+            m_subset += appended[i];
+
+        endInsertRows();
+
+        changed = true;
+    }
+
+    if (changed)
+        Q_EMIT subsetChanged();
+
+    if (!m_change.isEmpty())
+        m_timer.start(qMax<qint64>(0, m_change.first().finish - time));
 }
 
 int
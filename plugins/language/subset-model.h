@@ -72,11 +72,21 @@ public:
     virtual void setAllowEmpty(bool allowEmpty);
     Q_SIGNAL virtual void allowEmptyChanged() const;
 
+    // Display text of an element, without going through the superset.
+    Q_INVOKABLE virtual QVariant display(int element) const;
+
     Q_INVOKABLE virtual bool checked(int element);
     Q_INVOKABLE virtual void setChecked(int  element,
                                         bool checked,
                                         int  timeout);
 
+    /* Checks or unchecks every element at once. The check states change
+     * in a single dataChanged() and the subset is updated in one batch
+     * when the timeout expires. If the subset may not be empty, unchecking
+     * keeps one element checked. */
+    Q_INVOKABLE virtual void setAllChecked(bool checked,
+                                           int  timeout);
+
     virtual QHash<int, QByteArray> roleNames() const;
 
     virtual int rowCount(const QModelIndex &parent = QModelIndex()) const;
@@ -95,8 +105,26 @@ protected:
     virtual int elementAtRow(int row) const;
     virtual int elementAtIndex(const QModelIndex &index) const;
 
+    /* Subclasses holding typed elements override these instead of
+     * providing a QVariantList superset. */
+    virtual int supersetSize() const;
+    virtual QVariant elementData(int element, int column) const;
+
+    // Resets the model to size unchecked elements.
+    void resetSuperset(int size);
+
+    // Emits dataChanged() for role on every row showing element.
+    void elementChanged(int element, int role);
+
+    // First checked element other than except, or -1.
+    int firstChecked(int except = -1) const;
+
+    void scheduleChanges(const QVector<int> &elements,
+                         bool                checked,
+                         qint64              start,
+                         int                 timeout);
+
     struct State {
-        bool checked;
         qint64 check;
         qint64 uncheck;
     };
@@ -113,14 +141,19 @@ protected:
     QList<int> m_subset;
     bool m_allowEmpty;
 
-    QList<State *> m_state;
-    QList<Change *> m_change;
+    // Per-element check state and subset membership.
+    QBitArray m_checkedBits;
+    QBitArray m_subsetBits;
+    QVector<State> m_state;
+
+    // Pending subset changes, ordered by finish time.
+    QVector<Change> m_change;
+    QTimer m_timer;
 
     int m_checked;
-    qint64 m_ignore;
 
-    friend bool changeLessThan(const Change *change0,
-                               const Change *change1);
+    friend bool changeLessThan(const Change &change0,
+                               const Change &change1);
 };
 
 #endif // SUBSET_MODEL_H
@@ -30,6 +30,8 @@
 #include <QtDBus/QDBusVariant>
 #include <act/act.h>
 
+#include <SystemSettings/BlockingCall>
+
 // FIXME: need to do this better including #include "../../src/i18n.h"
 // and linking to it
 #include <libintl.h>
@@ -293,6 +295,8 @@ bool SecurityPrivacy::setPasswordModeWithPolicykit(SecurityType type, QString pa
     if (password.isEmpty())
         return false;
 
+    SystemSettings::BlockingCall blocking(
+        "SecurityPrivacy::setPasswordModeWithPolicykit");
     QProcess polkitHelper;
     polkitHelper.setProgram(HELPER_EXEC);
     polkitHelper.start();
@@ -344,6 +348,7 @@ QString SecurityPrivacy::setPassword(QString oldValue, QString value)
     pamHelper.closeWriteChannel();
     pamHelper.setReadChannel(QProcess::StandardError);
 
+    SystemSettings::BlockingCall blocking("SecurityPrivacy::setPassword");
     pamHelper.waitForFinished();
     if (pamHelper.state() == QProcess::Running || // after 30s!
         pamHelper.exitStatus() != QProcess::NormalExit ||
@@ -27,7 +27,7 @@ ListItem {
     id: root
     objectName: "entryComponent-updates"
     property int updatesAvailable: {
-        var imageUpdateCount = SystemImage.checkTarget() ? 1 : 0;
+        var imageUpdateCount = SystemImage.ready && SystemImage.checkTarget() ? 1 : 0;
         return updatesRep.count + imageUpdateCount;
     }
     height: (updatesAvailable > 0) || showAllUI ? layout.height : 0
@@ -95,6 +95,12 @@ ItemPage {
                         Flickable.StopAtBounds
         flickableDirection: Flickable.VerticalFlick
 
+        // Older installed updates are paged in as the user scrolls to them.
+        onAtYEndChanged: {
+            if (atYEnd)
+                UpdateManager.installedUpdates.loadMore();
+        }
+
         Column {
             id: content
             anchors { left: parent.left; right: parent.right }
@@ -202,6 +208,7 @@ ItemPage {
                         width: imageUpdateCol.width
                         updateState: model.updateState
                         progress: model.progress
+                        eta: model.eta
                         version: remoteVersion
                         size: model.size
                         changelog: model.changelog
@@ -331,9 +338,12 @@ ItemPage {
                         kind: model.kind
                         iconUrl: model.iconUrl
                         changelog: model.changelog
+                        hasChangelog: model.hasChangelog
                         updateState: Update.StateInstalled
                         updatedAt: model.updatedAt
 
+                        onChangelogRequested: installedRepeater.model.fetchChangelog(index)
+
                         leadingActions: ListItemActions {
                            actions: [
                                Action {
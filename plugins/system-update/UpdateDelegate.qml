@@ -34,8 +34,11 @@ ListItem {
     property real size
     property string version
     property string downloadId
+    property real eta: -1 // Seconds left of the download, if known.
     property date updatedAt
     property bool launchable: false
+    // Whether there is a changelog, even if it has not been loaded yet.
+    property bool hasChangelog: changelog !== ""
 
     property alias name: nameLabel.text
     property alias error: errorElementDetail.text
@@ -49,6 +52,14 @@ ListItem {
     signal resume()
     signal install()
     signal launch()
+    // Emitted when an empty changelog is expanded, so it can be loaded.
+    signal changelogRequested()
+
+    function toggleChangelog() {
+        if (!changelogCol.visible && changelog === "")
+            changelogRequested();
+        changelogCol.visible = !changelogCol.visible;
+    }
 
     height: layout.height + (divider.visible ? divider.height : 0)
     Behavior on height {
@@ -203,11 +214,11 @@ ListItem {
                     Layout.fillWidth: true
                     Layout.alignment: Qt.AlignLeft | Qt.AlignVCenter
 
-                    enabled: update.changelog !== ""
+                    enabled: update.hasChangelog
                     version: update.version
                     visible: updateState !== Update.StateFailed && downloadLabel.text === ""
                     expanded: changelogCol.visible
-                    onClicked: changelogCol.visible = !changelogCol.visible
+                    onClicked: update.toggleChangelog()
                 }
 
                 Label {
@@ -235,6 +246,12 @@ ListItem {
                             return i18n.tr("Waiting to download");
 
                         case Update.StateDownloading:
+                            if (eta > 0) {
+                                var minutes = Math.ceil(eta / 60);
+                                return i18n.tr("%1 minute left",
+                                               "%1 minutes left",
+                                               minutes).arg(minutes);
+                            }
                             return i18n.tr("Downloading");
 
                         default:
@@ -351,10 +368,10 @@ ListItem {
             ChangelogExpander {
                 Layout.fillWidth: true
                 version: update.version
-                enabled: update.changelog !== ""
+                enabled: update.hasChangelog
                 visible: updateState !== Update.StateFailed && downloadLabel.text !== ""
                 expanded: changelogCol.visible
-                onClicked: changelogCol.visible = !changelogCol.visible
+                onClicked: update.toggleChangelog()
             }
 
             Column {
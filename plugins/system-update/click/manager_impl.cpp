@@ -26,6 +26,7 @@
 #include <QDateTime>
 #include <QDesktopServices>
 #include <QFinalState>
+#include <QHash>
 #include <QState>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -239,45 +240,75 @@ void ManagerImpl::synchronize(
     /* Runs through all DB updates and if the exist in the manifest, each
     update is “synchronized” with data from the manifest, i.e. marked as
     installed if installed. If not found, this means the app might be
-    uninstalled, and we remove the DB entry. */
+    uninstalled, and we remove the DB entry.
+
+    The manifest is indexed by identifier so that this is linear in the
+    number of updates, and all changes are written in one transaction so
+    that the model is refreshed once. */
+    QHash<QString, QSharedPointer<Update> > installed;
+    Q_FOREACH(auto manifestUpdate, manifestUpdates) {
+        installed.insert(manifestUpdate->identifier(), manifestUpdate);
+    }
+
+    QList<QSharedPointer<Update> > changed;
+    QList<QSharedPointer<Update> > removed;
     auto dbUpdates = m_model->db()->updates();
     Q_FOREACH(auto dbUpdate, dbUpdates) {
         if (dbUpdate->kind() != Update::Kind::KindClick) {
             continue;
         }
-        bool found = false;
-        Q_FOREACH(auto manifestUpdate, manifestUpdates) {
-            /* The local version of a click in the manifest, matched exactly a
-            a remote version in one of our db updates. */
-            if (manifestUpdate->localVersion() == dbUpdate->remoteVersion()) {
-                // We can't know when it was updated, so now() will have to do.
-                if (!dbUpdate->updatedAt().isValid()) {
-                    dbUpdate->setUpdatedAt(QDateTime::currentDateTimeUtc());
-                }
-                dbUpdate->setState(Update::State::StateInstallFinished);
-                dbUpdate->setInstalled(true);
+
+        auto manifestUpdate = installed.value(dbUpdate->identifier());
+        if (manifestUpdate.isNull()) {
+            removed << dbUpdate;
+            continue;
+        }
+
+        /* The local version of a click in the manifest, matched exactly a
+        a remote version in one of our db updates. */
+        if (manifestUpdate->localVersion() == dbUpdate->remoteVersion()) {
+            if (dbUpdate->installed()
+                && dbUpdate->state() == Update::State::StateInstallFinished
+                && dbUpdate->updatedAt().isValid()
+                && dbUpdate->downloadId().isEmpty()
+                && dbUpdate->error().isEmpty()) {
+                continue; // Already in sync.
+            }
+
+            // We can't know when it was updated, so now() will have to do.
+            if (!dbUpdate->updatedAt().isValid()) {
+                dbUpdate->setUpdatedAt(QDateTime::currentDateTimeUtc());
+            }
+            dbUpdate->setState(Update::State::StateInstallFinished);
+            dbUpdate->setInstalled(true);
+            dbUpdate->setDownloadId("");
+            dbUpdate->setError("");
+            changed << dbUpdate;
+        } else {
+            // Fast forward the local version.
+            dbUpdate->setLocalVersion(manifestUpdate->localVersion());
+
+            // Is update in need of update, but at the same time installed?
+            if (dbUpdate->isUpdateRequired() && dbUpdate->installed()) {
+                dbUpdate->setInstalled(false);
+                dbUpdate->setState(Update::State::StateAvailable);
                 dbUpdate->setDownloadId("");
                 dbUpdate->setError("");
-                m_model->update(dbUpdate);
-                found = true;
-            } else if (manifestUpdate->identifier() == dbUpdate->identifier()) {
-                // Fast forward the local version.
-                dbUpdate->setLocalVersion(manifestUpdate->localVersion());
-
-                // Is update in need of update, but at the same time installed?
-                if (dbUpdate->isUpdateRequired() && dbUpdate->installed()) {
-                    dbUpdate->setInstalled(false);
-                    dbUpdate->setState(Update::State::StateAvailable);
-                    dbUpdate->setDownloadId("");
-                    dbUpdate->setError("");
-                    m_model->update(dbUpdate);
-                }
-                found = true;
+                changed << dbUpdate;
             }
         }
-        if (!found) {
-            m_model->remove(dbUpdate);
-        }
+    }
+
+    if (changed.isEmpty() && removed.isEmpty()) {
+        return;
+    }
+
+    UpdateDb::Transaction transaction(m_model->db());
+    Q_FOREACH(auto update, changed) {
+        m_model->update(update);
+    }
+    Q_FOREACH(auto update, removed) {
+        m_model->remove(update);
     }
 }
 
@@ -352,75 +383,80 @@ void ManagerImpl::requestMetadata()
 void ManagerImpl::parseMetadata(const QJsonArray &array)
 {
     auto now = QDateTime::currentDateTimeUtc();
-    for (int i = 0; i < array.size(); i++) {
-        auto object = array.at(i).toObject();
-
-        auto downloads = object["downloads"].toArray();
-        QJsonObject download;
-
-        foreach (const auto &value, downloads) {
-            auto download_obj = value.toObject();
-            if (download_obj["channel"].toString() == Helpers::getSystemCodename() &&
-                Helpers::isArchSupported(download_obj["architecture"].toString())) {
-                download = download_obj;
-                break;
+    /* Stage all new updates in one transaction, committed before the
+    model is used by the next state. */
+    {
+        UpdateDb::Transaction transaction(m_model->db());
+        for (int i = 0; i < array.size(); i++) {
+            auto object = array.at(i).toObject();
+
+            auto downloads = object["downloads"].toArray();
+            QJsonObject download;
+
+            foreach (const auto &value, downloads) {
+                auto download_obj = value.toObject();
+                if (download_obj["channel"].toString() == Helpers::getSystemCodename() &&
+                    Helpers::isArchSupported(download_obj["architecture"].toString())) {
+                    download = download_obj;
+                    break;
+                }
             }
-        }
 
-        auto identifier = object["id"].toString();
+            auto identifier = object["id"].toString();
 
-        // This should not happen, but better to be on the safe side
-        if (download.isEmpty()) {
-            qWarning() << "download metadata for" << identifier <<
-                          "is empty";
-            m_candidates.remove(identifier);
-            continue;
-        }
-
-        auto revision = download["revision"].toInt();
-        // Check if we already have it's metadata.
-        auto dbUpdate = m_model->get(identifier, revision);
-        if (dbUpdate && !m_ignore_version) {
-            /* If this update is less than 24 hours old (to us), and it has a
-            token, we ignore it. */
-            if (dbUpdate->createdAt().secsTo(now) <= 86400
-                && !dbUpdate->token().isEmpty()) {
+            // This should not happen, but better to be on the safe side
+            if (download.isEmpty()) {
+                qWarning() << "download metadata for" << identifier <<
+                              "is empty";
                 m_candidates.remove(identifier);
                 continue;
             }
-        }
 
-        auto version = download["version"].toString();
-        auto icon_url = object["icon"].toString();
-
-        auto url = download["download_url"].toString();
-        auto download_sha512 = download["download_sha512"].toString();
-
-        auto changelog = object["changelog"].toString();
-        auto size = object["filesize"].toInt();
-        auto title = object["name"].toString();
-
-        if (m_candidates.contains(identifier)) {
-            auto update = m_candidates.value(identifier);
-            update->setRemoteVersion(version);
-
-            update->setIconUrl(icon_url);
-            update->setDownloadUrl(url);
-            update->setBinaryFilesize(size);
-            update->setDownloadHash(download_sha512);
-            update->setChangelog(changelog);
-            update->setTitle(title);
-            update->setRevision(revision);
-            update->setState(Update::State::StateAvailable);
-
-            QStringList command;
-            /* TODO: remove "--allow-untrusted" once this is fixed:
-             *   https://github.com/UbuntuOpenStore/openstore-meta/issues/157
-             */
-            command << Helpers::whichPkcon()
-                << "-p" << "--allow-untrusted" << "install-local" << "$file";
-            update->setCommand(command);
-            m_model->add(update);
+            auto revision = download["revision"].toInt();
+            // Check if we already have it's metadata.
+            auto dbUpdate = m_model->get(identifier, revision);
+            if (dbUpdate && !m_ignore_version) {
+                /* If this update is less than 24 hours old (to us), and it has a
+                token, we ignore it. */
+                if (dbUpdate->createdAt().secsTo(now) <= 86400
+                    && !dbUpdate->token().isEmpty()) {
+                    m_candidates.remove(identifier);
+                    continue;
+                }
+            }
+
+            auto version = download["version"].toString();
+            auto icon_url = object["icon"].toString();
+
+            auto url = download["download_url"].toString();
+            auto download_sha512 = download["download_sha512"].toString();
+
+            auto changelog = object["changelog"].toString();
+            auto size = object["filesize"].toInt();
+            auto title = object["name"].toString();
+
+            if (m_candidates.contains(identifier)) {
+                auto update = m_candidates.value(identifier);
+                update->setRemoteVersion(version);
+
+                update->setIconUrl(icon_url);
+                update->setDownloadUrl(url);
+                update->setBinaryFilesize(size);
+                update->setDownloadHash(download_sha512);
+                update->setChangelog(changelog);
+                update->setTitle(title);
+                update->setRevision(revision);
+                update->setState(Update::State::StateAvailable);
+
+                QStringList command;
+                /* TODO: remove "--allow-untrusted" once this is fixed:
+                 *   https://github.com/UbuntuOpenStore/openstore-meta/issues/157
+                 */
+                command << Helpers::whichPkcon()
+                    << "-p" << "--allow-untrusted" << "install-local" << "$file";
+                update->setCommand(command);
+                m_model->add(update);
+            }
         }
     }
 
@@ -17,81 +17,43 @@
  */
 
 #include "click/manifest_impl.h"
-#include "helpers.h"
-
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonValue>
+#include "clickdatabase.h"
 
 namespace UpdatePlugin
 {
 namespace Click
 {
 ManifestImpl::ManifestImpl(QObject *parent)
+    : ManifestImpl(ClickDatabase::instance(), parent)
+{
+}
+
+ManifestImpl::ManifestImpl(ClickDatabase *database, QObject *parent)
     : Manifest(parent)
-    , m_process()
+    , m_database(database)
 {
-    connect(&m_process, SIGNAL(finished(const int&)),
-            this, SLOT(handleProcessSuccess(const int&)));
 }
 
 ManifestImpl::~ManifestImpl()
 {
-    if (m_process.state() != QProcess::NotRunning) {
-        m_process.kill();
-        m_process.waitForFinished(1);
-    }
 }
 
 void ManifestImpl::request()
 {
-    QStringList args("list");
-    args << "--manifest";
-    QString command = Helpers::whichClick();
-    m_process.start(command, args);
-    if (!m_process.waitForStarted()) {
-        handleProcessError(m_process.error());
-    }
+    /* Reply asynchronously, as when we used to run click, so that callers
+    can connect to our signals after requesting. */
+    QMetaObject::invokeMethod(this, "handleRequest", Qt::QueuedConnection);
 }
 
-void ManifestImpl::handleProcessSuccess(const int &exitCode)
+void ManifestImpl::handleRequest()
 {
-    Q_UNUSED(exitCode);
-
-    QString output(m_process.readAllStandardOutput());
-    auto document = QJsonDocument::fromJson(output.toUtf8());
-    if (document.isArray()) {
-        Q_EMIT requestSucceeded(document.array());
+    QJsonArray manifest = m_database->manifests();
+    if (m_database->isValid()) {
+        Q_EMIT requestSucceeded(manifest);
     } else {
+        qCritical() << Q_FUNC_INFO << "Could not read the click database.";
         Q_EMIT requestFailed();
     }
 }
-
-void ManifestImpl::handleProcessError(const QProcess::ProcessError &error)
-{
-    QString err;
-    switch (error) {
-    case QProcess::FailedToStart:
-        err = "Failed to start";
-        break;
-    case QProcess::Crashed:
-        err = "Crashed";
-        break;
-    case QProcess::Timedout:
-        err = "Timed out";
-        break;
-    case QProcess::WriteError:
-        err = "Write error";
-        break;
-    case QProcess::ReadError:
-        err = "Read error";
-        break;
-    case QProcess::UnknownError:
-        err = "Unknown error";
-        break;
-    }
-    qCritical() << Q_FUNC_INFO << "Manifest failed to execute process:" << err;
-    Q_EMIT requestFailed();
-}
 } // Click
 } // UpdatePlugin
@@ -21,25 +21,28 @@
 
 #include "click/manifest.h"
 
-#include <QProcess>
+class ClickDatabase;
 
 namespace UpdatePlugin
 {
 namespace Click
 {
+/* Produces the manifest from the click database shared with the rest of
+the process, rather than from `click list --manifest`. */
 class ManifestImpl : public Manifest
 {
     Q_OBJECT
 public:
     explicit ManifestImpl(QObject *parent = nullptr);
+    // This constructor enables testing.
+    explicit ManifestImpl(ClickDatabase *database, QObject *parent = nullptr);
     ~ManifestImpl();
 public Q_SLOTS:
     virtual void request() override;
 private Q_SLOTS:
-    void handleProcessSuccess(const int &exitCode);
-    void handleProcessError(const QProcess::ProcessError &error);
+    void handleRequest();
 private:
-    QProcess m_process;
+    ClickDatabase *m_database;
 };
 } // Click
 } // UpdatePlugin
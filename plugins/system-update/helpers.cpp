@@ -19,6 +19,8 @@
 #include "helpers.h"
 #include <QProcessEnvironment>
 
+#include <SystemSettings/BlockingCall>
+
 namespace UpdatePlugin
 {
 
@@ -71,6 +73,7 @@ QString Helpers::architectureFromDpkg()
     QString program("dpkg");
     QStringList arguments;
     arguments << "--print-architecture";
+    SystemSettings::BlockingCall blocking("Helpers::architectureFromDpkg");
     QProcess archDetector;
     archDetector.start(program, arguments);
     if (!archDetector.waitForFinished()) {
@@ -84,6 +87,14 @@ QString Helpers::architectureFromDpkg()
 
 QString Helpers::getSystemCodename()
 {
+    static const QString codename
+        { codenameFromLsbRelease() };
+    return codename;
+}
+
+QString Helpers::codenameFromLsbRelease()
+{
+    SystemSettings::BlockingCall blocking("Helpers::codenameFromLsbRelease");
     QProcess lsb_release;
     lsb_release.setProgram("lsb_release");
     lsb_release.setArguments(QStringList() << "-c");
@@ -42,6 +42,7 @@ public:
     static bool isArchSupported(QString arch);
 private:
     static QString architectureFromDpkg();
+    static QString codenameFromLsbRelease();
     static std::vector<std::string> listFolder(const std::string &folder,
                                                const std::string &pattern);
 };
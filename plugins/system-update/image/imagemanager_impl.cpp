@@ -20,22 +20,27 @@
 #include "imagemanager_impl.h"
 
         #include <QDebug>
+// Minimum milliseconds between progress writes to the model and db.
+#define PROGRESS_INTERVAL 500
+
 namespace UpdatePlugin
 {
 namespace Image
 {
 const QString ManagerImpl::ubuntuId = QString("ubuntu");
 ManagerImpl::ManagerImpl(UpdateModel *model, QObject *parent)
-    : ManagerImpl(new QSystemImage(), model, parent)
+    : ManagerImpl(QSystemImage::instance(), model, parent)
 {
-    m_si->setParent(this);
 }
 
 ManagerImpl::ManagerImpl(QSystemImage *si, UpdateModel *model, QObject *parent)
     : Manager(parent)
     , m_model(model)
     , m_si(si)
+    , m_progressInterval(PROGRESS_INTERVAL)
 {
+    m_progressTimer.setSingleShot(true);
+    connect(&m_progressTimer, SIGNAL(timeout()), this, SLOT(flushProgress()));
 
     // Move this to use own accessmanager class
     m_manager = new QNetworkAccessManager();
@@ -73,6 +78,22 @@ ManagerImpl::ManagerImpl(QSystemImage *si, UpdateModel *model, QObject *parent)
     connect(m_si, SIGNAL(updateProcessFailed(const QString&)),
             this, SLOT(handleUpdateProcessFailed(const QString&)));
 
+    /* s-i properties are fetched asynchronously, so wait for them before
+    looking at build numbers. */
+    if (m_si->ready()) {
+        handleReady();
+    } else {
+        connect(m_si, SIGNAL(readyChanged()), this, SLOT(handleReady()));
+    }
+}
+
+void ManagerImpl::handleReady()
+{
+    if (!m_si->ready()) {
+        return;
+    }
+    disconnect(m_si, SIGNAL(readyChanged()), this, SLOT(handleReady()));
+
     /* If we have a pending image update here that has started, make sure
     we call DownloadUpdate so as to capture the UpdateDownloaded event. */
     auto update = m_model->get(ubuntuId, m_si->targetBuildNumber());
@@ -132,6 +153,7 @@ void ManagerImpl::handleUpdateAvailableStatus(const bool isAvailable,
         return;
     }
     if (isAvailable) {
+        UpdateDb::Transaction transaction(m_model->db());
         m_model->setImageUpdate(ubuntuId, rev, updateSize);
         requestChangelog(ubuntuId, rev);
         bool automatic = m_si->downloadMode() > 0;
@@ -145,31 +167,88 @@ void ManagerImpl::handleUpdateAvailableStatus(const bool isAvailable,
     Q_EMIT checkCompleted();
 }
 
+void ManagerImpl::setProgressInterval(const int &msecs)
+{
+    m_progressInterval = msecs;
+}
+
+int ManagerImpl::progressInterval() const
+{
+    return m_progressInterval;
+}
+
 void ManagerImpl::handleDownloadStarted()
 {
+    discardProgress();
+    m_reportedProgress = 0;
+    m_progressClock.start();
     m_model->setProgress(ubuntuId, m_si->targetBuildNumber(), 0);
 }
 
 void ManagerImpl::handleUpdateProgress(const int &percentage, const double &eta)
 {
-    Q_UNUSED(eta)
-    m_model->setProgress(ubuntuId, m_si->targetBuildNumber(), percentage);
+    /* Only a new percentage is written to the db; the ETA, which changes
+    with almost every report, only goes to the model. */
+    if (percentage == m_reportedProgress) {
+        if (eta != m_reportedEta) {
+            m_reportedEta = eta;
+            m_model->setEta(ubuntuId, m_si->targetBuildNumber(), eta);
+        }
+        return;
+    }
+
+    m_pendingProgress = percentage;
+    m_pendingEta = eta;
+
+    qint64 elapsed = m_progressClock.isValid() ? m_progressClock.elapsed()
+                                               : m_progressInterval;
+    if (percentage >= 100 || elapsed >= m_progressInterval) {
+        flushProgress();
+    } else if (!m_progressTimer.isActive()) {
+        m_progressTimer.start(m_progressInterval - elapsed);
+    }
+}
+
+void ManagerImpl::flushProgress()
+{
+    m_progressTimer.stop();
+    if (m_pendingProgress < 0) {
+        return;
+    }
+
+    m_reportedProgress = m_pendingProgress;
+    m_reportedEta = m_pendingEta;
+    m_pendingProgress = -1;
+    m_progressClock.start();
+    m_model->setProgress(ubuntuId, m_si->targetBuildNumber(),
+                         m_reportedProgress, m_reportedEta);
+}
+
+void ManagerImpl::discardProgress()
+{
+    m_progressTimer.stop();
+    m_pendingProgress = -1;
+    m_reportedProgress = -1;
+    m_reportedEta = -1;
 }
 
 void ManagerImpl::handleUpdatePaused(const int &percentage)
 {
+    discardProgress();
     m_model->setProgress(ubuntuId, m_si->targetBuildNumber(), percentage);
     m_model->pauseUpdate(ubuntuId, m_si->targetBuildNumber());
 }
 
 void ManagerImpl::handleUpdateDownloaded()
 {
+    discardProgress();
     m_model->setDownloaded(ubuntuId, m_si->targetBuildNumber());
 }
 
 void ManagerImpl::handleUpdateFailed(const int &consecutiveFailureCount, const QString &lastReason)
 {
     Q_UNUSED(consecutiveFailureCount)
+    discardProgress();
     m_model->setError(ubuntuId, m_si->targetBuildNumber(), lastReason);
 }
 
@@ -23,6 +23,8 @@
 #include "systemimage.h"
 #include "updatemodel.h"
 
+#include <QElapsedTimer>
+#include <QTimer>
 #include <QtNetwork/QNetworkReply>
 #include <QtNetwork/QNetworkRequest>
 
@@ -42,6 +44,15 @@ public:
     virtual void check() override;
     virtual void cancel() override;
     virtual bool checkingForUpdates() const;
+
+    /* Set the minimum interval between download progress updates written
+     * to the model. Progress reported in between is coalesced, and repeats
+     * of the last percentage only update the ETA of the model, without a
+     * db write. 0 writes every change.
+     */
+    void setProgressInterval(const int &msecs);
+    int progressInterval() const;
+
     static const QString ubuntuId;
 private Q_SLOTS:
     void handleUpdateAvailableStatus(const bool isAvailable,
@@ -60,13 +71,25 @@ private Q_SLOTS:
     void handleUpdateProcessing();
     void handleUpdateProcessFailed(const QString &reason);
     void handleCheckingForUpdatesChanged();
+    void handleReady();
     void replyFinished(QNetworkReply *reply);
+    void flushProgress();
 private:
     void requestChangelog(const QString &id, const uint &rev);
+    // Drop progress not yet written, e.g. when the download has paused.
+    void discardProgress();
 
     UpdateModel *m_model;
     QSystemImage *m_si;
     QNetworkAccessManager *m_manager;
+
+    int m_progressInterval;
+    QElapsedTimer m_progressClock;
+    QTimer m_progressTimer;
+    int m_reportedProgress = -1;
+    double m_reportedEta = -1;
+    int m_pendingProgress = -1;
+    double m_pendingEta = -1;
 };
 } // Image
 } // UpdatePlugin
@@ -34,7 +34,10 @@ static QObject *siSingletonProvider(QQmlEngine *engine, QJSEngine *scriptEngine)
 {
     Q_UNUSED(engine)
     Q_UNUSED(scriptEngine)
-    return new QSystemImage;
+    // Shared with the other panels, so the engine must not delete it.
+    QSystemImage *si = QSystemImage::instance();
+    QQmlEngine::setObjectOwnership(si, QQmlEngine::CppOwnership);
+    return si;
 }
 
 static QObject *umSingletonProvider(QQmlEngine *engine, QJSEngine *scriptEngine)
@@ -57,5 +60,6 @@ void BackendPlugin::registerTypes(const char *uri)
         uri, 1, 0, "UpdateManager", umSingletonProvider
     );
     qRegisterMetaType<UpdateModel*>("UpdateModel*");
-    qRegisterMetaType<UpdateModelFilter*>("UpdateModelFilter*");
+    qRegisterMetaType<UpdateModelView*>("UpdateModelView*");
+    qRegisterMetaType<UpdateHistoryModel*>("UpdateHistoryModel*");
 }
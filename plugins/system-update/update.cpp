@@ -89,6 +89,11 @@ int Update::progress() const
     return m_progress;
 }
 
+double Update::eta() const
+{
+    return m_eta;
+}
+
 uint Update::revision() const
 {
     return m_revision;
@@ -244,6 +249,14 @@ void Update::setProgress(const int &progress)
     }
 }
 
+void Update::setEta(const double &eta)
+{
+    if (m_eta != eta) {
+        m_eta = eta;
+        Q_EMIT etaChanged();
+    }
+}
+
 void Update::setRevision(const uint &revision)
 {
     if (m_revision != revision) {
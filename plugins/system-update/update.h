@@ -55,6 +55,7 @@ class Update : public QObject
             WRITE setIdentifier NOTIFY identifierChanged)
     Q_PROPERTY(int progress READ progress
             WRITE setProgress NOTIFY progressChanged)
+    Q_PROPERTY(double eta READ eta WRITE setEta NOTIFY etaChanged)
     Q_PROPERTY(uint revision READ revision
             WRITE setRevision NOTIFY revisionChanged)
     Q_PROPERTY(State state READ state
@@ -127,6 +128,8 @@ public:
     QString iconUrl() const;
     bool installed() const;
     int progress() const;
+    // Estimated seconds left of a download, or < 0 if unknown. Not stored.
+    double eta() const;
     State state() const;
     QString signedDownloadUrl() const;
     QString title() const;
@@ -152,6 +155,7 @@ public:
     void setIconUrl(const QString &iconUrl);
     void setInstalled(const bool installed);
     void setProgress(const int &progress);
+    void setEta(const double &eta);
     void setState(const State &state);
     void setSignedDownloadUrl(const QString &signedDownloadUrl);
     void setTitle(const QString &title);
@@ -188,6 +192,7 @@ Q_SIGNALS:
     void downloadUrlChanged();
     void iconUrlChanged();
     void progressChanged();
+    void etaChanged();
     void stateChanged();
     void signedDownloadUrlChanged();
     void titleChanged();
@@ -213,6 +218,7 @@ protected:
     QString m_iconUrl = QString();
     bool m_installed = false;
     int m_progress = 0;
+    double m_eta = -1;
     State m_state = State::StateUnknown;
     QString m_signedDownloadUrl = QString();
     QString m_title = QString();
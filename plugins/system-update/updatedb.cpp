@@ -35,6 +35,38 @@ const QString ALL = "kind, id, local_version, remote_version, revision, \
 const QString GET_SINGLE = "SELECT " + ALL + " FROM updates WHERE id=:id \
     AND revision=:revision";
 const QString GET_ALL = "SELECT " + ALL + " FROM updates";
+const QString GET_HISTORY = "SELECT kind, id, remote_version, revision, \
+    installed, updated_at_utc, title, size, icon_url, package_name, \
+    update_state, (changelog IS NOT NULL AND changelog != '') AS has_changelog \
+    FROM updates WHERE installed=1 \
+    ORDER BY updated_at_utc DESC, id, revision LIMIT :limit OFFSET :offset";
+const QString GET_CHANGELOG = "SELECT changelog FROM updates WHERE id=:id \
+    AND revision=:revision";
+const QString REPLACE_WITH = "DELETE FROM updates WHERE id=:id AND \
+    revision < :revision AND installed=:installed";
+const QString INSERT = "INSERT OR REPLACE INTO updates (id, revision, \
+    installed, created_at_utc, download_hash, title, size, icon_url, \
+    download_url, changelog, command, token, download_id, progress, \
+    local_version, remote_version, kind, update_state, automatic, error, \
+    package_name, updated_at_utc, signed_download_url) \
+    VALUES (:id, :revision, :installed, :created_at_utc, :download_hash, \
+    :title, :size, :icon_url, :download_url, :changelog, :command, :token, \
+    :download_id, :progress, :local_version, :remote_version, :kind, \
+    :update_state, :automatic, :error, :package_name, :updated_at_utc, \
+    :signed_download_url)";
+const QString REMOVE = "DELETE FROM updates WHERE id=:id AND \
+    revision=:revision";
+}
+
+UpdateDb::Transaction::Transaction(UpdateDb *db)
+    : m_db(db)
+{
+    m_db->beginTransaction();
+}
+
+UpdateDb::Transaction::~Transaction()
+{
+    m_db->endTransaction();
 }
 
 UpdateDb::UpdateDb(QObject *parent)
@@ -122,6 +154,7 @@ bool UpdateDb::migrateDb()
 
 UpdateDb::~UpdateDb()
 {
+    m_statements.clear();
     m_db.close();
     m_db = QSqlDatabase();
     QSqlDatabase::removeDatabase(m_connectionName);
@@ -129,17 +162,16 @@ UpdateDb::~UpdateDb()
 
 void UpdateDb::add(const QSharedPointer<Update> &update)
 {
+    Transaction transaction(this);
     replaceWith(update);
     if (insert(update)) {
-        Q_EMIT changed();
+        notifyChanged();
     }
 }
 
 void UpdateDb::replaceWith(const QSharedPointer<Update> &update)
 {
-    QSqlQuery q(m_db);
-    q.prepare("DELETE FROM updates WHERE id=:id AND revision < :revision "
-              "AND installed=:installed");
+    QSqlQuery &q = statement(REPLACE_WITH);
     q.bindValue(":id", update->identifier());
     q.bindValue(":revision", update->revision());
     q.bindValue(":installed", false);
@@ -151,24 +183,18 @@ void UpdateDb::replaceWith(const QSharedPointer<Update> &update)
 void UpdateDb::update(const QSharedPointer<Update> &update)
 {
     if (insert(update)) {
-        Q_EMIT changed(update);
+        // Within a transaction, rows are announced together at the end.
+        if (inTransaction()) {
+            notifyChanged();
+        } else {
+            Q_EMIT changed(update);
+        }
     }
 }
 
 bool UpdateDb::insert(const QSharedPointer<Update> &update)
 {
-    QSqlQuery q(m_db);
-    q.prepare("INSERT OR REPLACE INTO updates (id, revision, installed,"
-              "created_at_utc, download_hash, title, size, icon_url,"
-              "download_url, changelog, command, token, download_id, progress,"
-              "local_version, remote_version, kind, update_state, automatic,"
-              "error, package_name, updated_at_utc, signed_download_url) "
-              "VALUES (:id, :revision, :installed, :created_at_utc,"
-              ":download_hash, :title, :size, :icon_url, :download_url,"
-              ":changelog, :command, :token, :download_id, :progress,"
-              ":local_version, :remote_version, :kind, :update_state,"
-              ":automatic, :error, :package_name, :updated_at_utc, "
-              ":signed_download_url)");
+    QSqlQuery &q = statement(INSERT);
     q.bindValue(":id", update->identifier());
     q.bindValue(":revision", update->revision());
     q.bindValue(":installed", update->installed());
@@ -206,14 +232,13 @@ bool UpdateDb::insert(const QSharedPointer<Update> &update)
 
 void UpdateDb::remove(const QSharedPointer<Update> &update)
 {
-    QSqlQuery q(m_db);
-    q.prepare("DELETE FROM updates WHERE id=:id AND revision=:revision");
+    QSqlQuery &q = statement(REMOVE);
     q.bindValue(":id", update->identifier());
     q.bindValue(":revision", update->revision());
     if (!q.exec()) {
         qCritical() << Q_FUNC_INFO << q.lastError().text();
     }
-    Q_EMIT changed();
+    notifyChanged();
 }
 
 void UpdateDb::update(const QSharedPointer<Update> &update, const QSqlQuery &query)
@@ -260,6 +285,9 @@ void UpdateDb::update(const QSharedPointer<Update> &update, const QSqlQuery &que
 
 bool UpdateDb::dropDb()
 {
+    // Statements prepared against the old tables are of no further use.
+    m_statements.clear();
+
     QSqlQuery q(m_db);
     if (!q.exec("DROP TABLE IF EXISTS meta")) {
         qCritical() << "failed to drop table meta" << m_db.lastError();
@@ -327,9 +355,73 @@ bool UpdateDb::openDb()
         qCritical() << Q_FUNC_INFO << m_db.lastError();
         return false;
     }
+
+    /* With a write-ahead log, readers don't block on writers and a commit
+    is a single append. NORMAL only syncs the log at checkpoints, which is
+    safe in WAL mode; a crash may lose the last transactions, not the db. */
+    QSqlQuery q(m_db);
+    if (!q.exec("PRAGMA journal_mode=WAL")) {
+        qWarning() << Q_FUNC_INFO << q.lastError().text();
+    }
+    if (!q.exec("PRAGMA synchronous=NORMAL")) {
+        qWarning() << Q_FUNC_INFO << q.lastError().text();
+    }
     return true;
 }
 
+QSqlQuery &UpdateDb::statement(const QString &sql)
+{
+    auto i = m_statements.find(sql);
+    if (i == m_statements.end()) {
+        QSqlQuery q(m_db);
+        q.setForwardOnly(true);
+        if (!q.prepare(sql)) {
+            qCritical() << Q_FUNC_INFO << q.lastError().text();
+        }
+        i = m_statements.insert(sql, q);
+    }
+    return i.value();
+}
+
+bool UpdateDb::inTransaction() const
+{
+    return m_transactionDepth > 0;
+}
+
+void UpdateDb::beginTransaction()
+{
+    if (m_transactionDepth++ > 0) {
+        return;
+    }
+    if (!m_db.transaction()) {
+        qWarning() << Q_FUNC_INFO << m_db.lastError().text();
+    }
+}
+
+void UpdateDb::endTransaction()
+{
+    if (--m_transactionDepth > 0) {
+        return;
+    }
+    if (!m_db.commit()) {
+        qCritical() << Q_FUNC_INFO << m_db.lastError().text();
+        m_db.rollback();
+    }
+    if (m_changedPending) {
+        m_changedPending = false;
+        Q_EMIT changed();
+    }
+}
+
+void UpdateDb::notifyChanged()
+{
+    if (inTransaction()) {
+        m_changedPending = true;
+    } else {
+        Q_EMIT changed();
+    }
+}
+
 QSqlDatabase UpdateDb::db()
 {
     return m_db;
@@ -384,8 +476,7 @@ void UpdateDb::setLastCheckDate(const QDateTime &lastCheck)
 QList<QSharedPointer<Update> > UpdateDb::updates()
 {
     QList<QSharedPointer<Update> > list;
-    QSqlQuery q(m_db);
-    q.prepare(GET_ALL);
+    QSqlQuery &q = statement(GET_ALL);
     if (!q.exec()) {
         qCritical() << Q_FUNC_INFO << q.lastError().text();
         return list;
@@ -395,24 +486,84 @@ QList<QSharedPointer<Update> > UpdateDb::updates()
         this->update(update, q);
         list.append(update);
     }
+    // Reset the statement so it doesn't hold a read transaction open.
+    q.finish();
     return list;
 }
 
+QList<UpdateDb::HistoryEntry> UpdateDb::history(const int &offset,
+                                                const int &limit)
+{
+    QList<HistoryEntry> list;
+    QSqlQuery &q = statement(GET_HISTORY);
+    q.bindValue(":limit", limit);
+    q.bindValue(":offset", offset);
+    if (!q.exec()) {
+        qCritical() << Q_FUNC_INFO << q.lastError().text();
+        return list;
+    }
+    while (q.next()) {
+        auto update = QSharedPointer<Update>(new Update);
+        update->setKind(Update::stringToKind(q.value("kind").toString()));
+        update->setIdentifier(q.value("id").toString());
+        update->setRemoteVersion(q.value("remote_version").toString());
+        update->setRevision(q.value("revision").toUInt());
+        update->setInstalled(q.value("installed").toBool());
+        update->setState(Update::stringToState(
+            q.value("update_state").toString()
+        ));
+
+        qlonglong updatedAt(q.value("updated_at_utc").toLongLong());
+        if (updatedAt > 0) {
+            update->setUpdatedAt(
+                QDateTime::fromMSecsSinceEpoch(updatedAt).toUTC()
+            );
+        }
+
+        update->setTitle(q.value("title").toString());
+        update->setBinaryFilesize(q.value("size").toUInt());
+        update->setIconUrl(q.value("icon_url").toString());
+        update->setPackageName(q.value("package_name").toString());
+
+        HistoryEntry entry;
+        entry.update = update;
+        entry.hasChangelog = q.value("has_changelog").toBool();
+        list.append(entry);
+    }
+    q.finish();
+    return list;
+}
+
+QString UpdateDb::changelog(const QString &id, const uint &revision)
+{
+    QString changelog;
+    QSqlQuery &q = statement(GET_CHANGELOG);
+    q.bindValue(":id", id);
+    q.bindValue(":revision", revision);
+    if (!q.exec()) {
+        qCritical() << Q_FUNC_INFO << q.lastError().text();
+    }
+    if (q.next()) {
+        changelog = q.value(0).toString();
+    }
+    q.finish();
+    return changelog;
+}
+
 QSharedPointer<Update> UpdateDb::get(const QString &id, const uint &revision)
 {
-    QSqlQuery q(m_db);
-    q.prepare(GET_SINGLE);
+    QSqlQuery &q = statement(GET_SINGLE);
     q.bindValue(":id", id);
     q.bindValue(":revision", revision);
     if (!q.exec()) {
         qCritical() << Q_FUNC_INFO << q.lastError().text();
     }
+    QSharedPointer<Update> update(nullptr);
     if (q.next()) {
-        auto update = QSharedPointer<Update>(new Update);
+        update = QSharedPointer<Update>(new Update);
         this->update(update, q);
-        return update;
-    } else {
-        return QSharedPointer<Update>(nullptr);
     }
+    q.finish();
+    return update;
 }
 } // UpdatePlugin
@@ -21,10 +21,12 @@
 
 #include "update.h"
 
+#include <QHash>
 #include <QObject>
 #include <QSharedPointer>
 #include <QString>
 #include <QSqlDatabase>
+#include <QSqlQuery>
 
 namespace UpdatePlugin
 {
@@ -32,6 +34,34 @@ class UpdateDb : public QObject
 {
     Q_OBJECT
 public:
+    /* Groups writes into a single SQLite transaction for as long as it is in
+     * scope, and emits changed() once at the end rather than changed() or
+     * changed(update) once per row.
+     * Transactions nest; only the outermost one commits.
+     *
+     *     {
+     *         UpdateDb::Transaction transaction(db);
+     *         Q_FOREACH(auto update, updates)
+     *             db->update(update);
+     *     } // commit
+     */
+    class Transaction
+    {
+    public:
+        explicit Transaction(UpdateDb *db);
+        ~Transaction();
+    private:
+        Q_DISABLE_COPY(Transaction)
+        UpdateDb *m_db;
+    };
+
+    // An installed Update as listed in the history, without its changelog.
+    struct HistoryEntry
+    {
+        QSharedPointer<Update> update;
+        bool hasChangelog;
+    };
+
     explicit UpdateDb(QObject *parent = nullptr);
     ~UpdateDb();
     explicit UpdateDb(const QString &dbpath, QObject *parent = nullptr);
@@ -40,6 +70,15 @@ public:
     void remove(const QSharedPointer<Update> &update);
     QSharedPointer<Update> get(const QString &id, const uint &revision);
     QList<QSharedPointer<Update> > updates();
+
+    /* Return up to limit installed Updates, most recently updated first,
+     * skipping the first offset.
+     *
+     * Only the columns shown in the history are read; changelogs are left
+     * out and can be read with changelog().
+     */
+    QList<HistoryEntry> history(const int &offset, const int &limit);
+    QString changelog(const QString &id, const uint &revision);
     QDateTime lastCheckDate();
     void setLastCheckDate(const QDateTime &lastCheck);
     QSqlDatabase db();
@@ -51,6 +90,8 @@ public:
      */
     void pruneDb();
     void reset();
+    // Whether a Transaction is currently in scope.
+    bool inTransaction() const;
     const uint SCHEMA_VERSION = 1;
 Q_SIGNALS:
     // This signal is emitted when multiple rows changed.
@@ -68,9 +109,18 @@ private:
     bool openDb();
     // Removes any updates that precede update and are not installed.
     void replaceWith(const QSharedPointer<Update> &update);
+    // Returns a prepared statement for sql, preparing it on first use.
+    QSqlQuery &statement(const QString &sql);
+    void beginTransaction();
+    void endTransaction();
+    // Emits changed(), or defers it until the transaction ends.
+    void notifyChanged();
     QSqlDatabase m_db;
     QString m_dbpath;
     QString m_connectionName;
+    QHash<QString, QSqlQuery> m_statements;
+    int m_transactionDepth = 0;
+    bool m_changedPending = false;
 };
 } // UpdatePlugin
 
@@ -0,0 +1,142 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "updatehistorymodel.h"
+
+namespace UpdatePlugin
+{
+UpdateHistoryModel::UpdateHistoryModel(UpdateModel *model,
+                                       const int &pageSize)
+    : QAbstractListModel(model)
+    , m_model(model)
+    , m_db(model->db())
+    , m_pageSize(pageSize)
+{
+    connect(m_db, SIGNAL(changed()), this, SLOT(refresh()));
+    connect(m_db, SIGNAL(changed(const QSharedPointer<Update>&)),
+            this, SLOT(handleChanged(const QSharedPointer<Update>&)));
+
+    fetchMore(QModelIndex());
+}
+
+QVariant UpdateHistoryModel::data(const QModelIndex &index, int role) const
+{
+    int row = index.row();
+
+    if (row < 0 || row > (m_rows.length() - 1))
+        return QVariant();
+
+    const UpdateDb::HistoryEntry &entry = m_rows.at(row);
+    if (role == HasChangelogRole) {
+        return entry.hasChangelog;
+    }
+    return UpdateModel::roleData(entry.update, role);
+}
+
+QHash<int, QByteArray> UpdateHistoryModel::roleNames() const
+{
+    QHash<int, QByteArray> names = m_model->roleNames();
+    names[HasChangelogRole] = "hasChangelog";
+    return names;
+}
+
+int UpdateHistoryModel::rowCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent)
+    return m_rows.size();
+}
+
+bool UpdateHistoryModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && m_more;
+}
+
+void UpdateHistoryModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent)) {
+        return;
+    }
+
+    auto page = m_db->history(m_rows.size(), m_pageSize);
+    m_more = page.size() == m_pageSize;
+    if (page.isEmpty()) {
+        return;
+    }
+
+    beginInsertRows(QModelIndex(), m_rows.size(),
+                    m_rows.size() + page.size() - 1);
+    m_rows.append(page);
+    endInsertRows();
+
+    Q_EMIT countChanged();
+}
+
+void UpdateHistoryModel::loadMore()
+{
+    fetchMore(QModelIndex());
+}
+
+void UpdateHistoryModel::fetchChangelog(const int &row)
+{
+    if (row < 0 || row > (m_rows.length() - 1))
+        return;
+
+    auto update = m_rows.at(row).update;
+    if (!m_rows.at(row).hasChangelog || !update->changelog().isEmpty()) {
+        return;
+    }
+
+    update->setChangelog(
+        m_db->changelog(update->identifier(), update->revision())
+    );
+
+    QModelIndex qmi = index(row, 0);
+    Q_EMIT dataChanged(qmi, qmi, QVector<int>() << UpdateModel::ChangelogRole);
+}
+
+void UpdateHistoryModel::refresh()
+{
+    const int oldCount = m_rows.size();
+    const int limit = qMax(oldCount, m_pageSize);
+
+    beginResetModel();
+    m_rows = m_db->history(0, limit);
+    m_more = m_rows.size() == limit;
+    endResetModel();
+
+    if (m_rows.size() != oldCount) {
+        Q_EMIT countChanged();
+    }
+}
+
+void UpdateHistoryModel::handleChanged(const QSharedPointer<Update> &update)
+{
+    /* Most single row changes are progress on pending updates, which are
+    of no concern to the history. */
+    if (update->installed()) {
+        refresh();
+        return;
+    }
+    Q_FOREACH(const UpdateDb::HistoryEntry &entry, m_rows) {
+        if (*entry.update == *update) {
+            refresh();
+            return;
+        }
+    }
+}
+} // UpdatePlugin
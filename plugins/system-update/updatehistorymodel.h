@@ -0,0 +1,74 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPDATE_HISTORY_MODEL_H
+#define UPDATE_HISTORY_MODEL_H
+
+#include "updatedb.h"
+#include "updatemodel.h"
+
+#include <QAbstractListModel>
+#include <QModelIndex>
+
+namespace UpdatePlugin
+{
+/* Installed Updates, most recently updated first.
+ *
+ * Rows are read from the db a page at a time, as the view asks for them,
+ * and only with the columns the history list shows. A changelog is read when
+ * fetchChangelog() is called for its row, i.e. when it is expanded.
+ */
+class UpdateHistoryModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+public:
+    enum Roles
+    {
+      HasChangelogRole = UpdateModel::LastRole + 1
+    };
+
+    explicit UpdateHistoryModel(UpdateModel *model, const int &pageSize = 20);
+    ~UpdateHistoryModel() {};
+
+    QVariant data(const QModelIndex &index, int role) const Q_DECL_OVERRIDE;
+    QHash<int, QByteArray> roleNames() const Q_DECL_OVERRIDE;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    bool canFetchMore(const QModelIndex &parent) const Q_DECL_OVERRIDE;
+    void fetchMore(const QModelIndex &parent) Q_DECL_OVERRIDE;
+
+    // For views that don't fetch by themselves, e.g. a Repeater.
+    Q_INVOKABLE void loadMore();
+    Q_INVOKABLE void fetchChangelog(const int &row);
+public Q_SLOTS:
+    // Re-read the rows loaded so far.
+    void refresh();
+Q_SIGNALS:
+    void countChanged();
+private Q_SLOTS:
+    void handleChanged(const QSharedPointer<Update> &update);
+private:
+    UpdateModel *m_model;
+    UpdateDb *m_db;
+    int m_pageSize;
+    bool m_more = true;
+    QList<UpdateDb::HistoryEntry> m_rows;
+};
+} // UpdatePlugin
+
+#endif // UPDATE_HISTORY_MODEL_H
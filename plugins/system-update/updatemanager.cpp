@@ -53,16 +53,6 @@ UpdateManager::UpdateManager(UpdateModel *model,
 void UpdateManager::init()
 {
     m_model->db()->pruneDb();
-    m_pending.setSourceModel(m_model);
-    m_pending.filterOnInstalled(false);
-    m_clicks.setSourceModel(m_model);
-    m_clicks.filterOnKind((uint) Update::Kind::KindClick);
-    m_clicks.filterOnInstalled(false);
-    m_images.setSourceModel(m_model);
-    m_images.filterOnKind((uint) Update::Kind::KindImage);
-    m_images.filterOnInstalled(false);
-    m_installed.setSourceModel(m_model);
-    m_installed.filterOnInstalled(true);
 
     connect(m_clickManager, SIGNAL(checkingForUpdatesChanged()),
             this, SLOT(calculateStatus()));
@@ -84,30 +74,30 @@ UpdateModel* UpdateManager::updates()
     return m_model;
 }
 
-UpdateModelFilter* UpdateManager::pendingUpdates()
+UpdateModelView* UpdateManager::pendingUpdates()
 {
-    auto ret = &m_pending;
+    auto ret = m_model->pending();
     QQmlEngine::setObjectOwnership(ret, QQmlEngine::CppOwnership);
     return ret;
 }
 
-UpdateModelFilter* UpdateManager::clickUpdates()
+UpdateModelView* UpdateManager::clickUpdates()
 {
-    auto ret = &m_clicks;
+    auto ret = m_model->clicks();
     QQmlEngine::setObjectOwnership(ret, QQmlEngine::CppOwnership);
     return ret;
 }
 
-UpdateModelFilter* UpdateManager::imageUpdates()
+UpdateModelView* UpdateManager::imageUpdates()
 {
-    auto ret = &m_images;
+    auto ret = m_model->images();
     QQmlEngine::setObjectOwnership(ret, QQmlEngine::CppOwnership);
     return ret;
 }
 
-UpdateModelFilter* UpdateManager::installedUpdates()
+UpdateHistoryModel* UpdateManager::installedUpdates()
 {
-    auto ret = &m_installed;
+    auto ret = m_model->installed();
     QQmlEngine::setObjectOwnership(ret, QQmlEngine::CppOwnership);
     return ret;
 }
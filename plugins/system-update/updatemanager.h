@@ -18,6 +18,7 @@
 #ifndef UPDATE_MANAGER_H
 #define UPDATE_MANAGER_H
 
+#include "updatehistorymodel.h"
 #include "updatemodel.h"
 #include "click/manager.h"
 #include "image/imagemanager.h"
@@ -32,10 +33,10 @@ class UpdateManager : public QObject
     Q_OBJECT
     Q_ENUMS(Status Check)
     Q_PROPERTY(UpdateModel* model READ updates CONSTANT)
-    Q_PROPERTY(UpdateModelFilter* pendingUpdates READ pendingUpdates CONSTANT)
-    Q_PROPERTY(UpdateModelFilter* clickUpdates READ clickUpdates CONSTANT)
-    Q_PROPERTY(UpdateModelFilter* imageUpdates READ imageUpdates CONSTANT)
-    Q_PROPERTY(UpdateModelFilter* installedUpdates
+    Q_PROPERTY(UpdateModelView* pendingUpdates READ pendingUpdates CONSTANT)
+    Q_PROPERTY(UpdateModelView* clickUpdates READ clickUpdates CONSTANT)
+    Q_PROPERTY(UpdateModelView* imageUpdates READ imageUpdates CONSTANT)
+    Q_PROPERTY(UpdateHistoryModel* installedUpdates
                READ installedUpdates CONSTANT)
     Q_PROPERTY(Status status READ status NOTIFY statusChanged)
 public:
@@ -68,10 +69,10 @@ public:
     };
 
     UpdateModel* updates();
-    UpdateModelFilter* pendingUpdates();
-    UpdateModelFilter* clickUpdates();
-    UpdateModelFilter* imageUpdates();
-    UpdateModelFilter* installedUpdates();
+    UpdateModelView* pendingUpdates();
+    UpdateModelView* clickUpdates();
+    UpdateModelView* imageUpdates();
+    UpdateHistoryModel* installedUpdates();
     Status status() const;
 
     Q_INVOKABLE void check(const Check check = Check::CheckIfNecessary);
@@ -104,10 +105,6 @@ private:
     void init();
 
     Network::Manager *m_nam;
-    UpdateModelFilter m_pending;
-    UpdateModelFilter m_clicks;
-    UpdateModelFilter m_images;
-    UpdateModelFilter m_installed;
     Image::Manager *m_imageManager;
     Click::Manager *m_clickManager;
 };
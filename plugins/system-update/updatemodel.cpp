@@ -17,8 +17,11 @@
  */
 
 #include "updatemodel.h"
+#include "updatehistorymodel.h"
 #include <QDebug>
 
+#include <algorithm>
+
 namespace UpdatePlugin
 {
 UpdateModel::UpdateModel(QObject *parent)
@@ -37,6 +40,20 @@ UpdateModel::UpdateModel(const QString &dbpath, QObject *parent)
 
 void UpdateModel::initialize()
 {
+    m_pending = new UpdateModelView(this, TitleRole, Qt::AscendingOrder);
+    m_clicks = new UpdateModelView(this, TitleRole, Qt::AscendingOrder);
+    m_images = new UpdateModelView(this, TitleRole, Qt::AscendingOrder);
+    m_installed = new UpdateHistoryModel(this);
+
+    QList<Update::Kind> kinds;
+    kinds << Update::Kind::KindUnknown << Update::Kind::KindClick
+          << Update::Kind::KindImage;
+    Q_FOREACH(const Update::Kind &kind, kinds) {
+        subscribe(m_pending, kind, false);
+    }
+    subscribe(m_clicks, Update::Kind::KindClick, false);
+    subscribe(m_images, Update::Kind::KindImage, false);
+
     connect(m_db, SIGNAL(changed()), this, SLOT(refresh()));
     connect(m_db, SIGNAL(changed(const QSharedPointer<Update>&)),
             this, SLOT(refresh(const QSharedPointer<Update>&)));
@@ -73,6 +90,7 @@ QHash<int, QByteArray> UpdateModel::roleNames() const
         names[ErrorRole] = "error";
         names[PackageNameRole] = "packageName";
         names[SignedDownloadUrlRole] = "signedDownloadUrl";
+        names[EtaRole] = "eta";
     }
 
     return names;
@@ -90,8 +108,12 @@ QVariant UpdateModel::data(const QModelIndex &index, int role) const
     if (row < 0 || row > (m_updates.length() - 1))
         return QVariant();
 
-    auto update = m_updates.at(row);
+    return roleData(m_updates.at(row), role);
+}
 
+QVariant UpdateModel::roleData(const QSharedPointer<Update> &update,
+                               const int &role)
+{
     switch (role) {
     case Qt::DisplayRole:
     case KindRole:
@@ -140,6 +162,8 @@ QVariant UpdateModel::data(const QModelIndex &index, int role) const
         return update->packageName();
     case SignedDownloadUrlRole:
         return update->signedDownloadUrl();
+    case EtaRole:
+        return update->eta();
     }
     return QVariant();
 }
@@ -150,13 +174,39 @@ int UpdateModel::rowCount(const QModelIndex &parent) const
     return m_updates.size();
 }
 
+UpdateModelView* UpdateModel::pending()
+{
+    return m_pending;
+}
+
+UpdateModelView* UpdateModel::clicks()
+{
+    return m_clicks;
+}
+
+UpdateModelView* UpdateModel::images()
+{
+    return m_images;
+}
+
+UpdateHistoryModel* UpdateModel::installed()
+{
+    return m_installed;
+}
+
 void UpdateModel::clear()
 {
     beginResetModel();
     m_updates.clear();
     endResetModel();
 
+    m_buckets.clear();
+    m_pending->clear();
+    m_clicks->clear();
+    m_images->clear();
+
     refresh();
+    m_installed->refresh();
 }
 
 void UpdateModel::reset()
@@ -171,6 +221,7 @@ void UpdateModel::refresh(const QSharedPointer<Update> &update)
     if (ix >= 0 && ix < m_updates.size()) {
         m_updates.replace(ix, update);
         emitRowChanged(ix);
+        addToIndex(update);
     }
 }
 
@@ -200,13 +251,20 @@ void UpdateModel::refresh()
 
         int oldPos = UpdateModel::indexOf(m_updates, item);
         if (UpdateModel::contains(m_updates, item)) {
-            if (oldPos == i) {
-                if (!m_updates.at(oldPos)->deepEquals(item.data())) {
-                    emitRowChanged(i);
-                }
-            } else {
+            if (oldPos != i) {
                 moveRow(oldPos, i);
             }
+            /* Keep the fresh copy, since rows changed in a transaction are
+            only announced through this refresh. */
+            if (!m_updates.at(i)->deepEquals(item.data())) {
+                // The ETA isn't stored, so the fresh copy doesn't have it.
+                if (item->eta() < 0) {
+                    item->setEta(m_updates.at(i)->eta());
+                }
+                m_updates.replace(i, item);
+                emitRowChanged(i);
+                addToIndex(item);
+            }
         } else {
             insertRow(i, item);
         }
@@ -225,11 +283,14 @@ void UpdateModel::insertRow(const int &row, const QSharedPointer<Update> &update
     m_updates.append(update);
     m_updates.move(m_updates.size() - 1, row);
     endInsertRows();
+
+    addToIndex(update);
 }
 
 void UpdateModel::removeRow(int row)
 {
     if (0 <= row && row < m_updates.size()) {
+        removeFromIndex(m_updates.at(row));
         beginRemoveRows(QModelIndex(), row, row);
         m_updates.removeAt(row);
         endRemoveRows();
@@ -274,6 +335,60 @@ int UpdateModel::indexOf(const UpdateList &list,
     return -1;
 }
 
+int UpdateModel::bucket(const Update::Kind &kind, const bool installed)
+{
+    // Kinds are bit flags, so leave room for the installed bit.
+    return ((int) kind << 1) | (installed ? 1 : 0);
+}
+
+int UpdateModel::bucket(const QSharedPointer<Update> &update)
+{
+    return bucket(update->kind(), update->installed());
+}
+
+QString UpdateModel::indexKey(const QSharedPointer<Update> &update)
+{
+    return update->identifier() + '\n' + QString::number(update->revision());
+}
+
+void UpdateModel::subscribe(UpdateModelView *view, const Update::Kind &kind,
+                            const bool installed)
+{
+    m_bucketViews[bucket(kind, installed)] << view;
+}
+
+void UpdateModel::addToIndex(const QSharedPointer<Update> &update)
+{
+    const QString key = indexKey(update);
+    const int newBucket = bucket(update);
+    const QList<UpdateModelView*> oldViews = m_bucketViews.value(
+        m_buckets.value(key, 0)
+    );
+    const QList<UpdateModelView*> newViews = m_bucketViews.value(newBucket);
+
+    Q_FOREACH(UpdateModelView *view, oldViews) {
+        if (!newViews.contains(view)) {
+            view->remove(key);
+        }
+    }
+    Q_FOREACH(UpdateModelView *view, newViews) {
+        if (oldViews.contains(view)) {
+            view->change(key, update);
+        } else {
+            view->insert(key, update);
+        }
+    }
+    m_buckets.insert(key, newBucket);
+}
+
+void UpdateModel::removeFromIndex(const QSharedPointer<Update> &update)
+{
+    const QString key = indexKey(update);
+    Q_FOREACH(UpdateModelView *view, m_bucketViews.value(m_buckets.take(key))) {
+        view->remove(key);
+    }
+}
+
 QSharedPointer<Update> UpdateModel::get(const QString &id, const uint &revision)
 {
     return find(id, revision);
@@ -296,6 +411,11 @@ QSharedPointer<Update> UpdateModel::find(const QString &id, const uint &revision
             return update;
         }
     }
+    /* Rows added during a transaction only reach m_updates when it ends,
+    so look them up in the db instead. */
+    if (m_db->inTransaction()) {
+        return m_db->get(id, revision);
+    }
     return QSharedPointer<Update>(nullptr);
 }
 
@@ -453,17 +573,34 @@ void UpdateModel::setDownloaded(const QString &id, const uint &rev)
 }
 
 void UpdateModel::setProgress(const QString &id, const uint &rev,
-                              const int &progress)
+                              const int &progress, const double &eta)
 {
     auto update = find(id, rev);
     if (!update.isNull()) {
         update->setError("");
         update->setState(Update::State::StateDownloading);
         update->setProgress(progress);
+        update->setEta(eta);
         m_db->update(update);
     }
 }
 
+void UpdateModel::setEta(const QString &id, const uint &rev,
+                         const double &eta)
+{
+    auto update = find(id, rev);
+    if (update.isNull() || update->eta() == eta) {
+        return;
+    }
+    update->setEta(eta);
+
+    int row = UpdateModel::indexOf(m_updates, update);
+    if (0 <= row && row < m_updates.size()) {
+        QModelIndex qmi = index(row, 0);
+        Q_EMIT(dataChanged(qmi, qmi, QVector<int>() << EtaRole));
+    }
+}
+
 void UpdateModel::setInstalling(const QString &id, const uint &rev,
                                 const int &progress)
 {
@@ -544,68 +681,174 @@ void UpdateModel::setImageUpdate(const QString &id, const int &version,
     m_db->add(update);
 }
 
-uint UpdateModelFilter::kindFilter() const
+UpdateModelView::UpdateModelView(UpdateModel *model, const int &sortRole,
+                                 const Qt::SortOrder &sortOrder)
+    : QAbstractListModel(model)
+    , m_model(model)
+    , m_sortRole(sortRole)
+    , m_sortOrder(sortOrder)
+{
+}
+
+QVariant UpdateModelView::data(const QModelIndex &index, int role) const
+{
+    int row = index.row();
+
+    if (row < 0 || row > (m_rows.length() - 1))
+        return QVariant();
+
+    return UpdateModel::roleData(m_rows.at(row).update, role);
+}
+
+QHash<int, QByteArray> UpdateModelView::roleNames() const
+{
+    return m_model->roleNames();
+}
+
+int UpdateModelView::rowCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent)
+    return m_rows.size();
+}
+
+int UpdateModelView::sortRole() const
+{
+    return m_sortRole;
+}
+
+Qt::SortOrder UpdateModelView::sortOrder() const
+{
+    return m_sortOrder;
+}
+
+void UpdateModelView::insert(const QString &key,
+                             const QSharedPointer<Update> &update)
+{
+    if (m_sortKeys.contains(key)) {
+        change(key, update);
+        return;
+    }
+
+    Row row;
+    row.key = key;
+    row.sortKey = UpdateModel::roleData(update, m_sortRole);
+    row.update = update;
+
+    int pos = position(row);
+    beginInsertRows(QModelIndex(), pos, pos);
+    m_rows.insert(pos, row);
+    m_sortKeys.insert(key, row.sortKey);
+    endInsertRows();
+
+    Q_EMIT countChanged();
+}
+
+void UpdateModelView::change(const QString &key,
+                             const QSharedPointer<Update> &update)
 {
-    return (uint) m_kind;
+    int from = find(key);
+    if (from < 0) {
+        insert(key, update);
+        return;
+    }
+
+    Row row;
+    row.key = key;
+    row.sortKey = UpdateModel::roleData(update, m_sortRole);
+    row.update = update;
+
+    /* The rows are still sorted by their old keys, so the new position can
+    be searched for before moving. Positions next to the row itself mean it
+    stays put. */
+    int to = from;
+    if (row.sortKey != m_rows.at(from).sortKey) {
+        int pos = position(row);
+        if (pos < from || pos > from + 1) {
+            beginMoveRows(QModelIndex(), from, from, QModelIndex(), pos);
+            to = pos > from ? pos - 1 : pos;
+            m_rows.move(from, to);
+            endMoveRows();
+        }
+    }
+
+    m_rows.replace(to, row);
+    m_sortKeys.insert(key, row.sortKey);
+
+    QModelIndex qmi = index(to, 0);
+    Q_EMIT dataChanged(qmi, qmi);
 }
 
-void UpdateModelFilter::filterOnKind(const uint &kind)
+void UpdateModelView::remove(const QString &key)
 {
-    Update::Kind _kind = (Update::Kind) kind;
-    if (_kind != m_kind) {
-        m_kind = _kind;
-        Q_EMIT kindFilterChanged();
+    int row = find(key);
+    if (row < 0) {
+        return;
     }
-    m_kindEnabled = true;
-    invalidate();
+
+    beginRemoveRows(QModelIndex(), row, row);
+    m_rows.removeAt(row);
+    m_sortKeys.remove(key);
+    endRemoveRows();
+
+    Q_EMIT countChanged();
 }
 
-bool UpdateModelFilter::installed() const
+void UpdateModelView::clear()
 {
-    return m_installed;
+    if (m_rows.isEmpty()) {
+        return;
+    }
+
+    beginResetModel();
+    m_rows.clear();
+    m_sortKeys.clear();
+    endResetModel();
+
+    Q_EMIT countChanged();
 }
 
-void UpdateModelFilter::filterOnInstalled(const bool installed)
+int UpdateModelView::find(const QString &key) const
 {
-    if (installed != m_installed) {
-        m_installed = installed;
-        Q_EMIT installedChanged();
+    if (!m_sortKeys.contains(key)) {
+        return -1;
     }
 
-    m_installedEnabled = true;
-    invalidateFilter();
+    Row probe;
+    probe.key = key;
+    probe.sortKey = m_sortKeys.value(key);
 
-    if (installed) {
-        // Installed updates are sorted date (most recent first).
-        setSortRole(UpdateModel::UpdatedAtRole);
-        sort(0, Qt::DescendingOrder);
-    } else {
-        // Pending updates are sorted by title, a-z.
-        setSortRole(UpdateModel::TitleRole);
-        sort(0, Qt::AscendingOrder);
+    int pos = position(probe);
+    if (pos < m_rows.size() && m_rows.at(pos).key == key) {
+        return pos;
     }
+    return -1;
 }
 
-bool UpdateModelFilter::filterAcceptsRow(int sourceRow,
-                                         const QModelIndex &sourceParent) const
+int UpdateModelView::position(const Row &row) const
 {
-    bool accepts = true;
-    QModelIndex childIndex = sourceModel()->index(sourceRow, 0, sourceParent);
+    auto it = std::lower_bound(
+        m_rows.constBegin(), m_rows.constEnd(), row,
+        [this](const Row &a, const Row &b) { return lessThan(a, b); }
+    );
+    return it - m_rows.constBegin();
+}
 
-    if (accepts && m_installedEnabled) {
-        const bool installed = childIndex.model()->data(
-            childIndex, UpdateModel::InstalledRole
-        ).toBool();
-        accepts = installed == m_installed;
+bool UpdateModelView::lessThan(const Row &a, const Row &b) const
+{
+    int cmp;
+    if (a.sortKey.type() == QVariant::DateTime) {
+        const QDateTime left = a.sortKey.toDateTime();
+        const QDateTime right = b.sortKey.toDateTime();
+        cmp = left < right ? -1 : (right < left ? 1 : 0);
+    } else {
+        cmp = QString::compare(a.sortKey.toString(), b.sortKey.toString());
     }
 
-    if (accepts && m_kindEnabled) {
-        const Update::Kind kind = (Update::Kind) childIndex.model()->data(
-            childIndex, UpdateModel::KindRole
-        ).toUInt();
-        accepts = m_kind == kind;
+    if (m_sortOrder == Qt::DescendingOrder) {
+        cmp = -cmp;
     }
 
-    return accepts;
+    // Rows with equal sort keys keep a stable order.
+    return cmp == 0 ? a.key < b.key : cmp < 0;
 }
 } // UpdatePlugin
@@ -23,13 +23,16 @@
 #include "updatedb.h"
 
 #include <QAbstractListModel>
+#include <QHash>
 #include <QModelIndex>
-#include <QSortFilterProxyModel>
 
 namespace UpdatePlugin
 {
 typedef QList<QSharedPointer<Update>> UpdateList;
 
+class UpdateModelView;
+class UpdateHistoryModel;
+
 class UpdateModel : public QAbstractListModel
 {
     Q_OBJECT
@@ -60,7 +63,8 @@ public:
       ErrorRole,
       PackageNameRole,
       SignedDownloadUrlRole,
-      LastRole = SignedDownloadUrlRole
+      EtaRole,
+      LastRole = EtaRole
     };
 
     explicit UpdateModel(QObject *parent = nullptr);
@@ -72,6 +76,22 @@ public:
     QVariant data(const QModelIndex &index, int role) const Q_DECL_OVERRIDE;
     QHash<int, QByteArray> roleNames() const Q_DECL_OVERRIDE;
     int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+
+    // Return the value of role for update.
+    static QVariant roleData(const QSharedPointer<Update> &update,
+                             const int &role);
+
+    /* Views over the rows of this model.
+     *
+     * Pending views hold updates not yet installed, sorted by title.
+     */
+    UpdateModelView* pending();
+    UpdateModelView* clicks();
+    UpdateModelView* images();
+
+    // Installed updates, paged in from the db.
+    UpdateHistoryModel* installed();
+
     void add(const QSharedPointer<Update> &update);
 
     /* Update an Update.
@@ -95,8 +115,12 @@ public:
     Q_INVOKABLE void setInstalled(const QString &id, const uint &rev);
     Q_INVOKABLE void setError(const QString &id, const uint &rev,
                               const QString &msg);
+    // An eta (in seconds) below 0 means unknown.
     Q_INVOKABLE void setProgress(const QString &id, const uint &rev,
-                     const int &progress);
+                     const int &progress, const double &eta = -1);
+    // Like the eta of setProgress(), which isn't stored; no db write.
+    Q_INVOKABLE void setEta(const QString &id, const uint &rev,
+                            const double &eta);
     Q_INVOKABLE void setDownloaded(const QString &id, const uint &rev);
     Q_INVOKABLE void setInstalling(const QString &id, const uint &rev,
                                    const int &progress = 0);
@@ -134,45 +158,72 @@ private:
     QSharedPointer<Update> find(const QString &id, const QString &version);
     static int indexOf(const UpdateList &list,
                        const QSharedPointer<Update> &update);
+
+    /* Buckets group rows by kind and installed state. Each view subscribes
+     * to the buckets it shows, and is told when a row enters, leaves or
+     * changes within them. */
+    static int bucket(const Update::Kind &kind, const bool installed);
+    static int bucket(const QSharedPointer<Update> &update);
+    static QString indexKey(const QSharedPointer<Update> &update);
+    void subscribe(UpdateModelView *view, const Update::Kind &kind,
+                   const bool installed);
+    void addToIndex(const QSharedPointer<Update> &update);
+    void removeFromIndex(const QSharedPointer<Update> &update);
+
     UpdateDb* m_db;
     UpdateList m_updates;
+    UpdateModelView *m_pending = nullptr;
+    UpdateModelView *m_clicks = nullptr;
+    UpdateModelView *m_images = nullptr;
+    UpdateHistoryModel *m_installed = nullptr;
+    QHash<int, QList<UpdateModelView*>> m_bucketViews;
+    // The bucket each row was last indexed in.
+    QHash<QString, int> m_buckets;
 };
 
-class UpdateModelFilter : public QSortFilterProxyModel
+/* A sorted view over some of the buckets of an UpdateModel.
+ *
+ * Rows are inserted, moved and removed by the UpdateModel as they enter or
+ * leave the view's buckets, so the view never filters the whole model.
+ */
+class UpdateModelView : public QAbstractListModel
 {
     Q_OBJECT
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
 public:
-    explicit UpdateModelFilter(QObject *parent = nullptr)
-        : QSortFilterProxyModel(parent) {};
+    explicit UpdateModelView(UpdateModel *model, const int &sortRole,
+                             const Qt::SortOrder &sortOrder);
+    ~UpdateModelView() {};
 
-    /* Return the Kind filter currently installed.
-     *
-     * Note that this filter is disabled by default.
-     */
-    uint kindFilter() const;
-    void filterOnKind(const uint &kind);
-
-    /* Return the install filter.
-     *
-     * true means installed, false means not installed (pending).
-     * Note that this filter is disabled by default.
-     */
-    bool installed() const;
-    void filterOnInstalled(const bool installed);
+    QVariant data(const QModelIndex &index, int role) const Q_DECL_OVERRIDE;
+    QHash<int, QByteArray> roleNames() const Q_DECL_OVERRIDE;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    int sortRole() const;
+    Qt::SortOrder sortOrder() const;
 Q_SIGNALS:
-    void kindFilterChanged();
-    void installedChanged();
     void countChanged();
-    void sortRoleChanged();
-protected:
-    virtual bool filterAcceptsRow(
-        int sourceRow, const QModelIndex &sourceParent
-    ) const override;
 private:
-    Update::Kind m_kind = Update::Kind::KindUnknown;
-    bool m_kindEnabled = false;
-    bool m_installed = false;
-    bool m_installedEnabled = false;
+    friend class UpdateModel;
+    struct Row
+    {
+        QString key;
+        QVariant sortKey;
+        QSharedPointer<Update> update;
+    };
+    void insert(const QString &key, const QSharedPointer<Update> &update);
+    void change(const QString &key, const QSharedPointer<Update> &update);
+    void remove(const QString &key);
+    void clear();
+    int find(const QString &key) const;
+    int position(const Row &row) const;
+    bool lessThan(const Row &a, const Row &b) const;
+
+    UpdateModel *m_model;
+    int m_sortRole;
+    Qt::SortOrder m_sortOrder;
+    QList<Row> m_rows;
+    // The sort key of each row, as it was when the row was placed.
+    QHash<QString, QVariant> m_sortKeys;
 };
 } // UpdatePlugin
 
@@ -30,6 +30,9 @@
 #include "nm_settings_proxy.h"
 #include "nm_settings_connection_proxy.h"
 
+#include <SystemSettings/BlockingCall>
+#include <SystemSettings/DBusStats>
+
 #define NM_SERVICE "org.freedesktop.NetworkManager"
 #define NM_PATH "/org/freedesktop/NetworkManager"
 #define NM_AP_IFACE "org.freedesktop.NetworkManager.AccessPoint"
@@ -186,8 +189,10 @@ void WifiDbusHelper::connect(QString ssid, int security, int auth, QStringList u
     }
 
     // find the first wlan adapter for now
+    SystemSettings::BlockingCall blocking("WifiDbusHelper::connect");
     auto reply1 = mgr.GetDevices();
-    reply1.waitForFinished();
+    SystemSettings::DBusStats::waitForFinished(reply1, "wifi", NM_SERVICE,
+                                               "GetDevices");
     if(!reply1.isValid()) {
         qWarning() << "Could not get network device: " << reply1.error().message() << "\n";
         return;
@@ -297,8 +302,10 @@ QString WifiDbusHelper::getWifiIpAddress()
                                               m_systemBusConnection);
 
     // find the first wlan adapter for now
+    SystemSettings::BlockingCall blocking("WifiDbusHelper::getWifiIpAddress");
     auto reply1 = mgr.GetDevices();
-    reply1.waitForFinished();
+    SystemSettings::DBusStats::waitForFinished(reply1, "wifi", NM_SERVICE,
+                                               "GetDevices");
     if(!reply1.isValid()) {
         qWarning() << "Could not get network device: " << reply1.error().message() << "\n";
         return QString();
@@ -425,8 +432,10 @@ struct Network : public QObject
                 secretsType = "802-1x";
             }
 
+            SystemSettings::BlockingCall blocking("Network::GetSecrets");
             auto reply = m_iface.GetSecrets( secretsType );
-            reply.waitForFinished();
+            SystemSettings::DBusStats::waitForFinished(reply, "wifi", NM_SERVICE,
+                                                       "GetSecrets");
             if(!reply.isValid()) {
                 qWarning() << "Error querying secrects: " << reply.error().message() << "\n";
                 return;
@@ -455,8 +464,10 @@ struct Network : public QObject
                   path,
                   QDBusConnection::systemBus())
     {
+        SystemSettings::BlockingCall blocking("Network::GetSettings");
         auto reply = m_iface.GetSettings();
-        reply.waitForFinished();
+        SystemSettings::DBusStats::waitForFinished(reply, "wifi", NM_SERVICE,
+                                                   "GetSettings");
         if(!reply.isValid()) {
             qWarning() << "Error getting network info: " << reply.error().message() << "\n";
             throw DontCare();
@@ -491,8 +502,11 @@ QList<QStringList> WifiDbusHelper::getPreviouslyConnectedWifiNetworks() {
             (NM_SERVICE,
              "/org/freedesktop/NetworkManager/Settings",
              m_systemBusConnection);
+    SystemSettings::BlockingCall blocking(
+        "WifiDbusHelper::getPreviouslyConnectedWifiNetworks");
     auto reply = foo.ListConnections();
-    reply.waitForFinished();
+    SystemSettings::DBusStats::waitForFinished(reply, "wifi", NM_SERVICE,
+                                               "ListConnections");
     if (reply.isValid()) {
         for(const auto &c: reply.value()) {
             try {
@@ -527,8 +541,10 @@ void WifiDbusHelper::forgetConnection(const QString dbus_path) {
             (NM_SERVICE,
              dbus_path,
              m_systemBusConnection);
+    SystemSettings::BlockingCall blocking("WifiDbusHelper::forgetConnection");
     auto reply = bar.Delete();
-    reply.waitForFinished();
+    SystemSettings::DBusStats::waitForFinished(reply, "wifi", NM_SERVICE,
+                                               "Delete");
     if(!reply.isValid()) {
         qWarning() << "Error forgetting network: " << reply.error().message() << "\n";
     }
@@ -539,8 +555,10 @@ bool WifiDbusHelper::forgetActiveDevice() {
                                               NM_PATH,
                                               m_systemBusConnection);
     // find the first wlan adapter for now
+    SystemSettings::BlockingCall blocking("WifiDbusHelper::forgetActiveDevice");
     auto reply1 = mgr.GetDevices();
-    reply1.waitForFinished();
+    SystemSettings::DBusStats::waitForFinished(reply1, "wifi", NM_SERVICE,
+                                               "GetDevices");
     if(!reply1.isValid()) {
         qWarning() << __PRETTY_FUNCTION__ << ": Could not get network device: " << reply1.error().message() << "\n";
         return false;
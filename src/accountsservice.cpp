@@ -23,6 +23,8 @@
 #include <QDBusReply>
 #include <QDebug>
 
+#include <SystemSettings/DBusStats>
+
 #include <unistd.h>
 #include <sys/types.h>
 
@@ -76,6 +78,7 @@ void AccountsService::slotNameOwnerChanged(QString name,
 
 void AccountsService::setUpInterface()
 {
+    SystemSettings::DBusStats::Call stats(nullptr, AS_SERVICE, "FindUserById");
     QDBusReply<QDBusObjectPath> qObjectPath = m_accountsserviceIface.call(
                 "FindUserById", qlonglong(getuid()));
 
@@ -101,7 +104,8 @@ void AccountsService::setUpInterface()
 QVariant AccountsService::getUserProperty(const QString &interface,
                                           const QString &property)
 {
-
+    // Creating the interface introspects the object; that is counted too.
+    SystemSettings::DBusStats::Call stats(nullptr, AS_SERVICE, "Get");
     QDBusInterface iface (
                 "org.freedesktop.Accounts",
                 m_objectPath,
@@ -125,6 +129,7 @@ bool AccountsService::setUserProperty(const QString &interface,
                                       const QString &property,
                                       const QVariant &value)
 {
+    SystemSettings::DBusStats::Call stats(nullptr, AS_SERVICE, "Set");
     QDBusInterface iface (
                  "org.freedesktop.Accounts",
                 m_objectPath,
@@ -145,6 +150,7 @@ bool AccountsService::setUserProperty(const QString &interface,
 bool AccountsService::customSetUserProperty(const QString &method,
                                             const QVariant &value)
 {
+    SystemSettings::DBusStats::Call stats(nullptr, AS_SERVICE, method);
     QDBusInterface iface ("org.freedesktop.Accounts",
                           m_objectPath,
                           "org.freedesktop.Accounts.User",
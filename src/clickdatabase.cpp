@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2016 Canonical Ltd
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+*/
+
+#include "clickdatabase.h"
+
+#include <click.h>
+#include <glib.h>
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSet>
+
+// An install or removal touches several files; refresh once they're done.
+#define REFRESH_DELAY 500
+
+ClickDatabase::ClickDatabase(const QString &root, QObject *parent)
+    : QObject(parent)
+    , m_root(root)
+{
+    m_refreshTimer.setSingleShot(true);
+    m_refreshTimer.setInterval(REFRESH_DELAY);
+    connect(&m_refreshTimer, SIGNAL(timeout()), this, SLOT(refresh()));
+    connect(&m_watcher, SIGNAL(directoryChanged(const QString&)),
+            this, SLOT(scheduleRefresh()));
+}
+
+ClickDatabase::~ClickDatabase()
+{
+}
+
+ClickDatabase *ClickDatabase::instance()
+{
+    static ClickDatabase *database = nullptr;
+    if (!database) {
+        database = new ClickDatabase(QString(), QCoreApplication::instance());
+    }
+    return database;
+}
+
+QJsonArray ClickDatabase::manifests()
+{
+    if (!m_read) {
+        m_valid = read();
+        m_read = true;
+    }
+    return m_manifestList;
+}
+
+bool ClickDatabase::isValid()
+{
+    manifests();
+    return m_valid;
+}
+
+void ClickDatabase::scheduleRefresh()
+{
+    m_refreshTimer.start();
+}
+
+void ClickDatabase::refresh()
+{
+    QJsonArray old = m_manifestList;
+    m_valid = read();
+    m_read = true;
+
+    if (m_manifestList != old) {
+        Q_EMIT changed();
+    }
+}
+
+bool ClickDatabase::read()
+{
+    GError *err = nullptr;
+    ClickDB *db = click_db_new();
+
+    if (m_root.isEmpty()) {
+        click_db_read(db, nullptr, &err);
+    } else {
+        click_db_add(db, m_root.toUtf8().constData());
+    }
+    if (err != nullptr) {
+        g_warning("Unable to read Click database: %s", err->message);
+        g_error_free(err);
+        g_object_unref(db);
+        return false;
+    }
+
+    QStringList paths;
+    for (int i = 0; i < click_db_get_size(db); i++) {
+        ClickSingleDB *single = click_db_get(db, i);
+        paths << QString::fromUtf8(click_single_db_get_root(single));
+        g_object_unref(single);
+    }
+
+    GList *packages = click_db_get_packages(db, FALSE, &err);
+    if (err != nullptr) {
+        g_warning("Unable to list Click packages: %s", err->message);
+        g_error_free(err);
+        g_object_unref(db);
+        return false;
+    }
+
+    QHash<QString, QJsonObject> manifests;
+    QJsonArray list;
+    for (GList *l = packages; l != nullptr; l = l->next) {
+        ClickInstalledPackage *package = (ClickInstalledPackage *) l->data;
+        const gchar *name = click_installed_package_get_package(package);
+        const gchar *version = click_installed_package_get_version(package);
+
+        // A new version of a package changes its "current" link.
+        paths << QFileInfo(QString::fromUtf8(
+            click_installed_package_get_path(package))).absolutePath();
+
+        // Installed versions don't change, so their manifests can be reused.
+        QString key = QString::fromUtf8(name) + '\n' + QString::fromUtf8(version);
+        QJsonObject manifest = m_manifests.value(key);
+
+        if (manifest.isEmpty()) {
+            gchar *json = click_db_get_manifest_as_string(db, name, version,
+                                                          &err);
+            if (err != nullptr) {
+                g_warning("Unable to get the manifest of %s: %s",
+                          name, err->message);
+                g_clear_error(&err);
+                continue;
+            }
+            manifest = QJsonDocument::fromJson(QByteArray(json)).object();
+            g_free(json);
+        }
+
+        manifests.insert(key, manifest);
+        list.append(manifest);
+    }
+    g_list_free_full(packages, g_object_unref);
+    g_object_unref(db);
+
+    m_manifests = manifests;
+    m_manifestList = list;
+    watch(paths);
+
+    return true;
+}
+
+void ClickDatabase::watch(const QStringList &paths)
+{
+    QSet<QString> wanted;
+    Q_FOREACH(const QString &path, paths) {
+        if (QFileInfo(path).isDir()) {
+            wanted.insert(path);
+        }
+    }
+
+    QSet<QString> watched = m_watcher.directories().toSet();
+    QStringList removed = (watched - wanted).toList();
+    QStringList added = (wanted - watched).toList();
+
+    if (!removed.isEmpty()) {
+        m_watcher.removePaths(removed);
+    }
+    if (!added.isEmpty()) {
+        m_watcher.addPaths(added);
+    }
+}
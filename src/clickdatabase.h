@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2016 Canonical Ltd
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CLICKDATABASE_H
+#define CLICKDATABASE_H
+
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+/* The manifests of the installed click packages, read in-process through
+ * libclick (the equivalent of `click list --manifest`, without starting the
+ * click interpreter).
+ *
+ * The database directories are watched; when they change, only the
+ * manifests of packages that were added or changed version are read
+ * again, and changed() is emitted. */
+class ClickDatabase : public QObject
+{
+    Q_OBJECT
+public:
+    // Reads the system's click databases, or only root if given.
+    explicit ClickDatabase(const QString &root = QString(),
+                           QObject *parent = nullptr);
+    ~ClickDatabase();
+
+    // Process-wide instance shared by the updates and storage panels.
+    static ClickDatabase *instance();
+
+    // Manifests of the current version of every installed package.
+    QJsonArray manifests();
+    // Whether the database could be read.
+    bool isValid();
+
+Q_SIGNALS:
+    void changed();
+
+private Q_SLOTS:
+    void scheduleRefresh();
+    void refresh();
+
+private:
+    bool read();
+    void watch(const QStringList &paths);
+
+    QString m_root;
+    bool m_valid = false;
+    bool m_read = false;
+    QJsonArray m_manifestList;
+    // Parsed manifests keyed by package name and version.
+    QHash<QString, QJsonObject> m_manifests;
+    QFileSystemWatcher m_watcher;
+    QTimer m_refreshTimer;
+};
+
+#endif // CLICKDATABASE_H
@@ -76,6 +76,10 @@ void ItemModel::setPlugins(const QMap<QString, Plugin *> &plugins)
     Q_FOREACH(Plugin *plugin, d->m_plugins.values()) {
         QObject::connect(plugin, SIGNAL(visibilityChanged()),
                          this, SLOT(onItemVisibilityChanged()));
+        QObject::connect(plugin, SIGNAL(displayNameChanged()),
+                         this, SLOT(onItemDataChanged()));
+        QObject::connect(plugin, SIGNAL(keywordsChanged()),
+                         this, SLOT(onItemDataChanged()));
         d->m_visibleItems.append(plugin);
     }
     endResetModel();
@@ -157,6 +161,22 @@ void ItemModel::onItemVisibilityChanged()
     }
 }
 
+/* Names and keywords of plugins that load late change, and with them the
+ * sorting and filtering of the entries. */
+void ItemModel::onItemDataChanged()
+{
+    Q_D(ItemModel);
+
+    Plugin *item = qobject_cast<Plugin *>(sender());
+    Q_ASSERT(item != 0);
+
+    int row = d->m_visibleItems.indexOf(item);
+    if (row < 0) return;
+    QModelIndex changed = index(row, 0);
+    Q_EMIT dataChanged(changed, changed,
+                       QVector<int>() << Qt::DisplayRole << KeywordRole);
+}
+
 ItemModelSortProxy::ItemModelSortProxy(QObject *parent)
     : QSortFilterProxyModel(parent)
 {
@@ -51,6 +51,7 @@ public:
 
 private Q_SLOTS:
     void onItemVisibilityChanged();
+    void onItemDataChanged();
 
 private:
     ItemModelPrivate *d_ptr;
@@ -20,18 +20,26 @@
 
 #include "debug.h"
 #include "i18n.h"
+#include "panel-stats.h"
 #include "plugin-manager.h"
+#include "resident.h"
+#include "stall-watchdog.h"
 #include "utils.h"
 
 #include <QByteArray>
+#include <QDBusConnection>
 #include <QApplication>
 #include <QProcessEnvironment>
+#include <QScopedPointer>
 #include <QQmlContext>
 #include <QUrl>
 #include <QQuickView>
 #include <QtGlobal>
 #include <QtQml>
 #include <QtQml/QQmlDebuggingEnabler>
+
+#include <SystemSettings/DBusStats>
+
 static QQmlDebuggingEnabler debuggingEnabler(false);
 
 using namespace SystemSettings;
@@ -55,6 +63,41 @@ int main(int argc, char **argv)
             setLoggingLevel(value);
     }
 
+    /* Opt-in report of the calls that freeze the UI, written at exit. */
+    QScopedPointer<StallWatchdog> watchdog;
+    if (environment.contains(QLatin1String("SS_STALL_WATCHDOG"))) {
+        bool isOk;
+        int threshold = environment.value(
+            QLatin1String("SS_STALL_WATCHDOG")).toInt(&isOk);
+        if (isOk && threshold > 0)
+            watchdog.reset(new StallWatchdog(threshold));
+    }
+
+    /* Opt-in resident mode: hand the launch to the instance that is already
+     * running, if any. */
+    int residentTimeout = 0;
+    if (environment.contains(QLatin1String("SS_RESIDENT"))) {
+        residentTimeout = environment.value(
+            QLatin1String("SS_RESIDENT")).toInt();
+        if (residentTimeout > 0 && ResidentService::forward(app.arguments()))
+            return 0;
+    }
+
+    /* Opt-in count of the D-Bus calls made per panel, dumped on request. */
+    if (DBusStats::isEnabled()) {
+        QDBusConnection::sessionBus().registerObject(
+            "/com/canonical/SystemSettings/DBusStats", DBusStats::instance(),
+            QDBusConnection::ExportScriptableSlots);
+    }
+
+    /* Opt-in accounting of memory and CPU time per panel, dumped on
+     * request. */
+    if (PanelStats::isEnabled()) {
+        QDBusConnection::sessionBus().registerObject(
+            "/com/canonical/SystemSettings/PanelStats", PanelStats::instance(),
+            QDBusConnection::ExportScriptableSlots);
+    }
+
     initTr(I18N_DOMAIN, nullptr);
     /* HACK: force the theme until lp #1098578 is fixed */
     QIcon::setThemeName("suru");
@@ -68,8 +111,19 @@ int main(int argc, char **argv)
 
     QQuickView view;
     Utilities utils;
-    QObject::connect(view.engine(), SIGNAL(quit()), &app, SLOT(quit()),
-                     Qt::QueuedConnection);
+    QScopedPointer<ResidentService> resident;
+    if (residentTimeout > 0) {
+        resident.reset(new ResidentService(&view, residentTimeout));
+        if (!resident->registerService())
+            resident.reset();
+    }
+    if (resident) {
+        QObject::connect(view.engine(), SIGNAL(quit()),
+                         resident.data(), SLOT(hide()), Qt::QueuedConnection);
+    } else {
+        QObject::connect(view.engine(), SIGNAL(quit()), &app, SLOT(quit()),
+                         Qt::QueuedConnection);
+    }
     qmlRegisterType<QAbstractItemModel>();
     qmlRegisterType<SystemSettings::PluginManager>("SystemSettings", 1, 0, "PluginManager");
     view.engine()->rootContext()->setContextProperty("Utilities", &utils);
@@ -0,0 +1,125 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "memory-budget.h"
+#include "debug.h"
+#include "plugin.h"
+
+#include <QFile>
+#include <QQmlContext>
+#include <QQmlEngine>
+#include <QTimer>
+
+#include <malloc.h>
+#include <unistd.h>
+
+using namespace SystemSettings;
+
+MemoryBudget::MemoryBudget(qint64 budget, QObject *parent):
+    QObject(parent),
+    m_budget(budget),
+    m_stuckAt(0)
+{
+}
+
+MemoryBudget *MemoryBudget::instance()
+{
+    static MemoryBudget *memoryBudget =
+        new MemoryBudget(qgetenv("SS_MEMORY_BUDGET").toLongLong() * 1024 * 1024);
+    return memoryBudget;
+}
+
+bool MemoryBudget::isEnabled()
+{
+    static const bool enabled = qgetenv("SS_MEMORY_BUDGET").toLongLong() > 0;
+    return enabled;
+}
+
+qint64 MemoryBudget::residentSize()
+{
+    // The second field is the number of resident pages.
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly))
+        return 0;
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    return fields.value(1).toLongLong() * sysconf(_SC_PAGESIZE);
+}
+
+qint64 MemoryBudget::measure() const
+{
+    return residentSize();
+}
+
+void MemoryBudget::panelOpened(Plugin *plugin)
+{
+    // Dropped by the plugin manager.
+    m_panels.removeAll(QPointer<Plugin>());
+
+    // The page component is asked for more than once per opening.
+    if (!m_panels.isEmpty() && m_panels.last() == plugin)
+        return;
+
+    m_panels.removeAll(plugin);
+    m_panels.append(plugin);
+
+    // Once the page of the previous panel is gone.
+    const qint64 size = measure();
+    if (size > m_budget && size > m_stuckAt)
+        QTimer::singleShot(0, this, SLOT(enforce()));
+}
+
+void MemoryBudget::enforce()
+{
+    qint64 size = measure();
+    if (size <= m_budget) {
+        m_stuckAt = 0;
+        return;
+    }
+
+    while (size > m_budget && m_panels.count() > 1) {
+        QPointer<Plugin> plugin = m_panels.takeFirst();
+        if (!plugin)
+            continue;
+
+        releasePanel(plugin);
+        const qint64 released = measure();
+        DEBUG() << "Over the memory budget, released" << plugin->baseName()
+                << (size - released) / 1024 << "kB";
+
+        // What is left is not the panels'.
+        if (released >= size) {
+            m_stuckAt = released;
+            return;
+        }
+        size = released;
+    }
+    m_stuckAt = size > m_budget ? size : 0;
+}
+
+void MemoryBudget::releasePanel(Plugin *plugin)
+{
+    QQmlContext *context = QQmlEngine::contextForObject(plugin);
+    plugin->release();
+
+    // What the panel compiled, and the heap it freed.
+    if (context) {
+        context->engine()->collectGarbage();
+        context->engine()->trimComponentCache();
+    }
+    malloc_trim(0);
+}
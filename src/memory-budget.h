@@ -0,0 +1,74 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYSTEM_SETTINGS_MEMORY_BUDGET_H
+#define SYSTEM_SETTINGS_MEMORY_BUDGET_H
+
+#include <QList>
+#include <QObject>
+#include <QPointer>
+
+namespace SystemSettings {
+
+class Plugin;
+
+/* Keeps the resident size of the process within a budget by releasing the
+ * panels that were opened least recently. Once the process is over budget,
+ * panels other than the current one are released, oldest first, measuring
+ * the resident size after each, until it is within budget again. A release
+ * that frees nothing stops the pass, and no new pass starts until the
+ * process grows past where that one stopped.
+ *
+ * Releasing drops what Plugin::release() can: the compiled page, and the
+ * item and library of panels whose entry doesn't need them. Models owned
+ * by the page go with the page when it is popped, before this runs.
+ *
+ * Enabled by setting SS_MEMORY_BUDGET to the budget in megabytes. */
+class MemoryBudget: public QObject
+{
+    Q_OBJECT
+
+public:
+    static MemoryBudget *instance();
+    static bool isEnabled();
+    // In bytes; 0 if it can't be read.
+    static qint64 residentSize();
+
+    void panelOpened(Plugin *plugin);
+
+public Q_SLOTS:
+    void enforce();
+
+protected:
+    // budget is in bytes.
+    explicit MemoryBudget(qint64 budget, QObject *parent = 0);
+
+    virtual qint64 measure() const;
+    virtual void releasePanel(Plugin *plugin);
+
+private:
+    qint64 m_budget;
+    // Least recently opened first; the last one is the current panel.
+    QList<QPointer<Plugin> > m_panels;
+    // Where the last pass stopped, over budget; 0 if it didn't.
+    qint64 m_stuckAt;
+};
+
+} // namespace
+
+#endif // SYSTEM_SETTINGS_MEMORY_BUDGET_H
@@ -0,0 +1,184 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "panel-stats.h"
+#include "memory-budget.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <malloc.h>
+#include <sys/resource.h>
+
+#define IDLE_INTERVAL 1000
+
+using namespace SystemSettings;
+
+static const char *phaseNames[] = { "open", "idle", "close" };
+
+PanelStats::PanelStats(QObject *parent):
+    QObject(parent),
+    m_phase(Idle)
+{
+    m_clock.start();
+    m_last = sample();
+
+    m_idleTimer.setInterval(IDLE_INTERVAL);
+    QObject::connect(&m_idleTimer, SIGNAL(timeout()),
+                     this, SLOT(sampleIdle()));
+    m_idleTimer.start();
+}
+
+PanelStats *PanelStats::instance()
+{
+    static PanelStats *panelStats = new PanelStats();
+    return panelStats;
+}
+
+bool PanelStats::isEnabled()
+{
+    static const bool enabled = qEnvironmentVariableIsSet("SS_PANEL_STATS");
+    return enabled;
+}
+
+PanelStats::Figures PanelStats::sample() const
+{
+    Figures sample;
+    sample.rss = MemoryBudget::residentSize();
+
+    // Both what is in the arenas and what is mapped on its own.
+#if defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 33)
+    // mallinfo() counts in ints, which wrap past 2 GiB.
+    struct mallinfo2 info = mallinfo2();
+#else
+    struct mallinfo info = mallinfo();
+#endif
+    sample.heap = qint64(info.uordblks) + qint64(info.hblkhd);
+#endif
+
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        sample.cpu = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000 +
+            (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000;
+    }
+
+    sample.wall = m_clock.elapsed();
+    return sample;
+}
+
+void PanelStats::record(const Figures &now)
+{
+    const QString panel = m_current.isEmpty() ? QStringLiteral("main")
+                                              : m_current;
+    Figures &totals = m_panels[panel].phases[m_phase];
+    totals.rss += now.rss - m_last.rss;
+    totals.heap += now.heap - m_last.heap;
+    totals.cpu += now.cpu - m_last.cpu;
+    totals.wall += now.wall - m_last.wall;
+    m_last = now;
+}
+
+void PanelStats::panelOpened(const QString &panel)
+{
+    // The page component is asked for more than once per opening.
+    if (panel == m_current && m_phase == Opening)
+        return;
+
+    record(sample());
+    m_current = panel;
+    m_phase = Opening;
+    m_panels[panel].opens++;
+    QTimer::singleShot(0, this, SLOT(settle()));
+}
+
+void PanelStats::panelClosed(const QString &panel)
+{
+    m_panels[panel].closes++;
+    // Closed after another panel was opened.
+    if (panel != m_current)
+        return;
+
+    record(sample());
+    m_phase = Closing;
+    QTimer::singleShot(0, this, SLOT(settle()));
+}
+
+void PanelStats::settle()
+{
+    if (m_phase == Idle)
+        return;
+
+    record(sample());
+    if (m_phase == Closing)
+        m_current.clear();
+    m_phase = Idle;
+}
+
+void PanelStats::sampleIdle()
+{
+    if (m_phase == Idle)
+        record(sample());
+}
+
+QByteArray PanelStats::toJson() const
+{
+    QJsonObject panels;
+    QMapIterator<QString, Panel> it(m_panels);
+    while (it.hasNext()) {
+        it.next();
+        const Panel &panel = it.value();
+
+        QJsonObject object;
+        object["opens"] = panel.opens;
+        object["closes"] = panel.closes;
+        for (int i = 0; i < PhaseCount; i++) {
+            const Figures &totals = panel.phases[i];
+            QJsonObject phase;
+            phase["rssKb"] = totals.rss / 1024;
+            phase["heapKb"] = totals.heap / 1024;
+            phase["cpuMs"] = totals.cpu;
+            phase["wallMs"] = totals.wall;
+            object[phaseNames[i]] = phase;
+        }
+        panels[it.key()] = object;
+    }
+
+    const Figures now = sample();
+    QJsonObject root;
+    root["current"] = m_current.isEmpty() ? QStringLiteral("main") : m_current;
+    root["rssKb"] = now.rss / 1024;
+    root["heapKb"] = now.heap / 1024;
+    root["cpuMs"] = now.cpu;
+    root["panels"] = panels;
+    return QJsonDocument(root).toJson();
+}
+
+QString PanelStats::Dump() const
+{
+    return QString::fromUtf8(toJson());
+}
+
+void PanelStats::Reset()
+{
+    // Starts over on the main page; a pending settle() finds nothing to do.
+    m_panels.clear();
+    m_current.clear();
+    m_phase = Idle;
+    m_last = sample();
+}
@@ -0,0 +1,102 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYSTEM_SETTINGS_PANEL_STATS_H
+#define SYSTEM_SETTINGS_PANEL_STATS_H
+
+#include <QElapsedTimer>
+#include <QMap>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+namespace SystemSettings {
+
+/* Attributes the growth of the resident size and of the heap, and the CPU
+ * time used, to the panel that was current at the time. Each panel has
+ * three phases: opening, from Plugin::pageComponent() until the event loop
+ * is idle again; idle, until the panel is closed, sampled every second so
+ * that background work shows up while the panel is still open; and
+ * closing, from PluginManager::notifyPanelClosed() until the event loop is
+ * idle again. Whatever happens with no panel open goes to "main".
+ *
+ * Only enabled when SS_PANEL_STATS is set; the figures can then be dumped
+ * as JSON over the session bus:
+ *
+ *     gdbus call --session --dest <unique name of system-settings> \
+ *         --object-path /com/canonical/SystemSettings/PanelStats \
+ *         --method com.canonical.SystemSettings.PanelStats.Dump
+ *
+ * When a panel is opened from another one, the other panel's page is only
+ * destroyed afterwards, and that is counted in the opening of the new one. */
+class PanelStats: public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.canonical.SystemSettings.PanelStats")
+
+public:
+    static PanelStats *instance();
+    static bool isEnabled();
+
+    void panelOpened(const QString &panel);
+    void panelClosed(const QString &panel);
+
+    QByteArray toJson() const;
+
+public Q_SLOTS:
+    Q_SCRIPTABLE QString Dump() const;
+    Q_SCRIPTABLE void Reset();
+
+private Q_SLOTS:
+    void settle();
+    void sampleIdle();
+
+private:
+    explicit PanelStats(QObject *parent = 0);
+
+    enum Phase { Opening = 0, Idle, Closing, PhaseCount };
+
+    // A sample, or what a phase added up to.
+    struct Figures {
+        qint64 rss = 0;
+        qint64 heap = 0;
+        qint64 cpu = 0;
+        qint64 wall = 0;
+    };
+
+    struct Panel {
+        int opens = 0;
+        int closes = 0;
+        Figures phases[PhaseCount];
+    };
+
+    Figures sample() const;
+    // Adds what changed since the last sample to the current phase.
+    void record(const Figures &now);
+
+    QElapsedTimer m_clock;
+    QTimer m_idleTimer;
+    QMap<QString, Panel> m_panels;
+    QString m_current;
+    Phase m_phase;
+    Figures m_last;
+};
+
+} // namespace
+
+#endif // SYSTEM_SETTINGS_PANEL_STATS_H
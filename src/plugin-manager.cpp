@@ -21,7 +21,9 @@
 #include "plugin-manager.h"
 #include "debug.h"
 #include "item-model.h"
+#include "panel-stats.h"
 #include "plugin.h"
+#include "visibility-predicates.h"
 
 #include <QDir>
 #include <QMap>
@@ -30,6 +32,7 @@
 #include <QQmlEngine>
 #include <QStandardPaths>
 #include <QStringList>
+#include <QTimer>
 
 using namespace SystemSettings;
 
@@ -46,17 +49,23 @@ class PluginManagerPrivate
 
     void clear();
     void reload();
+    void startPrefetch();
+    void prefetchNext();
 
 private:
     mutable PluginManager *q_ptr;
     QMap<QString,QMap<QString, Plugin*> > m_plugins;
     QHash<QString,ItemModelSortProxy*> m_models;
+    QList<Plugin*> m_prefetchQueue;
+    bool m_prefetchStarted;
+    VisibilityPredicates m_visibility;
 };
 
 } // namespace
 
 PluginManagerPrivate::PluginManagerPrivate(PluginManager *q):
-    q_ptr(q)
+    q_ptr(q),
+    m_prefetchStarted(false)
 {
 }
 
@@ -67,6 +76,7 @@ PluginManagerPrivate::~PluginManagerPrivate()
 
 void PluginManagerPrivate::clear()
 {
+    m_visibility.clear();
     QMapIterator<QString, QMap<QString, Plugin*> > it(m_plugins);
     while (it.hasNext()) {
         it.next();
@@ -75,6 +85,38 @@ void PluginManagerPrivate::clear()
         }
     }
     m_plugins.clear();
+    m_prefetchQueue.clear();
+    m_prefetchStarted = false;
+}
+
+/* The main page is laid out with what the manifests say; the plugins that
+ * say more are loaded, and their backends set up, afterwards. Nothing is
+ * loaded until the main page is, so that a deep link only pays for the
+ * panel it opens. */
+void PluginManagerPrivate::startPrefetch()
+{
+    Q_Q(PluginManager);
+
+    if (m_prefetchStarted) return;
+    m_prefetchStarted = true;
+
+    typedef QMap<QString, Plugin *> Plugins;
+    Q_FOREACH(const Plugins &plugins, m_plugins.values())
+        m_prefetchQueue.append(plugins.values());
+    QTimer::singleShot(0, q, [this]() { prefetchNext(); });
+}
+
+/* One plugin per pass of the event loop, so that input and painting are
+ * handled in between. */
+void PluginManagerPrivate::prefetchNext()
+{
+    Q_Q(PluginManager);
+
+    if (m_prefetchQueue.isEmpty()) return;
+    m_prefetchQueue.takeFirst()->prefetch();
+
+    if (!m_prefetchQueue.isEmpty())
+        QTimer::singleShot(0, q, [this]() { prefetchNext(); });
 }
 
 void PluginManagerPrivate::reload()
@@ -110,9 +152,15 @@ void PluginManagerPrivate::reload()
         Plugin *plugin = new Plugin(fileInfo);
         QQmlEngine::setContextForObject(plugin, ctx);
         QMap<QString, Plugin*> &pluginList = m_plugins[plugin->category()];
-        if (showAll || !plugin->hideByDefault())
+        if (showAll || !plugin->hideByDefault()) {
             pluginList.insert(fileInfo.baseName(), plugin);
+            if (plugin->hasVisibilityPredicates())
+                m_visibility.add(plugin, plugin->visibilityPredicates());
+        }
     }
+
+    // All at once, off the GUI thread.
+    m_visibility.start();
 }
 
 PluginManager::PluginManager(QObject *parent):
@@ -150,6 +198,18 @@ void PluginManager::resetPlugins()
     }
 }
 
+void PluginManager::notifyPanelClosed(const QString &name)
+{
+    if (PanelStats::isEnabled())
+        PanelStats::instance()->panelClosed(name);
+}
+
+bool PluginManager::isPrefetching() const
+{
+    Q_D(const PluginManager);
+    return !d->m_prefetchQueue.isEmpty();
+}
+
 QAbstractItemModel *PluginManager::itemModel(const QString &category)
 {
     Q_D(PluginManager);
@@ -163,8 +223,12 @@ QAbstractItemModel *PluginManager::itemModel(const QString &category)
         model->setDynamicSortFilter(true);
         model->setFilterCaseSensitivity(Qt::CaseInsensitive);
         model->setFilterRole(ItemModel::KeywordRole);
+        // The search may have been started before the main page was loaded.
+        if (!m_filter.isEmpty())
+            model->setFilterRegExp(m_filter);
         /* we only have one column as this is a QAbstractListModel */
         model->sort(0);
+        d->startPrefetch();
     }
 
     return model;
@@ -208,6 +272,10 @@ void PluginManager::classBegin()
     d->reload();
 }
 
+/* Intentionally empty: prefetching starts with the first item model the
+ * main page asks for (see startPrefetch()). When a panel is deep linked,
+ * the main page is only built once that panel is shown, and until then no
+ * other plugin should be loaded. */
 void PluginManager::componentComplete()
 {
 }
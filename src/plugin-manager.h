@@ -51,6 +51,10 @@ public:
     Q_INVOKABLE QObject *getByName(const QString &name) const;
     Q_INVOKABLE QAbstractItemModel *itemModel(const QString &category);
     Q_INVOKABLE void resetPlugins();
+    // Called when the page of the panel name is destroyed.
+    Q_INVOKABLE void notifyPanelClosed(const QString &name);
+    // Whether plugins are still queued to have their backends set up.
+    bool isPrefetching() const;
     QString getFilter();
     void setFilter(const QString &filter);
 
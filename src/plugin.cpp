@@ -20,6 +20,8 @@
 
 #include "plugin.h"
 #include "debug.h"
+#include "memory-budget.h"
+#include "panel-stats.h"
 
 #include <QEventLoop>
 #include <QDir>
@@ -27,12 +29,15 @@
 #include <QJsonDocument>
 #include <QJsonParseError>
 #include <QPluginLoader>
+#include <QPointer>
 #include <QQmlContext>
 #include <QQmlEngine>
 #include <QStandardPaths>
 #include <QStringList>
+#include <QTimer>
 #include <QVariantMap>
 
+#include <SystemSettings/DBusStats>
 #include <SystemSettings/ItemBase>
 #include <SystemSettings/PluginInterface>
 
@@ -51,6 +56,10 @@ class PluginPrivate
     ~PluginPrivate() {};
 
     bool ensureLoaded() const;
+    void prefetchItem() const;
+    bool hasDynamicData() const;
+    bool needsItem() const;
+    QQmlComponent *loadPageComponent();
     QUrl componentFromSettingsFile(const QString &key) const;
 
 private:
@@ -59,6 +68,14 @@ private:
     mutable QPluginLoader m_loader;
     mutable PluginInterface *m_plugin;
     mutable PluginInterface2 *m_plugin2;
+    mutable PluginInterface3 *m_plugin3;
+    mutable bool m_prefetched;
+    QPointer<QQmlComponent> m_pageComponent;
+    VisibilityPredicates::Predicates m_predicates;
+    bool m_hasPredicates;
+    /* Until they are evaluated, the entry is hidden, unless they only check
+     * for files. */
+    bool m_predicatesHold;
     QString m_baseName;
     QVariantMap m_data;
     QString m_dataPath;
@@ -71,6 +88,10 @@ PluginPrivate::PluginPrivate(Plugin *q, const QFileInfo &manifest):
     m_item(0),
     m_plugin(0),
     m_plugin2(0),
+    m_plugin3(0),
+    m_prefetched(false),
+    m_hasPredicates(false),
+    m_predicatesHold(false),
     m_baseName(manifest.completeBaseName())
 {
     QFile file(manifest.filePath());
@@ -89,6 +110,12 @@ PluginPrivate::PluginPrivate(Plugin *q, const QFileInfo &manifest):
 
     m_data = json.toVariant().toMap();
     m_dataPath = manifest.absolutePath();
+    m_hasPredicates = VisibilityPredicates::parse(m_data, &m_predicates);
+    // So that entries don't pop in after the first frame.
+    if (m_hasPredicates && m_predicates.filesOnly()) {
+        m_predicatesHold = VisibilityPredicates::evaluate(
+            QList<VisibilityPredicates::Predicates>() << m_predicates).first();
+    }
 }
 
 bool PluginPrivate::ensureLoaded() const
@@ -119,8 +146,10 @@ bool PluginPrivate::ensureLoaded() const
         return false;
     }
 
-    m_plugin2 = qobject_cast<SystemSettings::PluginInterface2*>(
+    m_plugin3 = qobject_cast<SystemSettings::PluginInterface3*>(
                 m_loader.instance());
+    m_plugin2 = m_plugin3 ? m_plugin3 :
+        qobject_cast<SystemSettings::PluginInterface2*>(m_loader.instance());
 
     if (m_plugin2)
         m_plugin = m_plugin2;
@@ -144,9 +173,59 @@ bool PluginPrivate::ensureLoaded() const
                      q, SIGNAL(displayNameChanged()));
     QObject::connect(m_item, SIGNAL(visibilityChanged()),
                      q, SIGNAL(visibilityChanged()));
+    QObject::connect(m_item, SIGNAL(readyChanged()),
+                     q, SIGNAL(readyChanged()));
+
+    // Don't set up the backend while the caller is laying out the page.
+    if (m_plugin3)
+        QTimer::singleShot(0, q_ptr, [this]() { prefetchItem(); });
     return true;
 }
 
+void PluginPrivate::prefetchItem() const
+{
+    if (m_item == 0 || m_plugin3 == 0 || m_prefetched) return;
+    m_prefetched = true;
+    m_plugin3->prefetch(m_item);
+}
+
+/* Whether the main page needs the item of the plugin, rather than only
+ * its manifest. */
+bool PluginPrivate::hasDynamicData() const
+{
+    return m_data.value(keyHasDynamicName).toBool() ||
+        m_data.value(keyHasDynamicKeywords).toBool() ||
+        m_data.value(keyHasDynamicVisibility).toBool() ||
+        m_data.value(keyIcon).toString().isEmpty();
+}
+
+// Whether the main page can't do without the item.
+bool PluginPrivate::needsItem() const
+{
+    return hasDynamicData() || m_data.value(keyName).toString().isEmpty();
+}
+
+QQmlComponent *PluginPrivate::loadPageComponent()
+{
+    Q_Q(Plugin);
+
+    if (m_pageComponent) return m_pageComponent;
+
+    QQmlContext *context = QQmlEngine::contextForObject(q);
+    if (Q_UNLIKELY(context == 0)) return 0;
+
+    QUrl pageComponentUrl = componentFromSettingsFile(keyPageComponent);
+    if (!pageComponentUrl.isEmpty()) {
+        m_pageComponent =
+            new QQmlComponent(context->engine(), pageComponentUrl, q);
+    } else {
+        if (!ensureLoaded()) return 0;
+        prefetchItem();
+        m_pageComponent = m_item->pageComponent(context->engine(), q);
+    }
+    return m_pageComponent;
+}
+
 QUrl PluginPrivate::componentFromSettingsFile(const QString &key) const
 {
     QUrl componentUrl = m_data.value(key).toString();
@@ -166,6 +245,13 @@ Plugin::Plugin(const QFileInfo &manifest, QObject *parent):
     QObject(parent),
     d_ptr(new PluginPrivate(this, manifest))
 {
+    // Until the item is ready, its entry shows the manifest data.
+    QObject::connect(this, SIGNAL(readyChanged()),
+                     this, SIGNAL(displayNameChanged()));
+    QObject::connect(this, SIGNAL(readyChanged()),
+                     this, SIGNAL(keywordsChanged()));
+    QObject::connect(this, SIGNAL(readyChanged()),
+                     this, SIGNAL(visibilityChanged()));
 }
 
 Plugin::~Plugin()
@@ -178,7 +264,7 @@ QString Plugin::displayName() const
     Q_D(const Plugin);
     QString ret = d->m_data.value(keyName).toString();
     if (d->m_data.value(keyHasDynamicName).toBool()) {
-        if (!d->ensureLoaded()) return ret;
+        if (!d->ensureLoaded() || !d->m_item->isReady()) return ret;
         ret = d->m_item->name();
     }
     return ret;
@@ -227,7 +313,7 @@ QStringList Plugin::keywords() const
     Q_D(const Plugin);
     QStringList ret = d->m_data.value(keyKeywords).toStringList();
     if (d->m_data.value(keyHasDynamicKeywords).toBool()) {
-        if (!d->ensureLoaded()) return ret;
+        if (!d->ensureLoaded() || !d->m_item->isReady()) return ret;
         ret += d->m_item->keywords();
     }
     return ret;
@@ -236,15 +322,13 @@ QStringList Plugin::keywords() const
 bool Plugin::isVisible() const
 {
     Q_D(const Plugin);
-    if (!d->m_data.value(keyVisibleIfFileExists).isNull()) {
-        QFile KeyFile(d->m_data.value(keyVisibleIfFileExists).toString());
-        if (!KeyFile.exists())
-                return false;
-    }
+    // Evaluated by the plugin manager, without loading the plugin.
+    if (d->m_hasPredicates && !d->m_predicatesHold)
+        return false;
 
     // TODO: visibility check depending on form-factor
     if (d->m_data.value(keyHasDynamicVisibility).toBool()) {
-        if (!d->ensureLoaded()) return false;
+        if (!d->ensureLoaded() || !d->m_item->isReady()) return false;
         return d->m_item->isVisible();
     }
     return true;
@@ -256,9 +340,66 @@ bool Plugin::hideByDefault() const
     return d->m_data.value(keyHideByDefault, false).toBool();
 }
 
-void Plugin::reset()
+bool Plugin::isReady() const
+{
+    Q_D(const Plugin);
+    return d->m_item == 0 || d->m_item->isReady();
+}
+
+bool Plugin::isLoaded() const
+{
+    Q_D(const Plugin);
+    return d->m_item != 0;
+}
+
+bool Plugin::hasVisibilityPredicates() const
+{
+    Q_D(const Plugin);
+    return d->m_hasPredicates;
+}
+
+const VisibilityPredicates::Predicates &Plugin::visibilityPredicates() const
+{
+    Q_D(const Plugin);
+    return d->m_predicates;
+}
+
+void Plugin::setPredicatesHold(bool hold)
+{
+    Q_D(Plugin);
+    if (hold == d->m_predicatesHold) return;
+    d->m_predicatesHold = hold;
+    Q_EMIT(visibilityChanged());
+}
+
+void Plugin::prefetch()
 {
     Q_D(const Plugin);
+    if (!d->hasDynamicData() || !d->ensureLoaded()) return;
+    d->prefetchItem();
+}
+
+void Plugin::release()
+{
+    Q_D(Plugin);
+
+    delete d->m_pageComponent;
+
+    if (d->m_item == 0 || d->needsItem()) return;
+
+    DEBUG() << "Unloading" << d->m_loader.fileName();
+    delete d->m_item;
+    d->m_item = 0;
+    d->m_plugin = 0;
+    d->m_plugin2 = 0;
+    d->m_plugin3 = 0;
+    d->m_prefetched = false;
+    d->m_loader.unload();
+}
+
+void Plugin::reset()
+{
+    Q_D(Plugin);
 
     d->ensureLoaded();
 
@@ -274,7 +415,7 @@ void Plugin::reset()
         return;
 
     // Otherwise, try to use one from the page component
-    QQmlComponent *component = pageComponent();
+    QQmlComponent *component = d->loadPageComponent();
 
     if (!component)
         return;
@@ -282,10 +423,8 @@ void Plugin::reset()
     QObject *object = component->create();
 
     // If it's there, try to search for the method
-    if (!object) {
-        delete component;
+    if (!object)
         return;
-    }
 
     const QMetaObject *metaObject = object->metaObject();
     int index = metaObject->indexOfMethod(
@@ -298,7 +437,6 @@ void Plugin::reset()
     }
 
     delete object;
-    delete component;
 }
 
 QQmlComponent *Plugin::entryComponent()
@@ -326,15 +464,14 @@ QQmlComponent *Plugin::entryComponent()
 
 QQmlComponent *Plugin::pageComponent()
 {
-    Q_D(const Plugin);
-    QQmlContext *context = QQmlEngine::contextForObject(this);
-    if (Q_UNLIKELY(context == 0)) return 0;
+    Q_D(Plugin);
 
-    QUrl pageComponentUrl = d->componentFromSettingsFile(keyPageComponent);
-    if (!pageComponentUrl.isEmpty()) {
-        return new QQmlComponent(context->engine(), pageComponentUrl, this);
-    } else {
-        if (!d->ensureLoaded()) return 0;
-        return d->m_item->pageComponent(context->engine(), this);
-    }
+    // Calls made by shared code from now on are counted for this panel.
+    DBusStats::setCurrentPanel(d->m_baseName);
+    if (MemoryBudget::isEnabled())
+        MemoryBudget::instance()->panelOpened(this);
+    if (PanelStats::isEnabled())
+        PanelStats::instance()->panelOpened(d->m_baseName);
+
+    return d->loadPageComponent();
 }
@@ -26,6 +26,8 @@
 #include <QStringList>
 #include <QUrl>
 
+#include "visibility-predicates.h"
+
 class QFileInfo;
 
 namespace SystemSettings {
@@ -45,6 +47,7 @@ class Plugin: public QObject
     Q_PROPERTY(QStringList keywords READ keywords NOTIFY keywordsChanged)
     Q_PROPERTY(bool visible READ isVisible NOTIFY visibilityChanged)
     Q_PROPERTY(bool hideByDefault READ hideByDefault CONSTANT)
+    Q_PROPERTY(bool ready READ isReady NOTIFY readyChanged)
 
 public:
     explicit Plugin(const QFileInfo &manifest, QObject *parent = 0);
@@ -59,8 +62,23 @@ public:
     QStringList keywords() const;
     bool isVisible() const;
     bool hideByDefault() const;
+    // False while the backend of the plugin's item is being set up.
+    bool isReady() const;
+    // Whether the library of the plugin is loaded and its item created.
+    bool isLoaded() const;
+
+    // The "visible-if" predicates of the manifest, and whether they hold.
+    bool hasVisibilityPredicates() const;
+    const VisibilityPredicates::Predicates &visibilityPredicates() const;
+    void setPredicatesHold(bool hold);
 
     void reset();
+    /* Drops the page component and, unless the main page needs it for a
+     * dynamic name, keywords or visibility, the item and the library; they
+     * are loaded again when the panel is opened. */
+    void release();
+    // Loads the item, if the main page needs it, and sets up its backend.
+    Q_INVOKABLE void prefetch();
 
     QQmlComponent *entryComponent();
     QQmlComponent *pageComponent();
@@ -70,6 +88,7 @@ Q_SIGNALS:
     void iconChanged();
     void keywordsChanged();
     void visibilityChanged();
+    void readyChanged();
 
 private:
     PluginPrivate *d_ptr;
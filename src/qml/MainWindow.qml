@@ -38,6 +38,10 @@ MainView {
     so we implement it here. */
     property string placeholderPlugin: "about"
 
+    /* The entries of the main page, and the models behind them, are only
+    created once the panel a deep link asked for has been shown. */
+    property bool mainGridActive: !defaultPlugin
+
     function loadPluginByName(pluginName, pluginOptions) {
         var plugin = pluginManager.getByName(pluginName)
         var opts = { plugin: plugin,
@@ -57,6 +61,7 @@ MainView {
                 );
                 currentPlugin = pluginName;
                 page.Component.destruction.connect(function () {
+                    pluginManager.notifyPanelClosed(this.baseName);
                     if (currentPlugin == this.baseName) {
                         currentPlugin = "";
                     }
@@ -70,6 +75,15 @@ MainView {
         }
     }
 
+    // Back to the list of panels, for a launch without one.
+    function showMainPage() {
+        mainGridActive = true;
+        apl.removePages(apl.primaryPage);
+        if (apl.columns > 1)
+            loadPluginByName(placeholderPlugin);
+        aplConnections.target = apl;
+    }
+
     Component.onCompleted: {
         i18n.domain = "ubuntu-system-settings"
         i18n.bindtextdomain("ubuntu-system-settings", i18nDirectory)
@@ -83,6 +97,12 @@ MainView {
         }
     }
 
+    Connections {
+        target: mainGridActive ? null : view
+        ignoreUnknownSignals: true
+        onFrameSwapped: mainGridActive = true
+    }
+
     Connections {
         id: aplConnections
         ignoreUnknownSignals: true
@@ -228,31 +248,38 @@ MainView {
                    otherwise the UI might end up in a situation where scrolling doesn't work */
                 flickableDirection: Flickable.VerticalFlick
 
-                Column {
+                Loader {
+                    id: mainGrid
+                    objectName: "mainGrid"
                     anchors.left: parent.left
                     anchors.right: parent.right
+                    active: mainGridActive
+                    // Don't hold up the panel a deep link opened.
+                    asynchronous: !!defaultPlugin
 
-                    UncategorizedItemsView {
-                        model: pluginManager.itemModel("uncategorized-top")
-                    }
+                    sourceComponent: Column {
+                        UncategorizedItemsView {
+                            model: pluginManager.itemModel("uncategorized-top")
+                        }
 
-                    CategorySection {
-                        category: "network"
-                        categoryName: i18n.tr("Network")
-                    }
+                        CategorySection {
+                            category: "network"
+                            categoryName: i18n.tr("Network")
+                        }
 
-                    CategorySection {
-                        category: "personal"
-                        categoryName: i18n.tr("Personal")
-                    }
+                        CategorySection {
+                            category: "personal"
+                            categoryName: i18n.tr("Personal")
+                        }
 
-                    CategorySection {
-                        category: "system"
-                        categoryName: i18n.tr("System")
-                    }
+                        CategorySection {
+                            category: "system"
+                            categoryName: i18n.tr("System")
+                        }
 
-                    UncategorizedItemsView {
-                        model: pluginManager.itemModel("uncategorized-bottom")
+                        UncategorizedItemsView {
+                            model: pluginManager.itemModel("uncategorized-bottom")
+                        }
                     }
                 }
             }
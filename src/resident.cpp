@@ -0,0 +1,197 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resident.h"
+#include "debug.h"
+#include "utils.h"
+
+#include <QCoreApplication>
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDBusMessage>
+#include <QGuiApplication>
+#include <QQmlContext>
+#include <QQmlEngine>
+#include <QQuickItem>
+#include <QQuickView>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#define RESIDENT_SERVICE "com.canonical.SystemSettings.Resident"
+#define RESIDENT_PATH "/com/canonical/SystemSettings/Resident"
+// Don't keep a launch waiting on a resident instance that is stuck.
+#define FORWARD_TIMEOUT 2000
+/* Wake up when tasks were stalled on memory for 300 ms in any two seconds,
+ * as described in the kernel's pressure stall information documentation.
+ * Without CAP_SYS_RESOURCE, the window must be a multiple of two seconds. */
+#define PRESSURE_TRIGGER "some 300000 2000000"
+
+using namespace SystemSettings;
+
+ResidentService::ResidentService(QQuickView *view, int idleTimeout,
+                                 QObject *parent):
+    QObject(parent),
+    m_view(view),
+    m_pressureFd(-1)
+{
+    m_idleTimer.setSingleShot(true);
+    m_idleTimer.setInterval(idleTimeout * 1000);
+    QObject::connect(&m_idleTimer, SIGNAL(timeout()),
+                     this, SLOT(Release()));
+    QObject::connect(m_view, SIGNAL(visibleChanged(bool)),
+                     this, SLOT(onVisibleChanged(bool)));
+}
+
+ResidentService::~ResidentService()
+{
+    m_pressureNotifier.reset();
+    if (m_pressureFd >= 0)
+        close(m_pressureFd);
+}
+
+bool ResidentService::forward(const QStringList &arguments)
+{
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    if (!bus.interface()->isServiceRegistered(RESIDENT_SERVICE))
+        return false;
+
+    QDBusMessage message = QDBusMessage::createMethodCall(
+        RESIDENT_SERVICE, RESIDENT_PATH, RESIDENT_SERVICE, "Open");
+    message << arguments;
+    QDBusMessage reply = bus.call(message, QDBus::Block, FORWARD_TIMEOUT);
+    if (reply.type() == QDBusMessage::ErrorMessage) {
+        qWarning() << "Resident instance didn't take the launch:"
+                   << reply.errorMessage();
+        return false;
+    }
+    return true;
+}
+
+bool ResidentService::registerService()
+{
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    if (!bus.registerObject(RESIDENT_PATH, this,
+                            QDBusConnection::ExportScriptableSlots))
+        return false;
+    if (!bus.registerService(RESIDENT_SERVICE)) {
+        bus.unregisterObject(RESIDENT_PATH);
+        return false;
+    }
+
+    // Closing the window only hides it.
+    QGuiApplication::setQuitOnLastWindowClosed(false);
+    // Only the resident instance gives way to memory pressure.
+    watchMemoryPressure();
+    return true;
+}
+
+void ResidentService::Open(const QStringList &arguments)
+{
+    QString defaultPlugin;
+    QVariantMap pluginOptions;
+    parsePluginOptions(arguments, defaultPlugin, pluginOptions);
+    DEBUG() << "Resident launch of" << defaultPlugin << pluginOptions;
+
+    // What a fresh instance would have been started with.
+    QQmlContext *context = m_view->rootContext();
+    context->setContextProperty("defaultPlugin", defaultPlugin);
+    context->setContextProperty("pluginOptions", pluginOptions);
+
+    QQuickItem *root = m_view->rootObject();
+    if (!root)
+        return;
+
+    if (defaultPlugin.isEmpty()) {
+        QMetaObject::invokeMethod(root, "showMainPage");
+    } else {
+        QVariant loaded;
+        QMetaObject::invokeMethod(root, "loadPluginByName",
+                                  Q_RETURN_ARG(QVariant, loaded),
+                                  Q_ARG(QVariant, defaultPlugin),
+                                  Q_ARG(QVariant, pluginOptions));
+        // A fresh instance would quit; stay hidden instead.
+        if (!loaded.toBool())
+            return;
+    }
+
+    m_view->show();
+    m_view->raise();
+    m_view->requestActivate();
+}
+
+void ResidentService::Release()
+{
+    if (m_view->isVisible())
+        return;
+    DEBUG() << "Releasing the resident instance";
+    QCoreApplication::quit();
+}
+
+void ResidentService::hide()
+{
+    m_view->hide();
+}
+
+void ResidentService::onVisibleChanged(bool visible)
+{
+    if (visible) {
+        m_idleTimer.stop();
+        return;
+    }
+
+    /* Keep the engine and its components, but give back the scene graph's
+     * textures and the objects the pages left behind. */
+    m_view->releaseResources();
+    m_view->engine()->collectGarbage();
+    m_idleTimer.start();
+}
+
+void ResidentService::onMemoryPressure()
+{
+    DEBUG() << "Memory pressure while resident";
+    Release();
+}
+
+void ResidentService::watchMemoryPressure()
+{
+    // Linux 4.20 and later.
+    m_pressureFd = open("/proc/pressure/memory", O_RDWR | O_NONBLOCK);
+    if (m_pressureFd < 0) {
+        qWarning() << "Not releasing on memory pressure: can't open"
+                   << "/proc/pressure/memory:" << strerror(errno);
+        return;
+    }
+
+    const char trigger[] = PRESSURE_TRIGGER;
+    if (write(m_pressureFd, trigger, strlen(trigger) + 1) < 0) {
+        qWarning() << "Not releasing on memory pressure: can't set trigger"
+                   << PRESSURE_TRIGGER ":" << strerror(errno);
+        close(m_pressureFd);
+        m_pressureFd = -1;
+        return;
+    }
+
+    // The kernel signals the trigger as POLLPRI.
+    m_pressureNotifier.reset(new QSocketNotifier(m_pressureFd,
+                                                 QSocketNotifier::Exception));
+    QObject::connect(m_pressureNotifier.data(), SIGNAL(activated(int)),
+                     this, SLOT(onMemoryPressure()));
+}
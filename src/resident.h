@@ -0,0 +1,80 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYSTEM_SETTINGS_RESIDENT_H
+#define SYSTEM_SETTINGS_RESIDENT_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QSocketNotifier>
+#include <QStringList>
+#include <QTimer>
+
+class QQuickView;
+
+namespace SystemSettings {
+
+/* Keeps system-settings running after its window is closed, with the QML
+ * engine, the plugin manager and the compiled components still loaded, so
+ * that the next launch only has to show the window again. Later launches
+ * find the resident instance on the session bus, hand it their arguments
+ * with Open() and exit straight away.
+ *
+ * The resident instance quits once it has been hidden for the idle timeout,
+ * when the kernel reports memory pressure (through /proc/pressure/memory,
+ * where available) while it is hidden, or when Release() is called.
+ *
+ * Enabled by setting SS_RESIDENT to the idle timeout in seconds. */
+class ResidentService: public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.canonical.SystemSettings.Resident")
+
+public:
+    ResidentService(QQuickView *view, int idleTimeout, QObject *parent = 0);
+    ~ResidentService();
+
+    /* Passes arguments to the resident instance, if there is one; returns
+     * whether it took them. */
+    static bool forward(const QStringList &arguments);
+    /* Returns false if another instance got there first. Memory pressure
+     * is only watched once registered. */
+    bool registerService();
+
+public Q_SLOTS:
+    Q_SCRIPTABLE void Open(const QStringList &arguments);
+    Q_SCRIPTABLE void Release();
+    // Hides the window instead of quitting.
+    void hide();
+
+private Q_SLOTS:
+    void onVisibleChanged(bool visible);
+    void onMemoryPressure();
+
+private:
+    void watchMemoryPressure();
+
+    QQuickView *m_view;
+    QTimer m_idleTimer;
+    int m_pressureFd;
+    QScopedPointer<QSocketNotifier> m_pressureNotifier;
+};
+
+} // namespace
+
+#endif // SYSTEM_SETTINGS_RESIDENT_H
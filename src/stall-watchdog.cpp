@@ -0,0 +1,213 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stall-watchdog.h"
+#include "debug.h"
+
+#include <QBuffer>
+#include <QFile>
+#include <QTextStream>
+
+#include <SystemSettings/BlockingCall>
+
+#include <algorithm>
+#include <execinfo.h>
+#include <signal.h>
+#include <stdlib.h>
+
+#define STACK_SIGNAL SIGRTMIN
+#define MAX_FRAMES 32
+// How long the GUI thread gets to answer the signal.
+#define CAPTURE_TIMEOUT 100
+
+using namespace SystemSettings;
+
+static void *stackFrames[MAX_FRAMES];
+static volatile sig_atomic_t stackFrameCount = 0;
+static QAtomicInt stackCaptured;
+
+// Runs on the GUI thread, interrupting whatever it is blocked in.
+static void captureHandler(int)
+{
+    stackFrameCount = backtrace(stackFrames, MAX_FRAMES);
+    stackCaptured.storeRelease(1);
+}
+
+StallWatchdog::StallWatchdog(int threshold, QObject *parent):
+    QThread(parent),
+    m_threshold(threshold),
+    m_guiThread(pthread_self()),
+    m_lastBeat(0),
+    m_stop(false),
+    m_inStall(false),
+    m_stallBeat(0)
+{
+    /* backtrace() loads libgcc the first time it runs, which must not
+     * happen in the signal handler. */
+    void *frame;
+    backtrace(&frame, 1);
+
+    struct sigaction action;
+    action.sa_handler = captureHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(STACK_SIGNAL, &action, 0);
+
+    m_clock.start();
+    m_beatTimer.setInterval(qMax(m_threshold / 2, 1));
+    QObject::connect(&m_beatTimer, SIGNAL(timeout()), this, SLOT(beat()));
+    m_beatTimer.start();
+
+    start(QThread::LowPriority);
+}
+
+StallWatchdog::~StallWatchdog()
+{
+    stop();
+
+    QByteArray path = qgetenv("SS_STALL_REPORT");
+    if (!path.isEmpty()) {
+        QFile file(QFile::decodeName(path));
+        if (file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            writeReport(&file);
+        else
+            qWarning() << "Can't write stall report" << file.fileName()
+                       << file.errorString();
+        return;
+    }
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    writeReport(&buffer);
+    Q_FOREACH(const QByteArray &line, buffer.data().split('\n'))
+        qWarning("%s", line.constData());
+}
+
+void StallWatchdog::beat()
+{
+    m_lastBeat.storeRelease(m_clock.elapsed());
+}
+
+void StallWatchdog::stop()
+{
+    m_mutex.lock();
+    m_stop = true;
+    m_stopped.wakeAll();
+    m_mutex.unlock();
+
+    wait();
+    m_beatTimer.stop();
+}
+
+void StallWatchdog::run()
+{
+    const int interval = qMax(m_threshold / 2, 1);
+    QMutexLocker locker(&m_mutex);
+
+    while (!m_stop) {
+        m_stopped.wait(&m_mutex, qMax(m_threshold / 4, 10));
+        if (m_stop)
+            break;
+
+        const int lastBeat = m_lastBeat.loadAcquire();
+        if (m_inStall) {
+            // The event loop is back; a beat is due as soon as it runs.
+            if (lastBeat != m_stallBeat) {
+                addStall(lastBeat - m_stallBeat - interval);
+                m_inStall = false;
+            }
+        } else if (m_clock.elapsed() - lastBeat - interval > m_threshold) {
+            m_inStall = true;
+            m_stallBeat = lastBeat;
+            locker.unlock();
+            captureStack(&m_stallCall, &m_stallStack);
+            locker.relock();
+        }
+    }
+
+    // Still stalled when quitting.
+    if (m_inStall)
+        addStall(m_clock.elapsed() - m_stallBeat - interval);
+}
+
+void StallWatchdog::captureStack(QString *call, QStringList *stack)
+{
+    *call = QString::fromUtf8(BlockingCall::current());
+    stack->clear();
+
+    stackCaptured.storeRelease(0);
+    if (pthread_kill(m_guiThread, STACK_SIGNAL) != 0)
+        return;
+
+    for (int i = 0; i < CAPTURE_TIMEOUT && !stackCaptured.loadAcquire(); i++)
+        QThread::msleep(1);
+    if (!stackCaptured.loadAcquire())
+        return;
+
+    /* Symbols are not demangled; pipe the report through c++filt. The first
+     * two frames are the handler and the signal trampoline. */
+    char **symbols = backtrace_symbols(stackFrames, stackFrameCount);
+    if (!symbols)
+        return;
+    for (int i = 2; i < stackFrameCount; i++)
+        stack->append(QString::fromLocal8Bit(symbols[i]));
+    free(symbols);
+}
+
+void StallWatchdog::addStall(qint64 duration)
+{
+    const QString key = m_stallCall + '\n' + m_stallStack.join('\n');
+    Stall &stall = m_stalls[key];
+    stall.call = m_stallCall;
+    stall.stack = m_stallStack;
+    stall.count++;
+    stall.total += duration;
+    stall.longest = qMax(stall.longest, duration);
+
+    DEBUG() << "GUI thread stalled for" << duration << "ms in"
+            << (m_stallCall.isEmpty() ? "an unnamed call" : m_stallCall);
+}
+
+void StallWatchdog::writeReport(QIODevice *device) const
+{
+    QMutexLocker locker(&m_mutex);
+    QList<Stall> stalls = m_stalls.values();
+    locker.unlock();
+
+    std::sort(stalls.begin(), stalls.end(),
+              [](const Stall &a, const Stall &b) {
+        return a.total > b.total;
+    });
+
+    QTextStream out(device);
+    if (stalls.isEmpty()) {
+        out << "No GUI thread stalls over " << m_threshold << " ms\n";
+        return;
+    }
+
+    out << "GUI thread stalls over " << m_threshold << " ms, worst first:\n";
+    for (int i = 0; i < stalls.count(); i++) {
+        const Stall &stall = stalls.at(i);
+        out << "\n" << i + 1 << ". "
+            << (stall.call.isEmpty() ? "(unnamed call)" : stall.call)
+            << ": " << stall.count << " stalls, " << stall.total
+            << " ms in total, longest " << stall.longest << " ms\n";
+        Q_FOREACH(const QString &frame, stall.stack)
+            out << "    " << frame << "\n";
+    }
+}
@@ -0,0 +1,93 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYSTEM_SETTINGS_STALL_WATCHDOG_H
+#define SYSTEM_SETTINGS_STALL_WATCHDOG_H
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QStringList>
+#include <QThread>
+#include <QTimer>
+#include <QWaitCondition>
+
+#include <pthread.h>
+
+namespace SystemSettings {
+
+/* Watches the GUI thread's event loop from a thread of its own. A timer on
+ * the GUI thread beats every half threshold; when a beat is more than the
+ * threshold late, the GUI thread's stack and the innermost BlockingCall
+ * are captured. Stalls with the same call and stack are added up, and the
+ * report, worst first, is written when the watchdog is destroyed.
+ *
+ * Enabled by setting SS_STALL_WATCHDOG to the threshold in milliseconds;
+ * the report goes to the file named by SS_STALL_REPORT, or to the log. */
+class StallWatchdog: public QThread
+{
+    Q_OBJECT
+
+public:
+    // Must be created on the GUI thread.
+    explicit StallWatchdog(int threshold, QObject *parent = 0);
+    ~StallWatchdog();
+
+    void writeReport(QIODevice *device) const;
+
+protected:
+    void run() Q_DECL_OVERRIDE;
+
+private Q_SLOTS:
+    void beat();
+
+private:
+    struct Stall {
+        QString call;
+        QStringList stack;
+        int count = 0;
+        qint64 total = 0;
+        qint64 longest = 0;
+    };
+
+    void stop();
+    void captureStack(QString *call, QStringList *stack);
+    void addStall(qint64 duration);
+
+    int m_threshold;
+    pthread_t m_guiThread;
+    QElapsedTimer m_clock;
+    QTimer m_beatTimer;
+    QAtomicInt m_lastBeat;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_stopped;
+    bool m_stop;
+
+    // Owned by the watchdog thread while it runs.
+    bool m_inStall;
+    int m_stallBeat;
+    QString m_stallCall;
+    QStringList m_stallStack;
+    QHash<QString, Stall> m_stalls;
+};
+
+} // namespace
+
+#endif // SYSTEM_SETTINGS_STALL_WATCHDOG_H
@@ -24,12 +24,22 @@
 
 #include "systemimage.h"
 #include "i18n.h"
+#include <QCoreApplication>
 #include <QEvent>
 #include <QDateTime>
 #include <QDBusReply>
 #include <QDBusPendingReply>
 #include <unistd.h>
 
+#include <SystemSettings/BlockingCall>
+#include <SystemSettings/DBusStats>
+
+namespace {
+const QString SystemImageService = QStringLiteral("com.canonical.SystemImage");
+const QString SystemImagePath = QStringLiteral("/Service");
+const QString SystemImageInterface = QStringLiteral("com.canonical.SystemImage");
+}
+
 QSystemImage::QSystemImage(QObject *parent)
     : QSystemImage(QDBusConnection::systemBus(), parent)
 {
@@ -37,147 +47,147 @@ QSystemImage::QSystemImage(QObject *parent)
 
 QSystemImage::QSystemImage(const QDBusConnection &dbus, QObject *parent)
     : QObject(parent)
-    , m_watcher("com.canonical.SystemImage", dbus,
+    , m_dbus(dbus)
+    , m_watcher(SystemImageService, dbus,
                 QDBusServiceWatcher::WatchForOwnerChange)
-    , m_iface("com.canonical.SystemImage", "/Service",
-              "com.canonical.SystemImage", dbus)
 {
     qDBusRegisterMetaType<QMap<QString, QString> >();
     connect(&m_watcher, SIGNAL(serviceOwnerChanged(QString, QString, QString)),
             this, SLOT(slotNameOwnerChanged(QString, QString, QString)));
     setUpInterface();
+    initializeProperties();
 }
 
 QSystemImage::~QSystemImage() {
 }
 
+QSystemImage *QSystemImage::instance()
+{
+    static QSystemImage *systemImage = nullptr;
+    if (!systemImage) {
+        systemImage = new QSystemImage(QCoreApplication::instance());
+    }
+    return systemImage;
+}
+
+bool QSystemImage::ready() const
+{
+    return m_ready;
+}
+
 void QSystemImage::slotNameOwnerChanged(const QString &name,
                                         const QString &oldOwner,
                                         const QString &newOwner) {
     Q_UNUSED (oldOwner);
-    Q_UNUSED (newOwner);
 
-    if (name != "com.canonical.SystemImage")
+    if (name != SystemImageService)
         return;
 
-    if (m_iface.isValid())
-        setUpInterface();
+    /* Whatever we read belonged to the previous owner. Drop any replies
+    still in flight and read the properties again from the new one. */
+    if (m_ready) {
+        m_ready = false;
+        Q_EMIT readyChanged();
+    }
+
+    if (newOwner.isEmpty())
+        m_initGeneration++;
+    else
+        initializeProperties();
 }
 
 void QSystemImage::setUpInterface() {
-    initializeProperties();
-
-    if (m_iface.metaObject()->indexOfSignal("UpdateDownloaded()") == -1) {
-        qWarning() << "Unable to locate signal on s-i interface. "
-                      "Will not connect to s-i events.";
-        return;
-    }
-
-    connect(&m_iface,
-        SIGNAL(UpdateAvailableStatus(const bool, const bool, const QString&,
-                                     const int&, const QString&,
-                                     const QString&)),
-        this,
-        SIGNAL(updateAvailableStatus(const bool, const bool, const QString&,
-                                     const int&, const QString&,
-                                     const QString&))
-    );
-    connect(&m_iface,
-        SIGNAL(UpdateAvailableStatus(const bool, const bool, const QString&,
-                                     const int&, const QString&,
-                                     const QString&)),
-        this,
-        SLOT(availableStatusChanged(const bool, const bool, const QString&,
-                                    const int&, const QString&,
-                                    const QString&))
-    );
-    connect(&m_iface, SIGNAL(UpdateProgress(int, double)),
-                this, SIGNAL(updateProgress(int, double)));
-    connect(&m_iface, SIGNAL(UpdateProgress(int, double)),
-                this, SIGNAL(updateProgress(int, double)));
-    connect(&m_iface, SIGNAL(UpdatePaused(int)),
-                this, SIGNAL(updatePaused(int)));
-    connect(&m_iface, SIGNAL(DownloadStarted()),
-                this, SIGNAL(downloadStarted()));
-    connect(&m_iface, SIGNAL(UpdateDownloaded()),
-                this, SIGNAL(updateDownloaded()));
-    connect(&m_iface, SIGNAL(UpdateFailed(int, QString)),
-                this, SIGNAL(updateFailed(int, QString)));
-    connect(&m_iface, SIGNAL(Rebooting(bool)),
-                this, SIGNAL(rebooting(bool)));
-
-    connect(&m_iface, SIGNAL(SettingChanged(QString, QString)),
-                this, SLOT(settingsChanged(QString, QString)));
+    auto connectSignal = [this](const QString &signal, const char *member) {
+        if (!m_dbus.connect(SystemImageService, SystemImagePath,
+                            SystemImageInterface, signal, this, member)) {
+            qWarning() << "Unable to connect to s-i signal" << signal
+                       << m_dbus.lastError().message();
+        }
+    };
+
+    connectSignal("UpdateAvailableStatus",
+        SIGNAL(updateAvailableStatus(bool, bool, QString, int, QString,
+                                     QString)));
+    connectSignal("UpdateAvailableStatus",
+        SLOT(availableStatusChanged(bool, bool, QString, int, QString,
+                                    QString)));
+    connectSignal("UpdateProgress", SIGNAL(updateProgress(int, double)));
+    connectSignal("UpdatePaused", SIGNAL(updatePaused(int)));
+    connectSignal("DownloadStarted", SIGNAL(downloadStarted()));
+    connectSignal("UpdateDownloaded", SIGNAL(updateDownloaded()));
+    connectSignal("UpdateFailed", SIGNAL(updateFailed(int, QString)));
+    connectSignal("Rebooting", SIGNAL(rebooting(bool)));
+    connectSignal("SettingChanged", SLOT(settingsChanged(QString, QString)));
 }
 
 void QSystemImage::factoryReset() {
-    m_iface.asyncCall("FactoryReset");
+    asyncCallService("FactoryReset");
 }
 
 void QSystemImage::productionReset() {
-    m_iface.asyncCall("ProductionReset");
+    asyncCallService("ProductionReset");
 }
 
 void QSystemImage::checkForUpdate() {
-    m_iface.asyncCall("CheckForUpdate");
+    asyncCallService("CheckForUpdate");
     setCheckingForUpdates(true);
 }
 
 void QSystemImage::downloadUpdate() {
     qWarning() << Q_FUNC_INFO;
-    m_iface.asyncCall("DownloadUpdate");
+    asyncCallService("DownloadUpdate");
 }
 
 void QSystemImage::forceAllowGSMDownload() {
-    m_iface.asyncCall("ForceAllowGSMDownload");
+    asyncCallService("ForceAllowGSMDownload");
 }
 
 QStringList QSystemImage::getChannels()
 {
-    QDBusReply<QStringList> answer = m_iface.call("GetChannels");
+    QDBusReply<QStringList> answer = callService("GetChannels");
     return answer.value();
 }
 
 void QSystemImage::setSwitchChannel(QString channel)
 {
-    m_iface.asyncCall("SetChannel", channel);
+    asyncCallService("SetChannel", channel);
     m_switchChannel = channel;
 }
 
 void QSystemImage::setSwitchBuild(int build)
 {
-    m_iface.asyncCall("SetBuild", build);
+    asyncCallService("SetBuild", build);
     m_switchBuild = build;
 }
 
 int QSystemImage::getSwitchBuild()
 {
-  QDBusReply<int> answer = m_iface.call("GetBuild");
+  QDBusReply<int> answer = callService("GetBuild");
   return answer.value();
 }
 
 QString QSystemImage::getSwitchChannel()
 {
-  QDBusReply<QString> answer = m_iface.call("GetChannel");
+  QDBusReply<QString> answer = callService("GetChannel");
   return answer.value();
 }
 
 bool QSystemImage::supportsFirmwareUpdate()
 {
-  QDBusReply<bool> answer = m_iface.call("SupportsFirmwareUpdate");
+  QDBusReply<bool> answer = callService("SupportsFirmwareUpdate");
   return answer.value();
 }
 
 void QSystemImage::checkForFirmwareUpdate()
 {
-  auto pcall = m_iface.asyncCall("CheckForFirmwareUpdate");
+  auto pcall = asyncCallService("CheckForFirmwareUpdate");
   auto *watcher = new QDBusPendingCallWatcher(pcall, this);
   QObject::connect(watcher, SIGNAL(finished(QDBusPendingCallWatcher*)),
                    this, SLOT(checkForFirmwareUpdateSlot(QDBusPendingCallWatcher*)));
 }
 void QSystemImage::updateFirmware()
 {
-  auto pcall = m_iface.asyncCall("UpdateFirmware");
+  auto pcall = asyncCallService("UpdateFirmware");
   auto *watcher = new QDBusPendingCallWatcher(pcall, this);
   QObject::connect(watcher, SIGNAL(finished(QDBusPendingCallWatcher*)),
                    this, SLOT(updateFirmwareSlot(QDBusPendingCallWatcher*)));
@@ -185,7 +195,7 @@ void QSystemImage::updateFirmware()
 
 void QSystemImage::reboot()
 {
-  m_iface.asyncCall("Reboot");
+  asyncCallService("Reboot");
 }
 
 void QSystemImage::checkForFirmwareUpdateSlot(QDBusPendingCallWatcher *call)
@@ -211,7 +221,7 @@ void QSystemImage::updateFirmwareSlot(QDBusPendingCallWatcher *call)
 }
 
 void QSystemImage::applyUpdate() {
-    QDBusReply<QString> reply = m_iface.call("ApplyUpdate");
+    QDBusReply<QString> reply = callService("ApplyUpdate");
     if (reply.isValid()) {
         Q_EMIT updateProcessing();
     } else {
@@ -220,7 +230,8 @@ void QSystemImage::applyUpdate() {
 }
 
 QString QSystemImage::cancelUpdate() {
-    QDBusPendingReply<QString> reply = m_iface.call("CancelUpdate");
+    SystemSettings::BlockingCall blocking("QSystemImage::CancelUpdate");
+    QDBusPendingReply<QString> reply = callService("CancelUpdate");
     reply.waitForFinished();
     if (reply.isValid()) {
         setCheckingForUpdates(false);
@@ -234,7 +245,8 @@ QString QSystemImage::cancelUpdate() {
 }
 
 QString QSystemImage::pauseDownload() {
-    QDBusPendingReply<QString> reply = m_iface.call("PauseDownload");
+    SystemSettings::BlockingCall blocking("QSystemImage::PauseDownload");
+    QDBusPendingReply<QString> reply = callService("PauseDownload");
     reply.waitForFinished();
     if (reply.isValid()) {
         return reply.argumentAt<0>();
@@ -247,9 +259,76 @@ QString QSystemImage::pauseDownload() {
 }
 
 void QSystemImage::initializeProperties() {
-    QDBusPendingReply<QMap<QString, QString> > reply
-        = m_iface.call("Information");
-    reply.waitForFinished();
+    /* Issue all calls up front, so that we wait for a slow (or still
+    activating) service once rather than once per call. Replies to an
+    earlier round, e.g. before the service owner changed, are dropped. */
+    m_initGeneration++;
+    m_pendingInitCalls = 3;
+
+    auto pcall = asyncCallService("Information");
+    auto *watcher = new QDBusPendingCallWatcher(pcall, this);
+    watcher->setProperty("generation", m_initGeneration);
+    QObject::connect(watcher, SIGNAL(finished(QDBusPendingCallWatcher*)),
+                     this, SLOT(informationSlot(QDBusPendingCallWatcher*)));
+
+    getSetting("auto_download", 1);
+    getSetting("failures_before_warning", 3);
+}
+
+void QSystemImage::getSetting(const QString &setting, const int &defaultValue)
+{
+    auto pcall = asyncCallService("GetSetting", setting);
+    auto *watcher = new QDBusPendingCallWatcher(pcall, this);
+    watcher->setProperty("generation", m_initGeneration);
+    watcher->setProperty("setting", setting);
+    watcher->setProperty("defaultValue", defaultValue);
+    QObject::connect(watcher, SIGNAL(finished(QDBusPendingCallWatcher*)),
+                     this, SLOT(settingSlot(QDBusPendingCallWatcher*)));
+}
+
+QDBusMessage QSystemImage::methodCall(const QString &method,
+                                      const QVariant &arg1,
+                                      const QVariant &arg2) const
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(
+        SystemImageService, SystemImagePath, SystemImageInterface, method
+    );
+    QVariantList arguments;
+    if (arg1.isValid())
+        arguments << arg1;
+    if (arg2.isValid())
+        arguments << arg2;
+    message.setArguments(arguments);
+    return message;
+}
+
+QDBusMessage QSystemImage::callService(const QString &method)
+{
+    SystemSettings::DBusStats::Call stats(nullptr, SystemImageService, method);
+    return m_dbus.call(methodCall(method));
+}
+
+QDBusPendingCall QSystemImage::asyncCallService(const QString &method,
+                                                const QVariant &arg1,
+                                                const QVariant &arg2)
+{
+    QDBusPendingCall call = m_dbus.asyncCall(methodCall(method, arg1, arg2));
+    SystemSettings::DBusStats::watch(call, nullptr, SystemImageService, method);
+    return call;
+}
+
+bool QSystemImage::isCurrentInitCall(QDBusPendingCallWatcher *call) const
+{
+    return call->property("generation").toInt() == m_initGeneration;
+}
+
+void QSystemImage::informationSlot(QDBusPendingCallWatcher *call)
+{
+    call->deleteLater();
+    if (!isCurrentInitCall(call))
+        return;
+
+    QDBusPendingReply<QMap<QString, QString> > reply = *call;
     if (reply.isValid()) {
         QMap<QString, QString> result = reply.argumentAt<0>();
 
@@ -268,7 +347,8 @@ void QSystemImage::initializeProperties() {
         );
         for (int i = 0; i < keyvalue.size(); ++i) {
             QStringList pair = keyvalue.at(i).split("=");
-            details[pair[0]] = QVariant(pair[1]);
+            if (pair.size() == 2)
+                details[pair[0]] = QVariant(pair[1]);
         }
         setDetailedVersionDetails(details);
     } else {
@@ -276,29 +356,48 @@ void QSystemImage::initializeProperties() {
                    << reply.error();
     }
 
-    m_downloadMode = getSetting("auto_download", 1);
-    Q_EMIT downloadModeChanged();
-
-    m_failuresBeforeWarning = getSetting("failures_before_warning", 3);
-    Q_EMIT failuresBeforeWarningChanged();
+    initCallFinished();
 }
 
-int QSystemImage::getSetting(const QString &setting, const int &defaultValue)
+void QSystemImage::settingSlot(QDBusPendingCallWatcher *call)
 {
-    QDBusReply<QString> reply = m_iface.call("GetSetting", setting);
-    int ret;
+    call->deleteLater();
+    if (!isCurrentInitCall(call))
+        return;
+
+    const QString setting = call->property("setting").toString();
+    int value = call->property("defaultValue").toInt();
+
+    QDBusPendingReply<QString> reply = *call;
     if (reply.isValid()) {
         bool ok;
-        ret = reply.value().toInt(&ok);
-        if (!ok) {
-            ret = defaultValue;
+        int parsed = reply.argumentAt<0>().toInt(&ok);
+        if (ok) {
+            value = parsed;
         }
     } else {
         qWarning() << "Error getting " << setting
                    << reply.error().message();
-        ret = defaultValue;
     }
-    return ret;
+
+    if (setting == "auto_download") {
+        m_downloadMode = value;
+        Q_EMIT downloadModeChanged();
+    } else if (setting == "failures_before_warning") {
+        m_failuresBeforeWarning = value;
+        Q_EMIT failuresBeforeWarningChanged();
+    }
+
+    initCallFinished();
+}
+
+void QSystemImage::initCallFinished()
+{
+    if (--m_pendingInitCalls > 0 || m_ready)
+        return;
+
+    m_ready = true;
+    Q_EMIT readyChanged();
 }
 
 bool QSystemImage::checkTarget() const
@@ -405,8 +504,8 @@ void QSystemImage::setDownloadMode(const int &downloadMode) {
     }
 
     m_downloadMode = downloadMode;
-    m_iface.asyncCall("SetSetting", "auto_download",
-                      QString::number(downloadMode));
+    asyncCallService("SetSetting", "auto_download",
+                     QString::number(downloadMode));
 }
 
 int QSystemImage::failuresBeforeWarning()
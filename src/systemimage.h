@@ -25,7 +25,8 @@
 #ifndef QSYSTEMIMAGE_H
 #define QSYSTEMIMAGE_H
 
-#include <QDBusInterface>
+#include <QDBusConnection>
+#include <QDBusMessage>
 #include <QDBusServiceWatcher>
 #include <QDBusPendingCallWatcher>
 #include <QObject>
@@ -69,11 +70,21 @@ class QSystemImage : public QObject
                NOTIFY errorReasonChanged)
     Q_PROPERTY(QString versionTag READ versionTag
                NOTIFY versionTagChanged)
+    Q_PROPERTY(bool ready READ ready NOTIFY readyChanged)
 public:
     explicit QSystemImage(QObject *parent = nullptr);
     explicit QSystemImage(const QDBusConnection &dbus, QObject *parent = nullptr);
     ~QSystemImage();
 
+    /* Process-wide instance on the system bus. Plugins should use this
+    rather than constructing their own, so system-image is only queried
+    once. */
+    static QSystemImage *instance();
+
+    /* Whether the initial Information and settings replies have arrived.
+    Until then properties hold their defaults. */
+    bool ready() const;
+
     bool checkingForUpdates() const;
     int downloadMode();
     void setDownloadMode(const int &downloadMode);
@@ -135,6 +146,7 @@ Q_SIGNALS:
     void updateSizeChanged();
     void errorReasonChanged();
     void versionTagChanged();
+    void readyChanged();
     void downloadModeChanged();
     void updateProcessFailed(const QString &reason);
     void updateProcessing();
@@ -158,6 +170,8 @@ Q_SIGNALS:
 protected Q_SLOTS:
     void checkForFirmwareUpdateSlot(QDBusPendingCallWatcher *call);
     void updateFirmwareSlot(QDBusPendingCallWatcher *call);
+    void informationSlot(QDBusPendingCallWatcher *call);
+    void settingSlot(QDBusPendingCallWatcher *call);
     void slotNameOwnerChanged(const QString&, const QString&, const QString&);
     void settingsChanged(const QString &key, const QString &newvalue);
     void availableStatusChanged(const bool isAvailable,
@@ -182,11 +196,25 @@ protected:
     void setErrorReason(const QString &errorReason);
 
 private:
-    // Synchronously initialize properties from the Information call.
+    // Asynchronously initialize properties from Information and settings.
     void initializeProperties();
-    // Sets up connections on the DBus interface.
+    /* Connects to the service's signals. Done once; match rules outlive
+    the service owner. */
     void setUpInterface();
-    int getSetting(const QString &setting, const int &defaultValue);
+    void getSetting(const QString &setting, const int &defaultValue);
+    // Whether call belongs to the latest initializeProperties().
+    bool isCurrentInitCall(QDBusPendingCallWatcher *call) const;
+    void initCallFinished();
+    /* Calls on the service, counted by DBusStats. Messages are built by
+    hand rather than through QDBusInterface, which would introspect (and
+    so activate) the service synchronously on construction. */
+    QDBusMessage methodCall(const QString &method,
+                            const QVariant &arg1 = QVariant(),
+                            const QVariant &arg2 = QVariant()) const;
+    QDBusMessage callService(const QString &method);
+    QDBusPendingCall asyncCallService(const QString &method,
+                                      const QVariant &arg1 = QVariant(),
+                                      const QVariant &arg2 = QVariant());
 
     bool m_checkingForUpdates = false;
     int m_currentBuildNumber = 0;
@@ -195,9 +223,8 @@ private:
     int m_downloadMode = -1;
     int m_failuresBeforeWarning = -1;
 
-    // QDBusConnection m_dbus;
+    QDBusConnection m_dbus;
     QDBusServiceWatcher m_watcher;
-    QDBusInterface m_iface;
 
     QDateTime m_lastCheckDate = QDateTime();
     QString m_channelName = QString();
@@ -211,6 +238,10 @@ private:
 
     QString m_switchChannel;
     int m_switchBuild;
+
+    bool m_ready = false;
+    int m_initGeneration = 0;
+    int m_pendingInitCalls = 0;
 };
 
 #endif // QSYSTEMIMAGE_H
@@ -0,0 +1,338 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "visibility-predicates.h"
+#include "debug.h"
+#include "plugin.h"
+
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDBusServiceWatcher>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSet>
+#include <QtConcurrent>
+
+#include <SystemSettings/ItemBase>
+
+#include <gio/gio.h>
+
+using namespace SystemSettings;
+
+static const QLatin1String keyFileExists("file-exists");
+static const QLatin1String keySystemBusName("system-bus-name");
+static const QLatin1String keySessionBusName("session-bus-name");
+static const QLatin1String keyGSettings("gsettings");
+static const QLatin1String keySchema("schema");
+static const QLatin1String keyKey("key");
+static const QLatin1String keyValue("value");
+
+// A string, or a list of them.
+static QStringList toStringList(const QVariant &value)
+{
+    return value.type() == QVariant::String ?
+        QStringList(value.toString()) : value.toStringList();
+}
+
+static QVariant toVariant(GVariant *value)
+{
+    if (g_variant_is_of_type(value, G_VARIANT_TYPE_BOOLEAN))
+        return bool(g_variant_get_boolean(value));
+    if (g_variant_is_of_type(value, G_VARIANT_TYPE_INT32))
+        return int(g_variant_get_int32(value));
+    if (g_variant_is_of_type(value, G_VARIANT_TYPE_UINT32))
+        return uint(g_variant_get_uint32(value));
+    if (g_variant_is_of_type(value, G_VARIANT_TYPE_INT64))
+        return qint64(g_variant_get_int64(value));
+    if (g_variant_is_of_type(value, G_VARIANT_TYPE_DOUBLE))
+        return g_variant_get_double(value);
+    if (g_variant_is_of_type(value, G_VARIANT_TYPE_STRING))
+        return QString::fromUtf8(g_variant_get_string(value, 0));
+    return QVariant();
+}
+
+// Null if the schema isn't installed, instead of aborting like GIO does.
+static GSettings *newSettings(const QString &schema, const QString &key)
+{
+    GSettingsSchemaSource *source = g_settings_schema_source_get_default();
+    if (!source)
+        return 0;
+    GSettingsSchema *found = g_settings_schema_source_lookup(
+        source, schema.toUtf8().constData(), TRUE);
+    if (!found)
+        return 0;
+
+    GSettings *settings = 0;
+    if (g_settings_schema_has_key(found, key.toUtf8().constData()))
+        settings = g_settings_new_full(found, 0, 0);
+    g_settings_schema_unref(found);
+    return settings;
+}
+
+static bool settingHolds(const VisibilityPredicates::Setting &setting)
+{
+    GSettings *settings = newSettings(setting.schema, setting.key);
+    if (!settings)
+        return false;
+
+    GVariant *value = g_settings_get_value(settings,
+                                           setting.key.toUtf8().constData());
+    const QVariant actual = toVariant(value);
+    g_variant_unref(value);
+    g_object_unref(settings);
+
+    return setting.value.isNull() ? actual.toBool() : actual == setting.value;
+}
+
+static void onSettingChanged(GSettings *settings, const gchar *key,
+                             gpointer data)
+{
+    Q_UNUSED(settings);
+    Q_UNUSED(key);
+    QMetaObject::invokeMethod(static_cast<QObject*>(data),
+                              "scheduleEvaluation", Qt::QueuedConnection);
+}
+
+VisibilityPredicates::VisibilityPredicates(QObject *parent):
+    QObject(parent),
+    m_generation(0),
+    m_runningGeneration(0),
+    m_pending(false)
+{
+    // Changes tend to come in bursts, like a package being installed.
+    m_scheduleTimer.setSingleShot(true);
+    m_scheduleTimer.setInterval(100);
+    QObject::connect(&m_scheduleTimer, SIGNAL(timeout()),
+                     this, SLOT(runEvaluation()));
+    QObject::connect(&m_watcher, SIGNAL(finished()),
+                     this, SLOT(onEvaluated()));
+    QObject::connect(&m_files, SIGNAL(directoryChanged(const QString&)),
+                     this, SLOT(scheduleEvaluation()));
+}
+
+VisibilityPredicates::~VisibilityPredicates()
+{
+    clear();
+    m_watcher.waitForFinished();
+}
+
+bool VisibilityPredicates::parse(const QVariantMap &manifest,
+                                 Predicates *predicates)
+{
+    const QVariantMap visibleIf = manifest.value(keyVisibleIf).toMap();
+
+    predicates->files = toStringList(visibleIf.value(keyFileExists));
+    if (manifest.contains(keyVisibleIfFileExists))
+        predicates->files.append(
+            manifest.value(keyVisibleIfFileExists).toString());
+    predicates->systemNames = toStringList(visibleIf.value(keySystemBusName));
+    predicates->sessionNames =
+        toStringList(visibleIf.value(keySessionBusName));
+
+    const QVariant gsettings = visibleIf.value(keyGSettings);
+    QVariantList settings = gsettings.type() == QVariant::List ?
+        gsettings.toList() : QVariantList() << gsettings;
+    predicates->settings.clear();
+    Q_FOREACH(const QVariant &entry, settings) {
+        const QVariantMap map = entry.toMap();
+        if (map.isEmpty())
+            continue;
+        Setting setting;
+        setting.schema = map.value(keySchema).toString();
+        setting.key = map.value(keyKey).toString();
+        setting.value = map.value(keyValue);
+        predicates->settings.append(setting);
+    }
+
+    return !predicates->files.isEmpty() ||
+        !predicates->systemNames.isEmpty() ||
+        !predicates->sessionNames.isEmpty() ||
+        !predicates->settings.isEmpty();
+}
+
+QList<bool> VisibilityPredicates::evaluate(const QList<Predicates> &batch)
+{
+    // Every bus is asked once for all of its names.
+    bool needsSystem = false, needsSession = false;
+    Q_FOREACH(const Predicates &predicates, batch) {
+        needsSystem = needsSystem || !predicates.systemNames.isEmpty();
+        needsSession = needsSession || !predicates.sessionNames.isEmpty();
+    }
+    QSet<QString> systemNames, sessionNames;
+    if (needsSystem) {
+        QDBusConnectionInterface *bus =
+            QDBusConnection::systemBus().interface();
+        if (bus)
+            systemNames = bus->registeredServiceNames().value().toSet();
+    }
+    if (needsSession) {
+        QDBusConnectionInterface *bus =
+            QDBusConnection::sessionBus().interface();
+        if (bus)
+            sessionNames = bus->registeredServiceNames().value().toSet();
+    }
+
+    QHash<QString, bool> files;
+    QList<bool> results;
+    Q_FOREACH(const Predicates &predicates, batch) {
+        bool holds = true;
+        Q_FOREACH(const QString &file, predicates.files) {
+            if (!files.contains(file))
+                files.insert(file, QFile::exists(file));
+            holds = holds && files.value(file);
+        }
+        Q_FOREACH(const QString &name, predicates.systemNames)
+            holds = holds && systemNames.contains(name);
+        Q_FOREACH(const QString &name, predicates.sessionNames)
+            holds = holds && sessionNames.contains(name);
+        Q_FOREACH(const Setting &setting, predicates.settings)
+            holds = holds && settingHolds(setting);
+        results.append(holds);
+    }
+    return results;
+}
+
+void VisibilityPredicates::add(Plugin *plugin, const Predicates &predicates)
+{
+    m_plugins.append(plugin);
+    m_predicates.append(predicates);
+}
+
+void VisibilityPredicates::clear()
+{
+    m_generation++;
+    m_plugins.clear();
+    m_predicates.clear();
+    m_scheduleTimer.stop();
+    m_pending = false;
+
+    if (!m_files.directories().isEmpty())
+        m_files.removePaths(m_files.directories());
+    m_systemNames.reset();
+    m_sessionNames.reset();
+    Q_FOREACH(GSettings *settings, m_settings) {
+        g_signal_handlers_disconnect_by_data(settings, this);
+        g_object_unref(settings);
+    }
+    m_settings.clear();
+}
+
+void VisibilityPredicates::start()
+{
+    if (m_predicates.isEmpty())
+        return;
+    watch();
+    runEvaluation();
+}
+
+void VisibilityPredicates::watch()
+{
+    /* Files are watched through their directories, which also tell when
+     * they are created. */
+    QSet<QString> directories;
+    QSet<QString> systemNames, sessionNames;
+    QSet<QString> settingKeys;
+    Q_FOREACH(const Predicates &predicates, m_predicates) {
+        Q_FOREACH(const QString &file, predicates.files) {
+            const QString directory = QFileInfo(file).absolutePath();
+            if (QDir(directory).exists())
+                directories.insert(directory);
+        }
+        systemNames += predicates.systemNames.toSet();
+        sessionNames += predicates.sessionNames.toSet();
+
+        Q_FOREACH(const Setting &setting, predicates.settings) {
+            const QString id = setting.schema + '/' + setting.key;
+            if (settingKeys.contains(id))
+                continue;
+            settingKeys.insert(id);
+
+            GSettings *settings = newSettings(setting.schema, setting.key);
+            if (!settings)
+                continue;
+            const QByteArray signal = "changed::" + setting.key.toUtf8();
+            g_signal_connect(settings, signal.constData(),
+                             G_CALLBACK(onSettingChanged), this);
+            // GSettings only tells about the keys that were read.
+            g_variant_unref(g_settings_get_value(
+                settings, setting.key.toUtf8().constData()));
+            m_settings.append(settings);
+        }
+    }
+
+    if (!directories.isEmpty())
+        m_files.addPaths(directories.toList());
+
+    QDBusServiceWatcher::WatchMode mode =
+        QDBusServiceWatcher::WatchForRegistration |
+        QDBusServiceWatcher::WatchForUnregistration;
+    if (!systemNames.isEmpty()) {
+        m_systemNames.reset(new QDBusServiceWatcher(
+            QStringList(systemNames.toList()), QDBusConnection::systemBus(),
+            mode));
+        QObject::connect(m_systemNames.data(),
+                         SIGNAL(serviceOwnerChanged(const QString&,
+                                                    const QString&,
+                                                    const QString&)),
+                         this, SLOT(scheduleEvaluation()));
+    }
+    if (!sessionNames.isEmpty()) {
+        m_sessionNames.reset(new QDBusServiceWatcher(
+            QStringList(sessionNames.toList()), QDBusConnection::sessionBus(),
+            mode));
+        QObject::connect(m_sessionNames.data(),
+                         SIGNAL(serviceOwnerChanged(const QString&,
+                                                    const QString&,
+                                                    const QString&)),
+                         this, SLOT(scheduleEvaluation()));
+    }
+}
+
+void VisibilityPredicates::scheduleEvaluation()
+{
+    m_scheduleTimer.start();
+}
+
+void VisibilityPredicates::runEvaluation()
+{
+    if (m_watcher.isRunning()) {
+        m_pending = true;
+        return;
+    }
+
+    m_pending = false;
+    m_runningGeneration = m_generation;
+    m_watcher.setFuture(QtConcurrent::run(&VisibilityPredicates::evaluate,
+                                          m_predicates));
+}
+
+void VisibilityPredicates::onEvaluated()
+{
+    if (m_runningGeneration == m_generation) {
+        const QList<bool> results = m_watcher.result();
+        for (int i = 0; i < results.count() && i < m_plugins.count(); i++) {
+            if (m_plugins.at(i))
+                m_plugins.at(i)->setPredicatesHold(results.at(i));
+        }
+    }
+
+    if (m_pending)
+        runEvaluation();
+}
@@ -0,0 +1,124 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYSTEM_SETTINGS_VISIBILITY_PREDICATES_H
+#define SYSTEM_SETTINGS_VISIBILITY_PREDICATES_H
+
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QScopedPointer>
+#include <QStringList>
+#include <QTimer>
+#include <QVariant>
+
+class QDBusServiceWatcher;
+typedef struct _GSettings GSettings;
+
+namespace SystemSettings {
+
+class Plugin;
+
+/* Evaluates the "visible-if" predicates of the manifests, so that whether
+ * a panel is shown doesn't take loading its plugin:
+ *
+ *     "visible-if": {
+ *         "file-exists": "/etc/dbus-1/system.d/com.canonical.powerd.conf",
+ *         "system-bus-name": "com.canonical.powerd",
+ *         "session-bus-name": "com.canonical.indicator.network",
+ *         "gsettings": {
+ *             "schema": "com.ubuntu.touch.system",
+ *             "key": "auto-brightness-available",
+ *             "value": true
+ *         }
+ *     }
+ *
+ * A panel is shown when all of its predicates hold; "file-exists" and the
+ * bus names also take lists, and a "gsettings" key without a value must
+ * be true. The older "visible-if-file-exists" is a "file-exists".
+ *
+ * The predicates of all panels are evaluated in one batch on a worker
+ * thread, and again when a watched file, bus name or key changes. Plugins
+ * are told the result, and only emit visibilityChanged() when it changed.
+ * Panels that only check for files have them checked when their manifest
+ * is read, so they are there from the first frame. */
+class VisibilityPredicates: public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Setting {
+        QString schema;
+        QString key;
+        QVariant value;
+    };
+
+    struct Predicates {
+        QStringList files;
+        QStringList systemNames;
+        QStringList sessionNames;
+        QList<Setting> settings;
+
+        // Cheap enough to evaluate on the GUI thread.
+        bool filesOnly() const {
+            return systemNames.isEmpty() && sessionNames.isEmpty()
+                && settings.isEmpty();
+        }
+    };
+
+    explicit VisibilityPredicates(QObject *parent = 0);
+    ~VisibilityPredicates();
+
+    // Returns false if the manifest doesn't have any predicates.
+    static bool parse(const QVariantMap &manifest, Predicates *predicates);
+    // Whether each set of predicates holds; safe to call on any thread.
+    static QList<bool> evaluate(const QList<Predicates> &batch);
+
+    void add(Plugin *plugin, const Predicates &predicates);
+    void clear();
+    // Evaluates the predicates added so far, and watches them.
+    void start();
+
+private Q_SLOTS:
+    void scheduleEvaluation();
+    void runEvaluation();
+    void onEvaluated();
+
+private:
+    void watch();
+
+    QList<QPointer<Plugin> > m_plugins;
+    QList<Predicates> m_predicates;
+    // Results of an older batch are dropped.
+    int m_generation;
+    int m_runningGeneration;
+    bool m_pending;
+    QTimer m_scheduleTimer;
+    QFutureWatcher<QList<bool> > m_watcher;
+
+    QFileSystemWatcher m_files;
+    QScopedPointer<QDBusServiceWatcher> m_systemNames;
+    QScopedPointer<QDBusServiceWatcher> m_sessionNames;
+    QList<GSettings*> m_settings;
+};
+
+} // namespace
+
+#endif // SYSTEM_SETTINGS_VISIBILITY_PREDICATES_H
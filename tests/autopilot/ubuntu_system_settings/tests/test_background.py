@@ -76,7 +76,7 @@ class BackgroundTestCase(BackgroundBaseTestCase):
         """Test happy path for changing background"""
 
         # wallpaper source that is selected now
-        old = self.selected_wallpaper.source
+        old = self.selected_wallpaper.uri
 
         # click a wallpaper that is not selected
         self.main_view.scroll_to_and_click(
@@ -86,7 +86,7 @@ class BackgroundTestCase(BackgroundBaseTestCase):
         self.save_wallpaper()
 
         # the newly selected wallpaper source
-        new = self.selected_wallpaper.source
+        new = self.selected_wallpaper.uri
 
         # assert that UI is updated
         self.assertNotEqual(new, old)
@@ -97,7 +97,7 @@ class BackgroundTestCase(BackgroundBaseTestCase):
 
     def test_that_the_currently_selected_background_comes_from_dbus(self):
         """Test that background file from dbus is selected in UI"""
-        current_file = self.selected_wallpaper.source
+        current_file = self.selected_wallpaper.uri
 
         dbus_file = os.path.realpath(self.user_proxy.GetBackgroundFile())
         dbus_file = 'file://%s' % dbus_file
@@ -43,6 +43,11 @@ void MockPluginManager::resetPlugins()
 {
 }
 
+void MockPluginManager::notifyPanelClosed(const QString &name)
+{
+    Q_UNUSED(name);
+}
+
 QString MockPluginManager::getFilter()
 {
     return m_filter;
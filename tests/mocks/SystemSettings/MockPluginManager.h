@@ -40,6 +40,7 @@ public Q_SLOTS:
     QObject* getByName(const QString &name) const;
     QAbstractItemModel* itemModel(const QString &category);
     void resetPlugins();
+    void notifyPanelClosed(const QString &name);
     QString getFilter();
     void setFilter(const QString &filter);
     void addPlugin(const QString &name,
@@ -37,8 +37,3 @@ void MockUpdateModel::reset()
 {
     UpdateModel::reset();
 }
-
-void MockUpdateModelFilter::mockSetSourceModel(MockUpdateModel *source)
-{
-    setSourceModel(source);
-}
@@ -36,13 +36,4 @@ public:
     Q_INVOKABLE void reset();
 };
 
-class MockUpdateModelFilter: public UpdatePlugin::UpdateModelFilter
-{
-    Q_OBJECT
-public:
-    explicit MockUpdateModelFilter(QObject *parent = nullptr)
-        : UpdatePlugin::UpdateModelFilter(parent) {}
-
-    Q_INVOKABLE void mockSetSourceModel(MockUpdateModel *source);
-};
 #endif // MOCK_UPDATE_MODEL_H
@@ -48,7 +48,8 @@ void BackendPlugin::registerTypes(const char *uri)
     qmlRegisterUncreatableType<Update>(uri, 1, 0, "Update", "Used for enums only.");
     qmlRegisterSingletonType<MockSystemImage>(uri, 1, 0, "SystemImage", siSingletonProvider);
     qRegisterMetaType<MockUpdateModel*>("UpdateModel*");
-    qRegisterMetaType<MockUpdateModelFilter*>("UpdateModelFilter*");
+    qRegisterMetaType<UpdateModelView*>("UpdateModelView*");
+    qRegisterMetaType<UpdateHistoryModel*>("UpdateHistoryModel*");
 }
 
 void BackendPlugin::initializeEngine(QQmlEngine *engine, const char *uri)
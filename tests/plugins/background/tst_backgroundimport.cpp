@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2016 Canonical Ltd
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+*/
+
+#include "backgroundimport.h"
+
+#include <QFile>
+#include <QImage>
+#include <QImageReader>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <sys/stat.h>
+
+class TstBackgroundImport : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void init();
+    void cleanup();
+    void testImportInPlace();
+    void testImportLink();
+    void testImportCopy();
+    void testSmallImage();
+    void testWriteScreenFiles();
+
+private:
+    QString writeImage(const QString &name, const QSize &size);
+    static nlink_t linkCount(const QString &file);
+
+    QTemporaryDir *m_dir = nullptr;
+};
+
+// Wider than high, like a photo; the screen is 100x50.
+static const QSize screenSize(100, 50);
+
+void TstBackgroundImport::init()
+{
+    m_dir = new QTemporaryDir();
+    QVERIFY(m_dir->isValid());
+}
+
+void TstBackgroundImport::cleanup()
+{
+    delete m_dir;
+}
+
+QString TstBackgroundImport::writeImage(const QString &name, const QSize &size)
+{
+    const QString path = m_dir->path() + "/" + name;
+    QImage image(size, QImage::Format_RGB32);
+    image.fill(Qt::darkGreen);
+    if (!image.save(path, "PNG"))
+        return QString();
+    return path;
+}
+
+nlink_t TstBackgroundImport::linkCount(const QString &file)
+{
+    struct stat st;
+    if (::stat(QFile::encodeName(file).constData(), &st) != 0)
+        return 0;
+    return st.st_nlink;
+}
+
+void TstBackgroundImport::testImportInPlace()
+{
+    const QString file = writeImage("photo.png", QSize(400, 300));
+    QVERIFY(!file.isEmpty());
+
+    BackgroundImport import(QUrl::fromLocalFile(file), QString(), false,
+                            screenSize, true);
+    QSignalSpy finished(&import, SIGNAL(finished()));
+    import.start();
+    QVERIFY(finished.wait());
+
+    QCOMPARE(import.result(), QUrl::fromLocalFile(file));
+    QVERIFY(import.select());
+
+    // The short side covers the long side of the screen
+    const QString screenFile = BackgroundImport::screenFilePath(file);
+    QCOMPARE(QImageReader(screenFile).size(), QSize(133, 100));
+    QCOMPARE(BackgroundImport::screenFile(file), screenFile);
+    QCOMPARE(BackgroundImport::originalFile(screenFile), file);
+    QCOMPARE(BackgroundImport::originalFile(file), file);
+}
+
+void TstBackgroundImport::testImportLink()
+{
+    const QString file = writeImage("photo.png", QSize(400, 300));
+    QVERIFY(!file.isEmpty());
+    const QString destination = m_dir->path() + "/link.png";
+
+    BackgroundImport import(QUrl::fromLocalFile(file), destination, false,
+                            screenSize, false);
+    QSignalSpy finished(&import, SIGNAL(finished()));
+    import.start();
+    QVERIFY(finished.wait());
+
+    QCOMPARE(import.result(), QUrl::fromLocalFile(destination));
+    QCOMPARE(linkCount(file), nlink_t(2));
+    QVERIFY(QFile::exists(BackgroundImport::screenFilePath(destination)));
+}
+
+void TstBackgroundImport::testImportCopy()
+{
+    const QString file = writeImage("photo.png", QSize(400, 300));
+    QVERIFY(!file.isEmpty());
+
+    /* A file left at the destination makes link() fail, so the import
+     * falls back to copy() as it does across file systems. */
+    const QString destination = m_dir->path() + "/copy.png";
+    QFile stale(destination);
+    QVERIFY(stale.open(QIODevice::WriteOnly));
+    QVERIFY(stale.write("stale") > 0);
+    stale.close();
+
+    BackgroundImport import(QUrl::fromLocalFile(file), destination, false,
+                            screenSize, false);
+    QSignalSpy finished(&import, SIGNAL(finished()));
+    QSignalSpy progress(&import, SIGNAL(progressChanged(qreal)));
+    import.start();
+    QVERIFY(finished.wait());
+
+    QCOMPARE(import.result(), QUrl::fromLocalFile(destination));
+    QCOMPARE(linkCount(file), nlink_t(1));
+    QCOMPARE(linkCount(destination), nlink_t(1));
+    QFile original(file), copy(destination);
+    QVERIFY(original.open(QIODevice::ReadOnly));
+    QVERIFY(copy.open(QIODevice::ReadOnly));
+    QCOMPARE(copy.readAll(), original.readAll());
+    QVERIFY(QFile::exists(BackgroundImport::screenFilePath(destination)));
+
+    QVERIFY(progress.count() > 0);
+    QCOMPARE(progress.last().at(0).toReal(), qreal(1));
+}
+
+void TstBackgroundImport::testSmallImage()
+{
+    // Already small enough: no copy is made
+    const QString file = writeImage("icon.png", QSize(90, 60));
+    QVERIFY(!file.isEmpty());
+
+    QVERIFY(!BackgroundImport::writeScreenFile(file, screenSize));
+    QVERIFY(!QFile::exists(BackgroundImport::screenFilePath(file)));
+    QCOMPARE(BackgroundImport::screenFile(file), file);
+}
+
+void TstBackgroundImport::testWriteScreenFiles()
+{
+    // Wallpapers imported before copies were made
+    const QString first = writeImage("first.png", QSize(400, 300));
+    const QString second = writeImage("second.png", QSize(300, 400));
+    QVERIFY(!first.isEmpty() && !second.isEmpty());
+
+    BackgroundImport::writeScreenFiles(QStringList() << first << second,
+                                       screenSize);
+    QCOMPARE(BackgroundImport::screenFile(first),
+             BackgroundImport::screenFilePath(first));
+    QCOMPARE(QImageReader(BackgroundImport::screenFile(second)).size(),
+             QSize(100, 133));
+
+    // Up to date copies are left alone
+    QVERIFY(BackgroundImport::writeScreenFile(first, screenSize));
+}
+
+QTEST_GUILESS_MAIN(TstBackgroundImport)
+#include "tst_backgroundimport.moc"
@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2016 Canonical Ltd
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+*/
+
+#include "thumbnailer.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QUrl>
+
+#include <utime.h>
+
+class TstThumbnailer : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void testFileFromId_data();
+    void testFileFromId();
+    void testFlavourSize();
+    void testCacheMiss();
+    void testCacheHit();
+    void testStaleThumbnail();
+    void testSmallImage();
+    void testResponse();
+
+private:
+    QString writeImage(const QString &name, const QSize &size);
+
+    QTemporaryDir m_dir;
+};
+
+void TstThumbnailer::initTestCase()
+{
+    // Thumbnails go to $XDG_CACHE_HOME/thumbnails.
+    QVERIFY(m_dir.isValid());
+    qputenv("XDG_CACHE_HOME", (m_dir.path() + "/cache").toUtf8());
+}
+
+QString TstThumbnailer::writeImage(const QString &name, const QSize &size)
+{
+    const QString path = m_dir.path() + "/" + name;
+    QImage image(size, QImage::Format_RGB32);
+    image.fill(Qt::darkGreen);
+    if (!image.save(path, "PNG"))
+        return QString();
+    return path;
+}
+
+void TstThumbnailer::testFileFromId_data()
+{
+    QTest::addColumn<QString>("wallpaper");
+    QTest::addColumn<QString>("file");
+
+    QTest::newRow("url") << "file:///tmp/wallpaper.jpg"
+                         << "/tmp/wallpaper.jpg";
+    QTest::newRow("space") << "file:///tmp/my wallpaper.jpg"
+                           << "/tmp/my wallpaper.jpg";
+    QTest::newRow("hash") << "file:///tmp/wallpaper%231.jpg"
+                          << "/tmp/wallpaper#1.jpg";
+    QTest::newRow("question mark") << "file:///tmp/why%3F.jpg"
+                                   << "/tmp/why?.jpg";
+    QTest::newRow("percent") << "file:///tmp/100%25.jpg"
+                             << "/tmp/100%.jpg";
+    QTest::newRow("path") << "/usr/share/backgrounds/warty-final-ubuntu.png"
+                          << "/usr/share/backgrounds/warty-final-ubuntu.png";
+}
+
+void TstThumbnailer::testFileFromId()
+{
+    QFETCH(QString, wallpaper);
+    QFETCH(QString, file);
+
+    // As WallpaperGrid.qml builds the source, and the engine splits it
+    const QString source = "image://wallpaper-thumbnail/" +
+        QString::fromUtf8(QUrl::toPercentEncoding(wallpaper, "!*'()"));
+    const QString id = QUrl(source).toString(QUrl::RemoveScheme |
+                                             QUrl::RemoveAuthority).mid(1);
+
+    QCOMPARE(ThumbnailProvider::fileFromId(id), file);
+}
+
+void TstThumbnailer::testFlavourSize()
+{
+    QCOMPARE(Thumbnailer::flavourSize(QSize(100, 60)), 128);
+    QCOMPARE(Thumbnailer::flavourSize(QSize(60, 128)), 128);
+    QCOMPARE(Thumbnailer::flavourSize(QSize(200, 129)), 256);
+    QCOMPARE(Thumbnailer::flavourSize(QSize(512, 300)), 512);
+    QCOMPARE(Thumbnailer::flavourSize(QSize(540, 960)), 1024);
+    QCOMPARE(Thumbnailer::flavourSize(QSize(4000, 3000)), 1024);
+
+    QVERIFY(Thumbnailer::thumbnailPath("/a.png", 128).contains("/thumbnails/normal/"));
+    QVERIFY(Thumbnailer::thumbnailPath("/a.png", 256).contains("/thumbnails/large/"));
+    QVERIFY(Thumbnailer::thumbnailPath("/a.png", 512).contains("/thumbnails/x-large/"));
+    QVERIFY(Thumbnailer::thumbnailPath("/a.png", 1024).contains("/thumbnails/xx-large/"));
+}
+
+void TstThumbnailer::testCacheMiss()
+{
+    const QString file = writeImage("miss.png", QSize(1000, 500));
+    QVERIFY(!file.isEmpty());
+    const QString path = Thumbnailer::thumbnailPath(file, 512);
+    QVERIFY(!QFile::exists(path));
+
+    // Scaled to the flavour of the requested size, and cached
+    QString error;
+    QImage image = Thumbnailer::thumbnail(file, QSize(300, 200), &error);
+    QVERIFY2(!image.isNull(), qPrintable(error));
+    QCOMPARE(image.size(), QSize(512, 256));
+
+    QImageReader reader(path, "png");
+    QCOMPARE(reader.size(), QSize(512, 256));
+    QCOMPARE(reader.text("Thumb::URI"),
+             QString::fromUtf8(QUrl::fromLocalFile(file).toEncoded()));
+    QCOMPARE(reader.text("Thumb::MTime"),
+             QString::number(QFileInfo(file).lastModified().toTime_t()));
+
+    // Other flavours are left alone
+    QVERIFY(!QFile::exists(Thumbnailer::thumbnailPath(file, 128)));
+}
+
+void TstThumbnailer::testCacheHit()
+{
+    const QString file = writeImage("hit.png", QSize(1000, 500));
+    QVERIFY(!file.isEmpty());
+    QVERIFY(!Thumbnailer::thumbnail(file, QSize(100, 100)).isNull());
+
+    // Replace the cached thumbnail with one we can tell apart
+    const QString path = Thumbnailer::thumbnailPath(file, 128);
+    QString uri, mtime;
+    {
+        QImageReader reader(path, "png");
+        uri = reader.text("Thumb::URI");
+        mtime = reader.text("Thumb::MTime");
+    }
+    QImage marker(QSize(10, 10), QImage::Format_RGB32);
+    marker.fill(Qt::red);
+    QImageWriter writer(path, "png");
+    writer.setText("Thumb::URI", uri);
+    writer.setText("Thumb::MTime", mtime);
+    QVERIFY(writer.write(marker));
+
+    QCOMPARE(Thumbnailer::thumbnail(file, QSize(100, 100)).size(),
+             QSize(10, 10));
+}
+
+void TstThumbnailer::testStaleThumbnail()
+{
+    const QString file = writeImage("stale.png", QSize(1000, 500));
+    QVERIFY(!file.isEmpty());
+    QVERIFY(!Thumbnailer::thumbnail(file, QSize(100, 100)).isNull());
+    const QString path = Thumbnailer::thumbnailPath(file, 128);
+
+    // A source modified since is thumbnailed again
+    const qint64 mtime = QFileInfo(file).lastModified().toTime_t() - 60;
+    struct utimbuf times;
+    times.actime = mtime;
+    times.modtime = mtime;
+    QCOMPARE(utime(QFile::encodeName(file).constData(), &times), 0);
+
+    QCOMPARE(Thumbnailer::thumbnail(file, QSize(100, 100)).size(),
+             QSize(128, 64));
+    QCOMPARE(QImageReader(path, "png").text("Thumb::MTime"),
+             QString::number(mtime));
+}
+
+void TstThumbnailer::testSmallImage()
+{
+    // Already smaller than the flavour: returned as is, and not cached
+    const QString file = writeImage("small.png", QSize(100, 50));
+    QVERIFY(!file.isEmpty());
+
+    QCOMPARE(Thumbnailer::thumbnail(file, QSize(100, 100)).size(),
+             QSize(100, 50));
+    QVERIFY(!QFile::exists(Thumbnailer::thumbnailPath(file, 128)));
+
+    QString error;
+    QVERIFY(Thumbnailer::thumbnail(m_dir.path() + "/missing.png",
+                                   QSize(100, 100), &error).isNull());
+    QVERIFY(!error.isEmpty());
+}
+
+void TstThumbnailer::testResponse()
+{
+    const QString file = writeImage("response.png", QSize(500, 1000));
+    QVERIFY(!file.isEmpty());
+
+    ThumbnailResponse response(file, QSize(200, 200));
+    QSignalSpy finished(&response, SIGNAL(finished()));
+    response.run();
+    QCOMPARE(finished.count(), 1);
+    QVERIFY(response.errorString().isEmpty());
+
+    QQuickTextureFactory *factory = response.textureFactory();
+    QCOMPARE(factory->image().size(), QSize(128, 256));
+    delete factory;
+
+    // Cancelled before it ran: finishes without an image
+    ThumbnailResponse cancelled(file, QSize(200, 200));
+    QSignalSpy cancelledFinished(&cancelled, SIGNAL(finished()));
+    cancelled.cancel();
+    cancelled.run();
+    QCOMPARE(cancelledFinished.count(), 1);
+    factory = cancelled.textureFactory();
+    QVERIFY(!factory || factory->image().isNull());
+    delete factory;
+}
+
+QTEST_GUILESS_MAIN(TstThumbnailer)
+#include "tst_thumbnailer.moc"
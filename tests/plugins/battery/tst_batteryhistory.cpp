@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2016 Canonical Ltd
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+*/
+
+#include "batteryhistory.h"
+
+#include <QSignalSpy>
+#include <QTest>
+
+#include <libupower-glib/upower.h>
+
+class TstBatteryHistory : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testDownsample();
+    void testDownsampleShort();
+    void testWraparound();
+    void testBackfill();
+    void testLastFullCharge();
+};
+
+static BatteryHistorySample makeSample(const quint32 time, const float value,
+                                       const quint8 state = UP_DEVICE_STATE_DISCHARGING)
+{
+    BatteryHistorySample sample;
+    sample.time = time;
+    sample.value = value;
+    sample.state = state;
+    return sample;
+}
+
+// Samples at first, first + 1, ..., last, slowly discharging.
+static BatteryHistoryFetch makeFetch(const quint32 first, const quint32 last)
+{
+    BatteryHistoryFetch fetch;
+    fetch.ok = true;
+    fetch.since = first;
+    for (quint32 time = first; time <= last; time++)
+        fetch.samples.append(makeSample(time, 90 - (time % 50)));
+    return fetch;
+}
+
+void TstBatteryHistory::testDownsample()
+{
+    QVector<BatteryHistorySample> input;
+    for (int i = 0; i < 1000; i++)
+        input.append(makeSample(i, i == 500 ? 5 : 80));
+
+    const QVector<BatteryHistorySample> output =
+        BatteryHistory::downsample(input, 50);
+    QCOMPARE(output.size(), 50);
+    QCOMPARE(output.first().time, quint32(0));
+    QCOMPARE(output.last().time, quint32(999));
+
+    // In order, and the dip survives
+    bool dip = false;
+    for (int i = 0; i < output.size(); i++) {
+        if (i > 0)
+            QVERIFY(output.at(i - 1).time < output.at(i).time);
+        dip |= output.at(i).time == 500;
+    }
+    QVERIFY(dip);
+}
+
+void TstBatteryHistory::testDownsampleShort()
+{
+    QVector<BatteryHistorySample> input;
+    for (int i = 0; i < 10; i++)
+        input.append(makeSample(i, 50));
+
+    QCOMPARE(BatteryHistory::downsample(input, 10).size(), 10);
+    QCOMPARE(BatteryHistory::downsample(input, 100).size(), 10);
+    QCOMPARE(BatteryHistory::downsample(input, 2).size(), 10);
+}
+
+void TstBatteryHistory::testWraparound()
+{
+    BatteryHistory history;
+    const quint32 extra = 100;
+    history.merge(makeFetch(1, BatteryHistory::Capacity + extra));
+
+    // The oldest samples were overwritten
+    QCOMPARE(history.count(), int(BatteryHistory::Capacity));
+    QCOMPARE(history.at(0).time, extra + 1);
+    QCOMPARE(history.at(history.count() - 1).time,
+             quint32(BatteryHistory::Capacity + extra));
+
+    // Wrapping again, by an incremental refresh
+    history.merge(makeFetch(BatteryHistory::Capacity + extra + 1,
+                            BatteryHistory::Capacity + extra + 10));
+    QCOMPARE(history.count(), int(BatteryHistory::Capacity));
+    QCOMPARE(history.at(0).time, extra + 11);
+
+    // Bisection across the end of the buffer
+    const quint32 since = BatteryHistory::Capacity;
+    const QVector<BatteryHistorySample> recent = history.samples(since);
+    QCOMPARE(recent.first().time, since);
+    QCOMPARE(recent.size(), int(extra + 11));
+    for (int i = 1; i < recent.size(); i++)
+        QCOMPARE(recent.at(i).time, recent.at(i - 1).time + 1);
+}
+
+void TstBatteryHistory::testBackfill()
+{
+    BatteryHistory history;
+    QSignalSpy spy(&history, SIGNAL(changed()));
+
+    history.merge(makeFetch(1000, 1100));
+    QCOMPARE(history.count(), 101);
+    QCOMPARE(spy.count(), 1);
+
+    // A wider window: older samples go in front, the rest are kept once
+    history.merge(makeFetch(500, 1110));
+    QCOMPARE(history.count(), 611);
+    QCOMPARE(history.at(0).time, quint32(500));
+    QCOMPARE(history.at(history.count() - 1).time, quint32(1110));
+    for (int i = 1; i < history.count(); i++)
+        QCOMPARE(history.at(i).time, history.at(i - 1).time + 1);
+    QCOMPARE(spy.count(), 2);
+
+    // Nothing new
+    history.merge(makeFetch(1050, 1110));
+    QCOMPARE(history.count(), 611);
+    QCOMPARE(spy.count(), 2);
+}
+
+void TstBatteryHistory::testLastFullCharge()
+{
+    BatteryHistory history;
+    QCOMPARE(history.lastFullCharge(), quint32(0));
+
+    BatteryHistoryFetch fetch;
+    fetch.ok = true;
+    fetch.samples.append(makeSample(100, 60, UP_DEVICE_STATE_CHARGING));
+    fetch.samples.append(makeSample(200, 100, UP_DEVICE_STATE_FULLY_CHARGED));
+    fetch.samples.append(makeSample(300, 95));
+    fetch.samples.append(makeSample(400, 80));
+    history.merge(fetch);
+
+    // The first sample after the full charge
+    QCOMPARE(history.lastFullCharge(), quint32(300));
+}
+
+QTEST_MAIN(TstBatteryHistory)
+#include "tst_batteryhistory.moc"
@@ -44,6 +44,7 @@ private Q_SLOTS:
     void testDeviceFound();
     void testGetDeviceFromAddress();
     void testGetDeviceFromPath();
+    void testDeviceChangedRoles();
     void cleanup();
 
 };
@@ -112,5 +113,23 @@ void DeviceModelTest::testGetDeviceFromPath()
     QVERIFY(!device->getPath().isEmpty());
 }
 
+void DeviceModelTest::testDeviceChangedRoles()
+{
+    auto device = m_devicemodel->getDeviceFromAddress("00:00:de:ad:be:ef");
+    QVERIFY(device);
+    QSignalSpy spy(m_devicemodel, SIGNAL(dataChanged(const QModelIndex&, const QModelIndex&, const QVector<int>&)));
+
+    m_bluezMock->setProperty("/org/bluez/new0/dev_00_00_DE_AD_BE_EF", "org.bluez.Device1", "Trusted", QVariant(true));
+
+    processEvents();
+
+    // The device is updated in place, and only its trusted role changes.
+    QCOMPARE(m_devicemodel->rowCount(), 1);
+    QCOMPARE(m_devicemodel->getDeviceFromAddress("00:00:de:ad:be:ef"), device);
+    QCOMPARE(spy.count(), 1);
+    QVector<int> roles = spy.at(0).at(2).value<QVector<int> >();
+    QCOMPARE(roles, QVector<int>() << DeviceModel::TrustedRole);
+}
+
 QTEST_MAIN(DeviceModelTest)
 #include "tst_devicemodel.moc"
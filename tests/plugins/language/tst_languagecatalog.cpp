@@ -0,0 +1,137 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catalog-cache.h"
+#include "language-catalog.h"
+
+#include <QTemporaryDir>
+#include <QTest>
+
+class LanguageCatalogTest: public QObject
+{
+    Q_OBJECT
+
+public:
+    LanguageCatalogTest() {};
+
+private Q_SLOTS:
+    void initTestCase();
+    void testBuild();
+    void testCacheHit();
+    void testIcuVersion();
+    void testLangpackChange();
+
+private:
+    QStringList localeNames(const QList<LanguageCatalogEntry> &entries);
+    void saveCache(const QString &icuKey, const QString &displayName);
+
+    QTemporaryDir m_dir;
+};
+
+/* Langpacks under $SNAP/usr/share/locale-langpack, and the cache under
+ * $XDG_CACHE_HOME, both in a temporary directory. */
+void LanguageCatalogTest::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    qputenv("SNAP", m_dir.path().toUtf8());
+    qputenv("XDG_CACHE_HOME", (m_dir.path() + "/cache").toUtf8());
+
+    QDir root(LanguageCatalog::langpackRoot());
+    QVERIFY(root.mkpath("en"));
+    QVERIFY(root.mkpath("fr"));
+}
+
+QStringList LanguageCatalogTest::localeNames(
+    const QList<LanguageCatalogEntry> &entries)
+{
+    QStringList names;
+    Q_FOREACH(const LanguageCatalogEntry &entry, entries)
+        names << entry.localeName;
+    names.sort();
+    return names;
+}
+
+// A cache holding one made up entry, under the key languages() uses.
+void LanguageCatalogTest::saveCache(const QString &icuKey,
+                                    const QString &displayName)
+{
+    CatalogCache cache("language-catalog");
+    cache.addDirectoryKey(QDir(LanguageCatalog::langpackRoot()).absolutePath());
+    cache.addKey(QLocale().name());
+    if (icuKey.isEmpty())
+        cache.addIcuKey();
+    else
+        cache.addKey(icuKey);
+
+    LanguageCatalogEntry entry;
+    entry.localeName = "xx_XX.UTF-8";
+    entry.displayName = displayName;
+    entry.language = "xx";
+    entry.likely = true;
+
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream << (QList<LanguageCatalogEntry>() << entry);
+    QVERIFY(cache.save(payload));
+}
+
+void LanguageCatalogTest::testBuild()
+{
+    const QList<LanguageCatalogEntry> entries = LanguageCatalog::languages();
+    QCOMPARE(localeNames(entries),
+             QStringList() << "en_US.UTF-8" << "fr_FR.UTF-8");
+    QVERIFY(QFile::exists(CatalogCache("language-catalog").fileName()));
+
+    // The same, from the cache
+    QCOMPARE(localeNames(LanguageCatalog::languages()), localeNames(entries));
+}
+
+void LanguageCatalogTest::testCacheHit()
+{
+    saveCache(QString(), "Cached");
+
+    const QList<LanguageCatalogEntry> entries = LanguageCatalog::languages();
+    QCOMPARE(entries.count(), 1);
+    QCOMPARE(entries.first().displayName, QString("Cached"));
+}
+
+void LanguageCatalogTest::testIcuVersion()
+{
+    // Display names and sort keys of another ICU are rebuilt
+    saveCache("icu-0.0", "Stale");
+
+    const QList<LanguageCatalogEntry> entries = LanguageCatalog::languages();
+    QCOMPARE(localeNames(entries),
+             QStringList() << "en_US.UTF-8" << "fr_FR.UTF-8");
+}
+
+void LanguageCatalogTest::testLangpackChange()
+{
+    saveCache(QString(), "Cached");
+
+    // Directory times have a resolution of a millisecond or better
+    QTest::qSleep(10);
+    QVERIFY(QDir(LanguageCatalog::langpackRoot()).mkpath("de"));
+
+    const QList<LanguageCatalogEntry> entries = LanguageCatalog::languages();
+    QCOMPARE(localeNames(entries),
+             QStringList() << "de_DE.UTF-8" << "en_US.UTF-8" << "fr_FR.UTF-8");
+}
+
+QTEST_GUILESS_MAIN(LanguageCatalogTest)
+#include "tst_languagecatalog.moc"
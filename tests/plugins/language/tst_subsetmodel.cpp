@@ -0,0 +1,114 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "subset-model.h"
+
+#include <QSignalSpy>
+#include <QTest>
+
+class SubsetModelTest: public QObject
+{
+    Q_OBJECT
+
+public:
+    SubsetModelTest() {};
+
+private Q_SLOTS:
+    void init();
+    void testSetAllChecked();
+    void testSetAllUncheckedKeepsOne();
+
+private:
+    QVariantList m_superset;
+};
+
+void SubsetModelTest::init()
+{
+    m_superset.clear();
+    m_superset << QVariant(QVariantList() << "a")
+               << QVariant(QVariantList() << "b")
+               << QVariant(QVariantList() << "c")
+               << QVariant(QVariantList() << "d");
+}
+
+/* Changes are ordered by their timestamps, in milliseconds, so let one
+ * pass before each of them. */
+static void nextTimestamp()
+{
+    QTest::qWait(2);
+}
+
+void SubsetModelTest::testSetAllChecked()
+{
+    SubsetModel model;
+    model.setSuperset(m_superset);
+    nextTimestamp();
+
+    QSignalSpy dataSpy(&model, SIGNAL(dataChanged(QModelIndex, QModelIndex)));
+    QSignalSpy subsetSpy(&model, SIGNAL(subsetChanged()));
+    QSignalSpy insertSpy(&model, SIGNAL(rowsInserted(QModelIndex, int, int)));
+    QSignalSpy removeSpy(&model, SIGNAL(rowsRemoved(QModelIndex, int, int)));
+
+    model.setAllChecked(true, 0);
+    QCOMPARE(dataSpy.count(), 1);
+    for (int i = 0; i < m_superset.size(); i++)
+        QVERIFY(model.checked(i));
+
+    QTRY_COMPARE(subsetSpy.count(), 1);
+    QCOMPARE(insertSpy.count(), 1);
+    QCOMPARE(model.subset(), QList<int>() << 0 << 1 << 2 << 3);
+
+    // Already all checked
+    model.setAllChecked(true, 0);
+    QCOMPARE(dataSpy.count(), 1);
+
+    nextTimestamp();
+    model.setAllChecked(false, 0);
+    QCOMPARE(dataSpy.count(), 2);
+    for (int i = 0; i < m_superset.size(); i++)
+        QVERIFY(!model.checked(i));
+
+    QTRY_COMPARE(subsetSpy.count(), 2);
+    QCOMPARE(removeSpy.count(), 1);
+    QVERIFY(model.subset().isEmpty());
+    QCOMPARE(insertSpy.count(), 1);
+}
+
+void SubsetModelTest::testSetAllUncheckedKeepsOne()
+{
+    SubsetModel model;
+    model.setAllowEmpty(false);
+    model.setSuperset(m_superset);
+    model.setSubset(QList<int>() << 2 << 1);
+    nextTimestamp();
+
+    QSignalSpy dataSpy(&model, SIGNAL(dataChanged(QModelIndex, QModelIndex)));
+    QSignalSpy subsetSpy(&model, SIGNAL(subsetChanged()));
+
+    // The first element of the subset stays checked
+    model.setAllChecked(false, 0);
+    QCOMPARE(dataSpy.count(), 1);
+    QVERIFY(model.checked(2));
+    QVERIFY(!model.checked(1));
+
+    QTRY_COMPARE(subsetSpy.count(), 1);
+    QCOMPARE(model.subset(), QList<int>() << 2);
+}
+
+QTEST_GUILESS_MAIN(SubsetModelTest)
+#include "tst_subsetmodel.moc"
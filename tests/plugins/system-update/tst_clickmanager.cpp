@@ -218,6 +218,20 @@ private slots:
                 << JSONfromQByteArray(manifest) << existing << installed
                 << uninstalled << removed << targetUpdates;
         }
+        {   // Another click at the same version doesn't install this one.
+            QByteArray manifest("["
+                "{\"name\": \"a\", \"version\": \"v1\" },"
+                "{\"name\": \"b\", \"version\": \"v2\" }"
+            "]");
+            UpdateList existing, installed, uninstalled, removed, targetUpdates;
+            auto package1 = createUpdate("a", 0, "v2");
+            existing << package1;
+            uninstalled << package1;
+            targetUpdates << package1;
+            QTest::newRow("Version of another click")
+                << JSONfromQByteArray(manifest) << existing << installed
+                << uninstalled << removed << targetUpdates;
+        }
         {   // An Image update isn't affected.
             QByteArray manifest("["
                 "{\"name\": \"a\", \"version\": \"v1\" }"
@@ -264,6 +278,36 @@ private slots:
             QVERIFY(!m_model->fetch(update).isNull());
         }
     }
+    void testSynchronizationRefreshesModelOnce()
+    {
+        QByteArray manifest("[");
+        for (uint i = 0; i < 50; i++) {
+            auto update = createUpdate(QString("app%1").arg(i), 0, "v1");
+            m_model->add(update);
+            if (i > 0)
+                manifest.append(",");
+            // Even apps are installed, odd ones have been uninstalled.
+            if (i % 2 == 0)
+                manifest.append(QString("{\"name\": \"app%1\", "
+                                        "\"version\": \"v1\"}").arg(i));
+            else
+                manifest.append(QString("{\"name\": \"other%1\", "
+                                        "\"version\": \"v0\"}").arg(i));
+        }
+        manifest.append("]");
+
+        QSignalSpy changedSpy(m_model->db(), SIGNAL(changed()));
+        QSignalSpy rowChangedSpy(
+            m_model->db(), SIGNAL(changed(const QSharedPointer<Update>&))
+        );
+        m_mockmanifest->mockSuccess(JSONfromQByteArray(manifest));
+
+        QCOMPARE(changedSpy.count(), 1);
+        QCOMPARE(rowChangedSpy.count(), 0);
+        QCOMPARE(m_model->rowCount(), 25);
+        QVERIFY(m_model->get("app0", 0)->installed());
+        QVERIFY(m_model->get("app1", 0).isNull());
+    }
     void testManifestFailureCompletesCheck()
     {
         m_instance->check();
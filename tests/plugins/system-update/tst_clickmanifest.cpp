@@ -17,21 +17,24 @@
  */
 
 /*
- * This test uses a mock web server.
+ * This test reads a click database laid out in a temporary directory.
  */
 
+#include "clickdatabase.h"
 #include "click/manifest_impl.h"
 
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QSignalSpy>
+#include <QTemporaryDir>
 #include <QTest>
-#include <QUrl>
 
 #include <QDebug>
 
 using namespace UpdatePlugin;
 
-Q_DECLARE_METATYPE(QProcess::ProcessError)
-
 class TstClickManifest
     : public QObject
 {
@@ -39,13 +42,26 @@ class TstClickManifest
 private slots:
     void init()
     {
-        m_instance = new Click::ManifestImpl();
+        m_root = new QTemporaryDir();
+
+        // Install the packages listed in click.result.
+        QFile result(QString::fromLocal8Bit(qgetenv("CLICK_RESULT")));
+        QVERIFY(result.open(QIODevice::ReadOnly));
+        auto packages = QJsonDocument::fromJson(result.readAll()).array();
+        Q_FOREACH(const auto &package, packages) {
+            install(package.toObject());
+        }
+
+        m_database = new ClickDatabase(m_root->path());
+        m_instance = new Click::ManifestImpl(m_database);
     }
     void cleanup()
     {
         QSignalSpy destroyedSpy(m_instance, SIGNAL(destroyed(QObject*)));
         m_instance->deleteLater();
         QTRY_COMPARE(destroyedSpy.count(), 1);
+        delete m_database;
+        delete m_root;
     }
     void testRequestSucceeded()
     {
@@ -56,45 +72,55 @@ private slots:
         QJsonArray res = args.at(0).toJsonArray();
         QCOMPARE(res.size(), 4); // See click.result
     }
-    void testFailedProcess_data()
+    void testRequestIsAsynchronous()
     {
-        QTest::addColumn<QProcess::ProcessError>("error");
-        QTest::newRow("Failed to start") << QProcess::FailedToStart;
-        QTest::newRow("Crashed") << QProcess::Crashed;
-        QTest::newRow("Timed out") << QProcess::Timedout;
-        QTest::newRow("Write error") << QProcess::WriteError;
-        QTest::newRow("Read error") << QProcess::ReadError;
-        QTest::newRow("Unknown error") << QProcess::UnknownError;
+        QSignalSpy requestSucceededSpy(m_instance, SIGNAL(requestSucceeded(const QJsonArray&)));
+        m_instance->request();
+        QCOMPARE(requestSucceededSpy.count(), 0);
+        QTRY_COMPARE(requestSucceededSpy.count(), 1);
     }
-    void testFailedProcess()
+    void testFailedRead()
     {
-        QFETCH(QProcess::ProcessError, error);
-        connect(
-            this, SIGNAL(mockProcessError(const QProcess::ProcessError&)),
-            m_instance, SLOT(handleProcessError(const QProcess::ProcessError&))
-        );
-        QSignalSpy requestFailedSpy(m_instance, SIGNAL(requestFailed()));
-        Q_EMIT mockProcessError(error);
+        ClickDatabase database(m_root->path() + "/nonexistent");
+        Click::ManifestImpl manifest(&database);
+        QSignalSpy requestFailedSpy(&manifest, SIGNAL(requestFailed()));
+        manifest.request();
         QTRY_COMPARE(requestFailedSpy.count(), 1);
     }
-    void testFailedParsing()
+    void testDatabaseChanged()
     {
-        /* The process will not be open for reading, so the parsing fails. */
-        connect(
-            this, SIGNAL(mockProcessSuccess(const int&)),
-            m_instance, SLOT(handleProcessSuccess(const int&))
-        );
-        QSignalSpy requestFailedSpy(m_instance, SIGNAL(requestFailed()));
-        Q_EMIT mockProcessSuccess(0);
-        QTRY_COMPARE(requestFailedSpy.count(), 1);
+        QCOMPARE(m_database->manifests().size(), 4);
+
+        QSignalSpy changedSpy(m_database, SIGNAL(changed()));
+        QJsonObject package;
+        package["name"] = "com.ubuntu.new-app";
+        package["version"] = "1.0";
+        install(package);
+        QVERIFY(changedSpy.wait());
+        QCOMPARE(m_database->manifests().size(), 5);
     }
-Q_SIGNALS:
-    void mockProcessSuccess(const int&);
-    void mockProcessError(const QProcess::ProcessError&);
 private:
+    // Lays out a package the way click installs it.
+    void install(const QJsonObject &package)
+    {
+        QString name = package["name"].toString();
+        QString version = package["version"].toString();
+        QDir dir(m_root->path());
+        QVERIFY(dir.mkpath(name + "/" + version + "/.click/info"));
+
+        QFile manifest(dir.filePath(name + "/" + version + "/.click/info/"
+                                    + name + ".manifest"));
+        QVERIFY(manifest.open(QIODevice::WriteOnly));
+        manifest.write(QJsonDocument(package).toJson());
+        manifest.close();
+
+        QVERIFY(QFile::link(version, dir.filePath(name + "/current")));
+    }
+
+    QTemporaryDir *m_root = nullptr;
+    ClickDatabase *m_database = nullptr;
     Click::ManifestImpl *m_instance = nullptr;
 };
 
 QTEST_GUILESS_MAIN(TstClickManifest)
 #include "tst_clickmanifest.moc"
-
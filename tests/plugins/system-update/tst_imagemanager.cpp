@@ -46,6 +46,7 @@ private slots:
         m_siMock = new FakeSystemImageDbus(parameters);
         m_dbus = new QDBusConnection(m_siMock->dbus());
         m_systemImage = new QSystemImage(*m_dbus);
+        QTRY_VERIFY(m_systemImage->ready());
         m_mock = new QDBusInterface(SI_SERVICE,
                                     SI_MAIN_OBJECT,
                                     "org.freedesktop.DBus.Mock",
@@ -171,6 +172,76 @@ private slots:
         QCOMPARE(u->state(), Update::State::StateDownloading);
         QCOMPARE(u->progress(), 50);
     }
+    void testUpdateProgressEta()
+    {
+        m_model->setImageUpdate(Image::ManagerImpl::ubuntuId, 2, 0);
+        Q_EMIT mockUpdateProgress(50, 30);
+        QSharedPointer<Update> u = m_model->get(Image::ManagerImpl::ubuntuId, 2);
+        QCOMPARE(u->eta(), 30.0);
+    }
+    void testUpdateProgressSkipsRepeats()
+    {
+        m_model->setImageUpdate(Image::ManagerImpl::ubuntuId, 2, 0);
+        auto instance = static_cast<Image::ManagerImpl*>(m_instance);
+        instance->setProgressInterval(0);
+
+        QSignalSpy changedSpy(m_model->db(),
+                              SIGNAL(changed(const QSharedPointer<Update>&)));
+        Q_EMIT mockUpdateProgress(10, 0);
+        Q_EMIT mockUpdateProgress(10, 0);
+        Q_EMIT mockUpdateProgress(10, 0);
+        QCOMPARE(changedSpy.count(), 1);
+    }
+    void testUpdateProgressEtaOnly()
+    {
+        m_model->setImageUpdate(Image::ManagerImpl::ubuntuId, 2, 0);
+        auto instance = static_cast<Image::ManagerImpl*>(m_instance);
+        instance->setProgressInterval(0);
+
+        QSignalSpy changedSpy(m_model->db(),
+                              SIGNAL(changed(const QSharedPointer<Update>&)));
+        QSignalSpy dataSpy(m_model, SIGNAL(dataChanged(const QModelIndex&,
+                                                       const QModelIndex&)));
+        Q_EMIT mockUpdateProgress(10, 30);
+        dataSpy.clear();
+        Q_EMIT mockUpdateProgress(10, 20);
+        Q_EMIT mockUpdateProgress(10, 10);
+
+        // The ETA reaches the model, but isn't written to the db.
+        QCOMPARE(changedSpy.count(), 1);
+        QCOMPARE(dataSpy.count(), 2);
+        QSharedPointer<Update> u = m_model->get(Image::ManagerImpl::ubuntuId, 2);
+        QCOMPARE(u->eta(), 10.0);
+
+        // Not stored, but kept when the model is refreshed from the db.
+        Q_EMIT mockUpdateProgress(11, 20);
+        m_model->refresh();
+        u = m_model->get(Image::ManagerImpl::ubuntuId, 2);
+        QCOMPARE(u->progress(), 11);
+        QCOMPARE(u->eta(), 20.0);
+    }
+    void testUpdateProgressThrottled()
+    {
+        m_model->setImageUpdate(Image::ManagerImpl::ubuntuId, 2, 0);
+        auto instance = static_cast<Image::ManagerImpl*>(m_instance);
+        instance->setProgressInterval(100);
+
+        QSignalSpy changedSpy(m_model->db(),
+                              SIGNAL(changed(const QSharedPointer<Update>&)));
+        for (int i = 1; i < 50; i++) {
+            Q_EMIT mockUpdateProgress(i, 0);
+        }
+        QCOMPARE(changedSpy.count(), 1);
+
+        // The last percentage is written once the interval has passed.
+        QTRY_COMPARE(changedSpy.count(), 2);
+        QSharedPointer<Update> u = m_model->fetch(Image::ManagerImpl::ubuntuId, 2);
+        QCOMPARE(u->progress(), 49);
+
+        // Completion is never held back.
+        Q_EMIT mockUpdateProgress(100, 0);
+        QCOMPARE(changedSpy.count(), 3);
+    }
     void testUpdatePaused()
     {
         m_model->setImageUpdate(Image::ManagerImpl::ubuntuId, 2, 0);
@@ -0,0 +1,263 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Benchmarks of the update db, model and click manager against synthetic
+ * sets of installed apps. Run through the benchmark-system-update target to
+ * get the results as XML, e.g. for comparing releases. */
+
+#include "helpers.h"
+#include "updatedb.h"
+#include "updatehistorymodel.h"
+#include "updatemodel.h"
+#include "click/manager_impl.h"
+
+#include "plugins/system-update/fakeapiclient.h"
+#include "plugins/system-update/fakemanifest.h"
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTest>
+
+using namespace UpdatePlugin;
+
+typedef QList<QSharedPointer<Update>> UpdateList;
+
+class TstUpdateBenchmark : public QObject
+{
+    Q_OBJECT
+private slots:
+    void init()
+    {
+        m_dir = new QTemporaryDir();
+        QVERIFY(m_dir->isValid());
+        m_model = new UpdateModel(m_dir->path() + "/benchmark.db");
+    }
+    void cleanup()
+    {
+        delete m_model;
+        delete m_dir;
+    }
+    void benchmarkDbInsert_data() { addSizes(); }
+    void benchmarkDbInsert()
+    {
+        QFETCH(int, apps);
+        auto updates = createUpdates(apps);
+
+        UpdateDb *db = m_model->db();
+        QBENCHMARK {
+            UpdateDb::Transaction transaction(db);
+            Q_FOREACH(auto update, updates) {
+                db->add(update);
+            }
+        }
+    }
+    void benchmarkDbGet_data() { addSizes(); }
+    void benchmarkDbGet()
+    {
+        QFETCH(int, apps);
+        auto updates = createUpdates(apps);
+        addAll(updates);
+
+        UpdateDb *db = m_model->db();
+        QBENCHMARK {
+            Q_FOREACH(auto update, updates) {
+                db->get(update->identifier(), update->revision());
+            }
+        }
+    }
+    void benchmarkModelRefresh_data() { addSizes(); }
+    void benchmarkModelRefresh()
+    {
+        QFETCH(int, apps);
+        addAll(createUpdates(apps));
+
+        // Rebuilds the model and its views from the db.
+        QBENCHMARK {
+            m_model->clear();
+        }
+        QCOMPARE(m_model->rowCount(), apps);
+    }
+    void benchmarkViewProgress_data() { addSizes(); }
+    void benchmarkViewProgress()
+    {
+        QFETCH(int, apps);
+        auto updates = createUpdates(apps);
+        addAll(updates);
+
+        // Ten downloads reporting progress side by side.
+        int downloads = qMin(apps, 10);
+        QBENCHMARK {
+            for (int progress = 0; progress < 100; progress += 10) {
+                for (int i = 0; i < downloads; i++) {
+                    m_model->setProgress(updates.at(i)->identifier(),
+                                         updates.at(i)->revision(), progress);
+                }
+            }
+        }
+    }
+    void benchmarkHistoryPage_data() { addSizes(); }
+    void benchmarkHistoryPage()
+    {
+        QFETCH(int, apps);
+        auto updates = createUpdates(apps);
+        Q_FOREACH(auto update, updates) {
+            update->setInstalled(true);
+            update->setUpdatedAt(QDateTime::currentDateTimeUtc());
+        }
+        addAll(updates);
+
+        QBENCHMARK {
+            UpdateHistoryModel history(m_model);
+            history.fetchChangelog(0);
+        }
+    }
+    void benchmarkSynchronize_data() { addSizes(); }
+    void benchmarkSynchronize()
+    {
+        QFETCH(int, apps);
+        addAll(createUpdates(apps));
+        auto manifest = createManifest(apps);
+
+        startManager();
+        /* Nothing is installed or removed, as on most checks. Outside a check
+        the manifest is only synchronized with the db. */
+        QBENCHMARK {
+            m_manifest->mockSuccess(manifest);
+        }
+        QCOMPARE(m_model->rowCount(), apps);
+    }
+    void benchmarkCheck_data() { addSizes(); }
+    void benchmarkCheck()
+    {
+        QFETCH(int, apps);
+        auto manifest = createManifest(apps);
+        auto metadata = createMetadata(apps);
+
+        startManager();
+        // Synchronization, then parsing and storing the metadata of every app.
+        QBENCHMARK {
+            m_manager->check();
+            m_manifest->mockSuccess(manifest);
+            m_client->mockMetadataRequestSucceeded(metadata);
+        }
+        QCOMPARE(m_model->rowCount(), apps);
+    }
+private:
+    void addSizes()
+    {
+        QTest::addColumn<int>("apps");
+        QTest::newRow("10") << 10;
+        QTest::newRow("100") << 100;
+        QTest::newRow("1000") << 1000;
+        QTest::newRow("5000") << 5000;
+    }
+    void startManager()
+    {
+        m_client = new MockApiClient;
+        m_manifest = new MockManifest;
+        m_manager = new Click::ManagerImpl(m_model, nullptr, m_client,
+                                           m_manifest, m_model);
+        m_client->setParent(m_manager);
+        m_manifest->setParent(m_manager);
+    }
+    void addAll(const UpdateList &updates)
+    {
+        UpdateDb::Transaction transaction(m_model->db());
+        Q_FOREACH(auto update, updates) {
+            m_model->db()->add(update);
+        }
+    }
+    static QString appId(const int &i)
+    {
+        return QString("com.example.app%1").arg(i);
+    }
+    static QString changelog()
+    {
+        // Roughly what store changelogs look like.
+        return QString("Fixed a bug where things happened.\n").repeated(16);
+    }
+    static UpdateList createUpdates(const int &count)
+    {
+        UpdateList updates;
+        for (int i = 0; i < count; i++) {
+            auto update = QSharedPointer<Update>(new Update);
+            update->setKind(Update::Kind::KindClick);
+            update->setIdentifier(appId(i));
+            update->setRevision(i + 1);
+            update->setLocalVersion("1");
+            update->setRemoteVersion("2");
+            update->setTitle(QString("App %1").arg(i));
+            update->setBinaryFilesize(1024 * 1024);
+            update->setChangelog(changelog());
+            update->setState(Update::State::StateAvailable);
+            updates << update;
+        }
+        return updates;
+    }
+    static QJsonArray createManifest(const int &count)
+    {
+        QJsonArray manifest;
+        for (int i = 0; i < count; i++) {
+            QJsonObject hook;
+            hook["desktop"] = QString("app%1.desktop").arg(i);
+            QJsonObject hooks;
+            hooks[QString("app%1").arg(i)] = hook;
+
+            QJsonObject app;
+            app["name"] = appId(i);
+            app["version"] = QString("1");
+            app["hooks"] = hooks;
+            manifest.append(app);
+        }
+        return manifest;
+    }
+    static QJsonArray createMetadata(const int &count)
+    {
+        QJsonArray metadata;
+        for (int i = 0; i < count; i++) {
+            QJsonObject download;
+            download["channel"] = Helpers::getSystemCodename();
+            download["architecture"] = QString("all");
+            download["version"] = QString("2");
+            download["revision"] = i + 1;
+            download["download_url"] = QString(
+                "https://example.org/download/%1.click").arg(appId(i));
+            download["download_sha512"] = QString("0").repeated(128);
+
+            QJsonObject app;
+            app["id"] = appId(i);
+            app["name"] = QString("App %1").arg(i);
+            app["icon"] = QString("https://example.org/icon/%1.png").arg(i);
+            app["filesize"] = 1024 * 1024;
+            app["changelog"] = changelog();
+            app["downloads"] = QJsonArray() << download;
+            metadata.append(app);
+        }
+        return metadata;
+    }
+
+    QTemporaryDir *m_dir = nullptr;
+    UpdateModel *m_model = nullptr;
+    Click::ManagerImpl *m_manager = nullptr;
+    MockApiClient *m_client = nullptr;
+    MockManifest *m_manifest = nullptr;
+};
+
+QTEST_GUILESS_MAIN(TstUpdateBenchmark)
+#include "tst_updatebenchmark.moc"
@@ -262,6 +262,56 @@ private slots:
         QCOMPARE(dbUpdate->error(), QString("error"));
         QCOMPARE(dbUpdate->packageName(), QString("packagename"));
     }
+    void testTransaction()
+    {
+        QSignalSpy changedSpy(m_instance, SIGNAL(changed()));
+        {
+            UpdateDb::Transaction transaction(m_instance);
+            QVERIFY(m_instance->inTransaction());
+            for (uint i = 1; i <= 10; i++) {
+                auto update = createUpdate();
+                update->setIdentifier(QString("test.app%1").arg(i));
+                update->setRevision(i);
+                m_instance->add(update);
+            }
+            // Changes are visible within the transaction, but not announced.
+            QCOMPARE(m_instance->updates().count(), 10);
+            QCOMPARE(changedSpy.count(), 0);
+        }
+        QVERIFY(!m_instance->inTransaction());
+        QCOMPARE(changedSpy.count(), 1);
+        QCOMPARE(m_instance->updates().count(), 10);
+    }
+    void testNestedTransaction()
+    {
+        QSignalSpy changedSpy(m_instance, SIGNAL(changed()));
+        auto update = createUpdate();
+        update->setIdentifier("test.app");
+        update->setRevision(1);
+        {
+            UpdateDb::Transaction outer(m_instance);
+            {
+                UpdateDb::Transaction inner(m_instance);
+                m_instance->add(update);
+            }
+            QVERIFY(m_instance->inTransaction());
+            QCOMPARE(changedSpy.count(), 0);
+            m_instance->remove(update);
+        }
+        QCOMPARE(changedSpy.count(), 1);
+        QCOMPARE(m_instance->updates().count(), 0);
+    }
+    void testJournalMode()
+    {
+        QTemporaryDir dir;
+        auto instance = new UpdateDb(dir.path() + "/journaltest.db");
+        QSqlQuery q(instance->db());
+        QVERIFY(q.exec("PRAGMA journal_mode"));
+        QVERIFY(q.next());
+        QCOMPARE(q.value(0).toString(), QString("wal"));
+        q.finish();
+        delete instance;
+    }
     void testSchemaVersion()
     {
         QSqlQuery q(m_instance->db());
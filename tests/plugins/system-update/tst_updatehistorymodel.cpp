@@ -0,0 +1,197 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QDate>
+#include <QSignalSpy>
+#include <QTest>
+
+#include "update.h"
+#include "updatehistorymodel.h"
+#include "updatemodel.h"
+
+using namespace UpdatePlugin;
+
+Q_DECLARE_METATYPE(QList<QSharedPointer<Update> >)
+
+class TstUpdateHistoryModel : public QObject
+{
+    Q_OBJECT
+private slots:
+    void init()
+    {
+        m_model = new UpdateModel(":memory:");
+        m_db = m_model->db();
+    }
+    void cleanup()
+    {
+        QSignalSpy destroyedSpy(m_model, SIGNAL(destroyed(QObject*)));
+        m_model->deleteLater();
+        QTRY_COMPARE(destroyedSpy.count(), 1);
+    }
+    QSharedPointer<Update> createInstalledUpdate(const QString &id,
+                                                 const int &daysAgo)
+    {
+        auto update = QSharedPointer<Update>(new Update);
+        update->setIdentifier(id);
+        update->setRevision(1);
+        update->setKind(Update::Kind::KindClick);
+        update->setInstalled(true);
+        update->setState(Update::State::StateInstallFinished);
+        update->setUpdatedAt(QDateTime::currentDateTimeUtc().addDays(-daysAgo));
+        return update;
+    }
+    void addInstalledUpdates(const int &count)
+    {
+        UpdateDb::Transaction transaction(m_db);
+        for (int i = 0; i < count; i++) {
+            m_db->add(createInstalledUpdate(QString("app%1").arg(i), i));
+        }
+    }
+    void testNoUpdates()
+    {
+        UpdateHistoryModel history(m_model);
+        QCOMPARE(history.rowCount(), 0);
+        QVERIFY(!history.canFetchMore(QModelIndex()));
+    }
+    void testSort_data()
+    {
+        QTest::addColumn<QList<QSharedPointer<Update>> >("updates");
+        QTest::addColumn<QStringList>("idOrder");
+
+        auto old = createInstalledUpdate("old", 1);
+        auto older = createInstalledUpdate("older", 2);
+        auto oldest = createInstalledUpdate("oldest", 3);
+        auto pending = createInstalledUpdate("pending", 0);
+        pending->setInstalled(false);
+
+        QStringList order; order << "old" << "older" << "oldest";
+        QList<QSharedPointer<Update> > updates1;
+        updates1 << old << older << oldest << pending;
+        QTest::newRow("old, older, oldest") << updates1 << order;
+
+        QList<QSharedPointer<Update> > updates2;
+        updates2 << pending << oldest << older << old;
+        QTest::newRow("oldest, older, old") << updates2 << order;
+    }
+    void testSort()
+    {
+        QFETCH(QList<QSharedPointer<Update>>, updates);
+        QFETCH(QStringList, idOrder);
+
+        Q_FOREACH(auto update, updates) {
+            m_model->add(update);
+        }
+
+        UpdateHistoryModel *history = m_model->installed();
+        QCOMPARE(history->rowCount(), idOrder.size());
+        for (int i = 0; i < history->rowCount(); i++) {
+            QCOMPARE(
+                history->data(history->index(i), UpdateModel::IdRole).toString(),
+                idOrder.at(i)
+            );
+        }
+    }
+    void testPaging()
+    {
+        addInstalledUpdates(25);
+
+        UpdateHistoryModel history(m_model, 10);
+        QCOMPARE(history.rowCount(), 10);
+        QVERIFY(history.canFetchMore(QModelIndex()));
+
+        QSignalSpy insertedSpy(&history,
+            SIGNAL(rowsInserted(const QModelIndex&, int, int)));
+        history.fetchMore(QModelIndex());
+        QCOMPARE(history.rowCount(), 20);
+        QCOMPARE(insertedSpy.count(), 1);
+        QCOMPARE(insertedSpy.takeFirst().at(1).toInt(), 10);
+
+        history.loadMore();
+        QCOMPARE(history.rowCount(), 25);
+        QVERIFY(!history.canFetchMore(QModelIndex()));
+        QCOMPARE(
+            history.data(history.index(24), UpdateModel::IdRole).toString(),
+            QString("app24")
+        );
+    }
+    void testChangelogOnDemand()
+    {
+        auto update = createInstalledUpdate("app", 0);
+        update->setChangelog("Fixed everything.");
+        m_db->add(update);
+        m_db->add(createInstalledUpdate("other", 1));
+
+        UpdateHistoryModel history(m_model);
+        QCOMPARE(history.rowCount(), 2);
+        QVERIFY(history.data(history.index(0),
+                             UpdateHistoryModel::HasChangelogRole).toBool());
+        QCOMPARE(history.data(history.index(0),
+                              UpdateModel::ChangelogRole).toString(),
+                 QString(""));
+        QVERIFY(!history.data(history.index(1),
+                              UpdateHistoryModel::HasChangelogRole).toBool());
+
+        QSignalSpy changedSpy(&history,
+            SIGNAL(dataChanged(const QModelIndex&, const QModelIndex&)));
+        history.fetchChangelog(0);
+        QCOMPARE(changedSpy.count(), 1);
+        QCOMPARE(history.data(history.index(0),
+                              UpdateModel::ChangelogRole).toString(),
+                 QString("Fixed everything."));
+
+        // Rows without a changelog don't go to the db.
+        history.fetchChangelog(1);
+        QCOMPARE(changedSpy.count(), 1);
+    }
+    void testRefreshOnInstall()
+    {
+        addInstalledUpdates(3);
+        auto pending = createInstalledUpdate("pending", 0);
+        pending->setInstalled(false);
+        m_model->add(pending);
+
+        UpdateHistoryModel *history = m_model->installed();
+        QCOMPARE(history->rowCount(), 3);
+
+        QSignalSpy countSpy(history, SIGNAL(countChanged()));
+        m_model->setInstalled("pending", 1);
+        QCOMPARE(countSpy.count(), 1);
+        QCOMPARE(history->rowCount(), 4);
+        QCOMPARE(
+            history->data(history->index(0), UpdateModel::IdRole).toString(),
+            QString("pending")
+        );
+    }
+    void testIgnoresPendingProgress()
+    {
+        addInstalledUpdates(3);
+        auto pending = createInstalledUpdate("pending", 0);
+        pending->setInstalled(false);
+        m_model->add(pending);
+
+        QSignalSpy resetSpy(m_model->installed(), SIGNAL(modelReset()));
+        m_model->setProgress("pending", 1, 50);
+        QCOMPARE(resetSpy.count(), 0);
+    }
+private:
+    UpdateDb *m_db = nullptr;
+    UpdateModel *m_model = nullptr;
+};
+
+QTEST_GUILESS_MAIN(TstUpdateHistoryModel)
+#include "tst_updatehistorymodel.moc"
@@ -86,19 +86,19 @@ private slots:
     }
     void testPendingUpdates()
     {
-        QVERIFY(m_instance->pendingUpdates());
+        QCOMPARE(m_instance->pendingUpdates(), m_model->pending());
     }
     void testClickUpdates()
     {
-        QVERIFY(m_instance->clickUpdates());
+        QCOMPARE(m_instance->clickUpdates(), m_model->clicks());
     }
     void testImageUpdates()
     {
-        QVERIFY(m_instance->imageUpdates());
+        QCOMPARE(m_instance->imageUpdates(), m_model->images());
     }
     void testInstalledUpdates()
     {
-        QVERIFY(m_instance->installedUpdates());
+        QCOMPARE(m_instance->installedUpdates(), m_model->installed());
     }
     void testStatus_data()
     {
@@ -183,10 +183,10 @@ private slots:
 private:
     UpdateManager *m_instance = nullptr;
     UpdateModel *m_model = nullptr;
-    UpdateModelFilter *m_pending = nullptr;
-    UpdateModelFilter *m_clicks = nullptr;
-    UpdateModelFilter *m_images = nullptr;
-    UpdateModelFilter *m_installed = nullptr;
+    UpdateModelView *m_pending = nullptr;
+    UpdateModelView *m_clicks = nullptr;
+    UpdateModelView *m_images = nullptr;
+    UpdateModelView *m_installed = nullptr;
     MockClickManager *m_clickManager = nullptr;
     MockImageManager *m_imageManager = nullptr;
 };
@@ -24,6 +24,7 @@
 #include <QTest>
 
 #include "update.h"
+#include "updatehistorymodel.h"
 #include "updatemodel.h"
 
 using namespace UpdatePlugin;
@@ -41,8 +42,6 @@ private slots:
     {
         m_model = new UpdateModel(":memory:");
         m_db = m_model->db();
-        m_filter = new UpdateModelFilter(m_model);
-        m_filter->setSourceModel(m_model);
     }
     void cleanup()
     {
@@ -538,67 +537,40 @@ private slots:
         QVERIFY(names[UpdateModel::Roles::ErrorRole] == "error");
         QVERIFY(names[UpdateModel::Roles::PackageNameRole] == "packageName");
         QVERIFY(names[UpdateModel::Roles::SignedDownloadUrlRole] == "signedDownloadUrl");
+        QVERIFY(names[UpdateModel::Roles::EtaRole] == "eta");
     }
-    void testFilterKinds_data()
-    {
-        QTest::addColumn<Update::Kind>("kind");
-        QTest::newRow("Unknown") << Update::Kind::KindUnknown;
-        QTest::newRow("Click") << Update::Kind::KindClick;
-        QTest::newRow("Images") << Update::Kind::KindImage;
-    }
-    void testFilterKinds()
-    {
-        QFETCH(Update::Kind, kind);
-
-        m_filter->filterOnKind((uint) kind);
-        QCOMPARE((uint) m_filter->kindFilter(), (uint) kind);
-    }
-    void testFilterInstalled_data()
-    {
-        QTest::addColumn<bool>("installed");
-
-        QTest::newRow("Installed") << true;
-        QTest::newRow("Not installed") << false;
-    }
-    void testFilterInstalled()
-    {
-        QFETCH(bool, installed);
-
-        m_filter->filterOnInstalled(installed);
-        QCOMPARE(m_filter->installed(), installed);
-    }
-    void testFilterKindsIntegration_data()
+    void testViewKinds_data()
     {
         QTest::addColumn<QList<QSharedPointer<Update>> >("updates");
-        QTest::addColumn<Update::Kind>("kindFilter");
-        QTest::addColumn<int>("targetCount");
+        QTest::addColumn<int>("clickCount");
+        QTest::addColumn<int>("imageCount");
 
         QList<QSharedPointer<Update>> sample;
         sample << createClickUpdate("a", 1) << createClickUpdate("b", 2)
                << createImageUpdate("u", 1);
 
-        QTest::newRow("Filter on clicks") << sample << Update::Kind::KindClick << 2;
-        QTest::newRow("Filter on images") << sample << Update::Kind::KindImage << 1;
-
+        QTest::newRow("Clicks and images") << sample << 2 << 1;
     }
-    void testFilterKindsIntegration()
+    void testViewKinds()
     {
         QFETCH(QList<QSharedPointer<Update> >, updates);
-        QFETCH(Update::Kind, kindFilter);
-        QFETCH(int, targetCount);
+        QFETCH(int, clickCount);
+        QFETCH(int, imageCount);
 
         Q_FOREACH(auto update, updates) {
             m_model->add(update);
         }
 
-        m_filter->filterOnKind((uint) kindFilter);
-        QCOMPARE(m_filter->rowCount(), targetCount);
+        QCOMPARE(m_model->clicks()->rowCount(), clickCount);
+        QCOMPARE(m_model->images()->rowCount(), imageCount);
+        QCOMPARE(m_model->pending()->rowCount(), clickCount + imageCount);
+        QCOMPARE(m_model->installed()->rowCount(), 0);
     }
-    void testFilteringInstalledIntegration_data()
+    void testViewInstalled_data()
     {
         QTest::addColumn<QList<QSharedPointer<Update>> >("updates");
-        QTest::addColumn<bool>("installedFilter");
-        QTest::addColumn<int>("targetCount");
+        QTest::addColumn<int>("pendingCount");
+        QTest::addColumn<int>("installedCount");
 
         auto installed = createUpdate("a", 1);
         installed->setInstalled(true);
@@ -606,21 +578,92 @@ private slots:
         QList<QSharedPointer<Update>> sample;
         sample << createUpdate("b", 1) << createUpdate("c", 1) << installed;
 
-        QTest::newRow("Filter not installed") << sample << false << 2;
-        QTest::newRow("Filter installed") << sample << true << 1;
+        QTest::newRow("Some installed") << sample << 2 << 1;
     }
-    void testFilteringInstalledIntegration()
+    void testViewInstalled()
     {
         QFETCH(QList<QSharedPointer<Update> >, updates);
-        QFETCH(bool, installedFilter);
-        QFETCH(int, targetCount);
+        QFETCH(int, pendingCount);
+        QFETCH(int, installedCount);
 
         Q_FOREACH(auto update, updates) {
             m_model->add(update);
         }
 
-        m_filter->filterOnInstalled(installedFilter);
-        QCOMPARE(m_filter->rowCount(), targetCount);
+        QCOMPARE(m_model->pending()->rowCount(), pendingCount);
+        QCOMPARE(m_model->installed()->rowCount(), installedCount);
+    }
+    void testViewMembershipChanges()
+    {
+        m_model->add(createClickUpdate("a", 1));
+        m_model->add(createClickUpdate("b", 1));
+        m_model->add(createImageUpdate("u", 1));
+
+        QSignalSpy clicksRemoved(m_model->clicks(),
+            SIGNAL(rowsRemoved(const QModelIndex&, int, int)));
+        QSignalSpy installedCount(m_model->installed(),
+            SIGNAL(countChanged()));
+        QSignalSpy imagesChanged(m_model->images(),
+            SIGNAL(dataChanged(const QModelIndex&, const QModelIndex&)));
+        QSignalSpy imagesReset(m_model->images(), SIGNAL(modelReset()));
+
+        m_model->setInstalled("a", 1);
+
+        QCOMPARE(clicksRemoved.count(), 1);
+        QCOMPARE(installedCount.count(), 1);
+        QCOMPARE(imagesChanged.count(), 0);
+        QCOMPARE(imagesReset.count(), 0);
+        QCOMPARE(m_model->clicks()->rowCount(), 1);
+        QCOMPARE(m_model->pending()->rowCount(), 2);
+        QCOMPARE(m_model->installed()->rowCount(), 1);
+    }
+    void testViewProgress()
+    {
+        m_model->add(createClickUpdate("a", 1));
+        m_model->add(createClickUpdate("b", 1));
+
+        QSignalSpy clicksChanged(m_model->clicks(),
+            SIGNAL(dataChanged(const QModelIndex&, const QModelIndex&)));
+        QSignalSpy clicksMoved(m_model->clicks(),
+            SIGNAL(rowsMoved(const QModelIndex&, int, int, const QModelIndex&, int)));
+        QSignalSpy clicksCount(m_model->clicks(), SIGNAL(countChanged()));
+
+        m_model->setProgress("b", 1, 50);
+
+        QCOMPARE(clicksChanged.count(), 1);
+        QCOMPARE(clicksMoved.count(), 0);
+        QCOMPARE(clicksCount.count(), 0);
+        auto index = clicksChanged.takeFirst().at(0).value<QModelIndex>();
+        QCOMPARE(index.row(), 1);
+        QCOMPARE(m_model->clicks()->data(index, UpdateModel::ProgressRole).toInt(), 50);
+    }
+    void testViewMovesOnSortKeyChange()
+    {
+        auto a = createUpdate("a", 1);
+        a->setTitle("A");
+        auto b = createUpdate("b", 1);
+        b->setTitle("B");
+        m_model->add(a);
+        m_model->add(b);
+
+        auto update = m_model->get("a", 1);
+        update->setTitle("C");
+        m_model->update(update);
+
+        UpdateModelView *view = m_model->pending();
+        QCOMPARE(view->rowCount(), 2);
+        QCOMPARE(view->data(view->index(0, 0), UpdateModel::TitleRole).toString(),
+                 QString("B"));
+        QCOMPARE(view->data(view->index(1, 0), UpdateModel::TitleRole).toString(),
+                 QString("C"));
+    }
+    void testViewRemoval()
+    {
+        m_model->add(createClickUpdate("a", 1));
+        m_model->remove("a", 1);
+
+        QCOMPARE(m_model->clicks()->rowCount(), 0);
+        QCOMPARE(m_model->pending()->rowCount(), 0);
     }
     void testPendingSort_data()
     {
@@ -648,62 +691,22 @@ private slots:
         QFETCH(QList<QSharedPointer<Update>>, updates);
         QFETCH(QStringList, titleOrder);
 
-        m_filter->filterOnInstalled(false);
         Q_FOREACH(auto update, updates) {
             m_model->add(update);
         }
 
-        QCOMPARE(m_filter->rowCount(), 3);
-        for (int i = 0; i < m_filter->rowCount(); i++) {
+        UpdateModelView *view = m_model->pending();
+        QCOMPARE(view->rowCount(), 3);
+        for (int i = 0; i < view->rowCount(); i++) {
             QCOMPARE(
-                 m_filter->data(m_filter->index(i, 0), UpdateModel::TitleRole).toString(),
+                 view->data(view->index(i, 0), UpdateModel::TitleRole).toString(),
                  titleOrder.at(i)
             );
         }
     }
-    void testInstalledSort_data()
-    {
-        QTest::addColumn<QList<QSharedPointer<Update>> >("updates");
-        QTest::addColumn<QStringList>("idOrder");
-
-        auto old = createUpdate("old", 1);
-        old->setUpdatedAt(QDateTime(QDate(2012, 1, 1)));
-        old->setInstalled(true);
-        auto older = createUpdate("older", 1);
-        older->setUpdatedAt(QDateTime(QDate(2011, 1, 1)));
-        older->setInstalled(true);
-        auto oldest = createUpdate("oldest", 1);
-        oldest->setUpdatedAt(QDateTime(QDate(2010, 1, 1)));
-        oldest->setInstalled(true);
-        QList<QSharedPointer<Update> > updates1; updates1 << old << older << oldest;
-        QStringList order1; order1 << "old" << "older" << "oldest";
-        QTest::newRow("old, older, oldest") << updates1 << order1;
-
-        QList<QSharedPointer<Update> > updates2; updates2 << oldest << older << old;
-        QTest::newRow("oldest, older, old") << updates2 << order1;
-    }
-    void testInstalledSort()
-    {
-        QFETCH(QList<QSharedPointer<Update>>, updates);
-        QFETCH(QStringList, idOrder);
-
-        m_filter->filterOnInstalled(true);
-        Q_FOREACH(auto update, updates) {
-            m_model->add(update);
-        }
-
-        QCOMPARE(m_filter->rowCount(), 3);
-        for (int i = 0; i < m_filter->rowCount(); i++) {
-            QCOMPARE(
-                 m_filter->data(m_filter->index(i, 0), UpdateModel::IdRole).toString(),
-                 idOrder.at(i)
-            );
-        }
-    }
 private:
     UpdateDb *m_db = nullptr;
     UpdateModel *m_model = nullptr;
-    UpdateModelFilter *m_filter = nullptr;
 };
 
 QTEST_GUILESS_MAIN(TstUpdateModel)
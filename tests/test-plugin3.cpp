@@ -0,0 +1,66 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test-plugin3.h"
+
+#include <QTimer>
+#include <SystemSettings/ItemBase>
+
+using namespace SystemSettings;
+
+// An item whose backend answers on the next pass of the event loop.
+class TestItem3: public ItemBase
+{
+    Q_OBJECT
+
+public:
+    TestItem3(const QVariantMap &staticData, QObject *parent = 0);
+
+    void prefetch();
+};
+
+TestItem3::TestItem3(const QVariantMap &staticData, QObject *parent):
+    ItemBase(staticData, parent)
+{
+    setName("Sound & Vibration");
+    setVisible(true);
+    setReady(false);
+}
+
+void TestItem3::prefetch()
+{
+    QTimer::singleShot(0, this, [this]() { setReady(true); });
+}
+
+TestPlugin3::TestPlugin3():
+    QObject()
+{
+}
+
+ItemBase *TestPlugin3::createItem(const QVariantMap &staticData,
+                                  QObject *parent)
+{
+    return new TestItem3(staticData, parent);
+}
+
+void TestPlugin3::prefetch(ItemBase *item)
+{
+    static_cast<TestItem3*>(item)->prefetch();
+}
+
+#include "test-plugin3.moc"
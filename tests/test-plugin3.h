@@ -0,0 +1,39 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYSTEM_SETTINGS_TEST_PLUGIN3_H
+#define SYSTEM_SETTINGS_TEST_PLUGIN3_H
+
+#include <QObject>
+#include <SystemSettings/PluginInterface>
+
+class TestPlugin3: public QObject, public SystemSettings::PluginInterface3
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID "com.ubuntu.SystemSettings.PluginInterface/3.0")
+    Q_INTERFACES(SystemSettings::PluginInterface2 SystemSettings::PluginInterface3)
+
+public:
+    TestPlugin3();
+
+    SystemSettings::ItemBase *createItem(const QVariantMap &staticData,
+                                         QObject *parent = 0);
+    void prefetch(SystemSettings::ItemBase *item);
+};
+
+#endif // SYSTEM_SETTINGS_TEST_PLUGIN3_H
@@ -0,0 +1,153 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QObject>
+#include <QTest>
+
+#include <SystemSettings/ObjectListModel>
+
+using namespace SystemSettings;
+
+class TestItem: public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QString name READ name NOTIFY nameChanged)
+
+public:
+    explicit TestItem(const QString &path): m_path(path) {}
+
+    QString getPath() const { return m_path; }
+    QString name() const { return m_name; }
+
+    void setProperties(const QVariantMap &properties)
+    {
+        const QString name = properties.value("Name").toString();
+        if (name == m_name) return;
+        m_name = name;
+        Q_EMIT(nameChanged());
+    }
+
+Q_SIGNALS:
+    void nameChanged();
+
+private:
+    QString m_path;
+    QString m_name;
+};
+
+/* Announces the object again from createItem(), as a D-Bus signal handled
+ * in the nested event loop of the bluetooth DeviceModel would. */
+class TestModel: public ObjectListModel<TestItem>
+{
+public:
+    TestModel(): ObjectListModel<TestItem>("org.example.Item"),
+        m_reenter(false), m_created(0)
+    {
+        addPropertyRole("name", Qt::DisplayRole);
+        setKeyProperty("name");
+    }
+
+    QVariant data(const QModelIndex &index, int role) const
+    {
+        ItemPointer item = itemAt(index.row());
+        return item && role == Qt::DisplayRole ? item->name() : QVariant();
+    }
+
+    bool m_reenter;
+    int m_created;
+
+protected:
+    ItemPointer createItem(const QString &path, const QVariantMap &properties)
+    {
+        m_created++;
+        if (m_reenter) {
+            m_reenter = false;
+            QVariantMap inner;
+            inner["Name"] = "inner";
+            addObject(path, inner);
+        }
+        ItemPointer item(new TestItem(path));
+        item->setProperties(properties);
+        return item;
+    }
+};
+
+class ObjectListModelTest: public QObject
+{
+    Q_OBJECT
+
+public:
+    ObjectListModelTest() {};
+
+private Q_SLOTS:
+    void testAddRemove();
+    void testReenteredAdd();
+};
+
+static QVariantMap named(const QString &name)
+{
+    QVariantMap properties;
+    properties["Name"] = name;
+    return properties;
+}
+
+void ObjectListModelTest::testAddRemove()
+{
+    TestModel model;
+    model.addObject("/a", named("a"));
+    model.addObject("/b", named("b"));
+    model.addObject("/c", named("c"));
+    QCOMPARE(model.rowCount(), 3);
+
+    // Announced again: updated in place
+    model.addObject("/b", named("bee"));
+    QCOMPARE(model.rowCount(), 3);
+    QCOMPARE(model.m_created, 3);
+    QCOMPARE(model.itemFromKey("bee"), model.itemAt(1));
+    QVERIFY(!model.itemFromKey("b"));
+
+    model.removeObject("/a");
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(model.itemFromPath("/b"), model.itemAt(0));
+    QCOMPARE(model.itemFromPath("/c"), model.itemAt(1));
+}
+
+void ObjectListModelTest::testReenteredAdd()
+{
+    TestModel model;
+    model.addObject("/a", named("a"));
+
+    model.m_reenter = true;
+    TestModel::ItemPointer item = model.addObject("/b", named("outer"));
+
+    // One row, holding the newer properties of the nested call
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(model.itemFromPath("/b"), item);
+    QCOMPARE(model.itemAt(1), item);
+    QCOMPARE(item->name(), QString("inner"));
+    QCOMPARE(model.itemFromKey("inner"), item);
+    QVERIFY(!model.itemFromKey("outer"));
+
+    model.removeObject("/b");
+    QCOMPARE(model.rowCount(), 1);
+    QVERIFY(!model.itemFromPath("/b"));
+    QCOMPARE(model.itemFromPath("/a"), model.itemAt(0));
+}
+
+QTEST_MAIN(ObjectListModelTest)
+#include "tst_objectlistmodel.moc"
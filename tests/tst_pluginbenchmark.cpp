@@ -0,0 +1,352 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Measures how the start up of the main page scales with the number of
+ * installed panels. Every data row generates its panels under a temporary
+ * root: manifests in <root>/data, and copies of the test plugin in
+ * <root>/PLUGIN_MODULE_DIR, which is where Plugin looks for libraries when
+ * the "mountPoint" context property is <root> (as it is for snaps). */
+
+#include "item-model.h"
+#include "memory-budget.h"
+#include "plugin-manager.h"
+#include "plugin.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QObject>
+#include <QQmlContext>
+#include <QQmlEngine>
+#include <QTemporaryDir>
+#include <QTest>
+
+using namespace SystemSettings;
+
+class PluginBenchmark: public QObject
+{
+    Q_OBJECT
+
+public:
+    PluginBenchmark() {};
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void benchmarkColdStart_data();
+    void benchmarkColdStart();
+    void benchmarkWarmStart_data();
+    void benchmarkWarmStart();
+    void benchmarkReload_data();
+    void benchmarkReload();
+    void benchmarkItemModel_data();
+    void benchmarkItemModel();
+    void benchmarkFilterKeystroke_data();
+    void benchmarkFilterKeystroke();
+    void benchmarkLoadPlugins_data();
+    void benchmarkLoadPlugins();
+    void benchmarkStartUpMemory_data();
+    void benchmarkStartUpMemory();
+
+private:
+    void addSizes();
+    QString createPanels(const QString &name, const int count,
+                         const bool allDynamic = false);
+    void useRoot(const QString &root);
+    void startUp(PluginManager *manager);
+
+    QTemporaryDir *m_dir = nullptr;
+    QQmlEngine *m_engine = nullptr;
+};
+
+static const QStringList categories{"network", "personal", "system"};
+
+void PluginBenchmark::initTestCase()
+{
+    m_dir = new QTemporaryDir();
+    QVERIFY(m_dir->isValid());
+    m_engine = new QQmlEngine(this);
+}
+
+void PluginBenchmark::cleanupTestCase()
+{
+    delete m_engine;
+    delete m_dir;
+}
+
+void PluginBenchmark::addSizes()
+{
+    QTest::addColumn<int>("panels");
+    QTest::newRow("10") << 10;
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+}
+
+QString PluginBenchmark::createPanels(const QString &name, const int count,
+                                      const bool allDynamic)
+{
+    const QString root = m_dir->path() + "/" + name;
+    const QString libDir = root + PLUGIN_MODULE_DIR;
+    const QString library = QString(PLUGIN_MODULE_DIR) + "/libtest-plugin.so";
+
+    // Rows of a test function share their panels with the other functions.
+    if (QDir(root).exists())
+        return root;
+
+    if (!QDir().mkpath(root + "/" MANIFEST_DIR) || !QDir().mkpath(libDir)) {
+        qWarning() << "Can't create" << root;
+        return QString();
+    }
+
+    for (int i = 0; i < count; i++) {
+        const QString plugin = QString("bench-plugin%1").arg(i);
+
+        /* A mix of static panels and panels that have to load their plugin
+         * for their name, keywords or visibility, like on a device. */
+        QJsonObject manifest;
+        manifest["name"] = QString("Panel %1").arg(i);
+        manifest["icon"] = QString("settings");
+        manifest["category"] = categories.at(i % categories.size());
+        manifest["priority"] = i % 10;
+        manifest["keywords"] = QJsonArray::fromStringList(QStringList()
+            << "panel" << QString("keyword%1").arg(i) << plugin);
+        manifest["has-dynamic-keywords"] = allDynamic || i % 3 == 0;
+        manifest["has-dynamic-visibility"] = i % 5 == 0;
+        manifest["has-dynamic-name"] = i % 7 == 0;
+        manifest["plugin"] = plugin;
+
+        QFile file(QString("%1/%2/bench%3.settings")
+                   .arg(root).arg(MANIFEST_DIR).arg(i));
+        if (!file.open(QIODevice::WriteOnly)) {
+            qWarning() << "Can't write" << file.fileName();
+            return QString();
+        }
+        file.write(QJsonDocument(manifest).toJson());
+
+        // Copies, so that every panel really loads a library of its own.
+        if (!QFile::copy(library,
+                         QString("%1/lib%2.so").arg(libDir).arg(plugin))) {
+            qWarning() << "Can't copy" << library;
+            return QString();
+        }
+    }
+    return root;
+}
+
+void PluginBenchmark::useRoot(const QString &root)
+{
+    qputenv("XDG_DATA_DIRS", root.toUtf8());
+    qputenv("XDG_DATA_HOME", (root + "/home").toUtf8());
+    m_engine->rootContext()->setContextProperty("mountPoint", root.toUtf8());
+}
+
+/* What the main page does: a model per category, with the name, icon and
+ * keywords of every panel read by the view and the filter. */
+void PluginBenchmark::startUp(PluginManager *manager)
+{
+    QQmlEngine::setContextForObject(manager, m_engine->rootContext());
+    manager->classBegin();
+    manager->componentComplete();
+
+    Q_FOREACH(const QString &category, manager->categories()) {
+        QAbstractItemModel *model = manager->itemModel(category);
+        for (int i = 0; i < model->rowCount(); i++) {
+            QModelIndex index = model->index(i, 0);
+            model->data(index, Qt::DisplayRole);
+            model->data(index, ItemModel::IconRole);
+        }
+    }
+}
+
+void PluginBenchmark::benchmarkColdStart_data()
+{
+    addSizes();
+}
+
+void PluginBenchmark::benchmarkColdStart()
+{
+    QFETCH(int, panels);
+    const QString root = createPanels(QString("panels%1").arg(panels), panels);
+    QVERIFY(!root.isEmpty());
+    useRoot(root);
+
+    // Once only; afterwards the plugins of this row are loaded.
+    QBENCHMARK_ONCE {
+        PluginManager manager;
+        startUp(&manager);
+    }
+}
+
+void PluginBenchmark::benchmarkWarmStart_data()
+{
+    addSizes();
+}
+
+void PluginBenchmark::benchmarkWarmStart()
+{
+    QFETCH(int, panels);
+    const QString root = createPanels(QString("panels%1").arg(panels), panels);
+    QVERIFY(!root.isEmpty());
+    useRoot(root);
+
+    QBENCHMARK {
+        PluginManager manager;
+        startUp(&manager);
+    }
+}
+
+void PluginBenchmark::benchmarkReload_data()
+{
+    addSizes();
+}
+
+void PluginBenchmark::benchmarkReload()
+{
+    QFETCH(int, panels);
+    const QString root = createPanels(QString("panels%1").arg(panels), panels);
+    QVERIFY(!root.isEmpty());
+    useRoot(root);
+
+    PluginManager manager;
+    QQmlEngine::setContextForObject(&manager, m_engine->rootContext());
+    QBENCHMARK {
+        manager.classBegin();
+    }
+
+    int count = 0;
+    Q_FOREACH(const QString &category, manager.categories())
+        count += manager.plugins(category).count();
+    QCOMPARE(count, panels);
+}
+
+void PluginBenchmark::benchmarkItemModel_data()
+{
+    addSizes();
+}
+
+void PluginBenchmark::benchmarkItemModel()
+{
+    QFETCH(int, panels);
+    const QString root = createPanels(QString("panels%1").arg(panels), panels);
+    QVERIFY(!root.isEmpty());
+    useRoot(root);
+
+    PluginManager manager;
+    QQmlEngine::setContextForObject(&manager, m_engine->rootContext());
+    manager.classBegin();
+
+    // What PluginManager::itemModel() sets up, for every category.
+    QBENCHMARK {
+        Q_FOREACH(const QString &category, manager.categories()) {
+            ItemModel model;
+            model.setPlugins(manager.plugins(category));
+            ItemModelSortProxy proxy;
+            proxy.setSourceModel(&model);
+            proxy.setDynamicSortFilter(true);
+            proxy.setFilterCaseSensitivity(Qt::CaseInsensitive);
+            proxy.setFilterRole(ItemModel::KeywordRole);
+            proxy.sort(0);
+        }
+    }
+}
+
+void PluginBenchmark::benchmarkFilterKeystroke_data()
+{
+    addSizes();
+}
+
+void PluginBenchmark::benchmarkFilterKeystroke()
+{
+    QFETCH(int, panels);
+    const QString root = createPanels(QString("panels%1").arg(panels), panels);
+    QVERIFY(!root.isEmpty());
+    useRoot(root);
+
+    PluginManager manager;
+    startUp(&manager);
+
+    /* One keystroke per iteration, typing and deleting the last letter of
+     * a keyword every panel has. */
+    const QString typed("pane");
+    const QString completed("panel");
+    QString filter = typed;
+    manager.setFilter(filter);
+    QBENCHMARK {
+        filter = filter == typed ? completed : typed;
+        manager.setFilter(filter);
+    }
+    manager.setFilter("");
+}
+
+void PluginBenchmark::benchmarkLoadPlugins_data()
+{
+    addSizes();
+}
+
+void PluginBenchmark::benchmarkLoadPlugins()
+{
+    QFETCH(int, panels);
+    // Panels of their own, so that none of their libraries is loaded yet.
+    const QString root = createPanels(QString("dynamic%1").arg(panels),
+                                      panels, true);
+    QVERIFY(!root.isEmpty());
+    useRoot(root);
+
+    PluginManager manager;
+    QQmlEngine::setContextForObject(&manager, m_engine->rootContext());
+    manager.classBegin();
+
+    // Dynamic keywords make Plugin load its library and create its item.
+    QBENCHMARK_ONCE {
+        Q_FOREACH(const QString &category, manager.categories()) {
+            Q_FOREACH(Plugin *plugin, manager.plugins(category))
+                plugin->keywords();
+        }
+    }
+}
+
+void PluginBenchmark::benchmarkStartUpMemory_data()
+{
+    addSizes();
+}
+
+/* How much the resident size grows for a cold start up, reported as the
+ * result of the row so that it reaches the XML output. */
+void PluginBenchmark::benchmarkStartUpMemory()
+{
+    QFETCH(int, panels);
+    // Panels of their own, so that none of their libraries is loaded yet.
+    const QString root = createPanels(QString("memory%1").arg(panels), panels);
+    QVERIFY(!root.isEmpty());
+    useRoot(root);
+
+    const qint64 before = MemoryBudget::residentSize();
+    PluginManager manager;
+    startUp(&manager);
+    const qint64 after = MemoryBudget::residentSize();
+    QVERIFY(before > 0);
+
+    QTest::setBenchmarkResult(qMax<qint64>(after - before, 0),
+                              QTest::BytesAllocated);
+}
+
+QTEST_MAIN(PluginBenchmark)
+#include "tst_pluginbenchmark.moc"
@@ -19,18 +19,51 @@
  */
 
 #include "item-model.h"
+#include "memory-budget.h"
+#include "panel-stats.h"
 #include "plugin-manager.h"
 #include "plugin.h"
+#include "visibility-predicates.h"
 
+#include <QDBusMessage>
+#include <QDBusPendingCall>
 #include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QObject>
 #include <QQmlContext>
 #include <QQmlEngine>
 #include <QSignalSpy>
+#include <QTemporaryDir>
 #include <QTest>
 
+#include <SystemSettings/DBusStats>
+
 using namespace SystemSettings;
 
+// A resident size that drops by what each released panel frees.
+class StubBudget: public MemoryBudget
+{
+public:
+    StubBudget(): MemoryBudget(100), size(0) {}
+
+    qint64 size;
+    QHash<Plugin*, qint64> frees;
+    QStringList released;
+
+protected:
+    qint64 measure() const { return size; }
+    void releasePanel(Plugin *plugin)
+    {
+        released.append(plugin->baseName());
+        size -= frees.value(plugin);
+    }
+};
+
 class PluginsTest: public QObject
 {
     Q_OBJECT
@@ -45,6 +78,12 @@ private Q_SLOTS:
     void testSorting();
     void testReset();
     void testResetInPlugin();
+    void testPrefetch();
+    void testDeepLink();
+    void testPanelStats();
+    void testDBusStats();
+    void testMemoryBudget();
+    void testVisibilityPredicates();
 };
 
 void PluginsTest::testCategory()
@@ -182,5 +221,275 @@ void PluginsTest::testResetInPlugin()
     phone->reset();
 }
 
+void PluginsTest::testPrefetch()
+{
+    PluginManager manager;
+    manager.classBegin();
+    manager.componentComplete();
+
+    Plugin *sound = qobject_cast<Plugin *>(manager.getByName("sound"));
+    QVERIFY(sound != 0);
+
+    // Until its backend answers, the entry shows the manifest data
+    QCOMPARE(sound->displayName(), QString("Sound"));
+    QVERIFY(!sound->isVisible());
+    QVERIFY(!sound->isReady());
+
+    QSignalSpy readySpy(sound, SIGNAL(readyChanged()));
+    QSignalSpy nameSpy(sound, SIGNAL(displayNameChanged()));
+    QVERIFY(readySpy.wait());
+
+    QVERIFY(sound->isReady());
+    QCOMPARE(nameSpy.count(), 1);
+    QCOMPARE(sound->displayName(), QString("Sound & Vibration"));
+    QVERIFY(sound->isVisible());
+}
+
+void PluginsTest::testDeepLink()
+{
+    PluginManager manager;
+    manager.classBegin();
+    manager.componentComplete();
+
+    // The panel is found from its manifest
+    Plugin *cellular = qobject_cast<Plugin *>(manager.getByName("cellular"));
+    QVERIFY(cellular != 0);
+    QTest::qWait(10);
+
+    QVERIFY(!manager.isPrefetching());
+    Q_FOREACH(const QString &category, manager.categories()) {
+        Q_FOREACH(Plugin *plugin, manager.plugins(category))
+            QVERIFY2(!plugin->isLoaded(), qPrintable(plugin->baseName()));
+    }
+
+    // Once the panel is shown, the main page asks for its models
+    manager.itemModel("system");
+    QVERIFY(manager.isPrefetching());
+    QTRY_VERIFY(!manager.isPrefetching());
+
+    // Only plugins with dynamic entries are loaded
+    Plugin *sound = qobject_cast<Plugin *>(manager.getByName("sound"));
+    Plugin *wireless = qobject_cast<Plugin *>(manager.getByName("wireless"));
+    Plugin *bluetooth = qobject_cast<Plugin *>(manager.getByName("bluetooth"));
+    QVERIFY(sound->isLoaded());
+    QVERIFY(wireless->isLoaded());
+    QVERIFY(!bluetooth->isLoaded());
+    QTRY_VERIFY(sound->isReady());
+}
+
+void PluginsTest::testPanelStats()
+{
+    PanelStats *stats = PanelStats::instance();
+    stats->Reset();
+
+    // Read twice per opening, as the main page does
+    stats->panelOpened("wifi");
+    stats->panelOpened("wifi");
+    QTest::qWait(10);
+    stats->panelClosed("wifi");
+    QTest::qWait(10);
+
+    // Closed after bluetooth was opened: bluetooth stays current
+    stats->panelOpened("wifi");
+    stats->panelOpened("bluetooth");
+    stats->panelClosed("wifi");
+    QTest::qWait(10);
+
+    QJsonObject root = QJsonDocument::fromJson(stats->toJson()).object();
+    QCOMPARE(root["current"].toString(), QString("bluetooth"));
+
+    QJsonObject wifi = root["panels"].toObject()["wifi"].toObject();
+    QCOMPARE(wifi["opens"].toInt(), 2);
+    QCOMPARE(wifi["closes"].toInt(), 2);
+    QVERIFY(wifi["open"].toObject()["wallMs"].toInt() >= 0);
+    QVERIFY(wifi["idle"].toObject()["wallMs"].toInt() > 0);
+
+    QJsonObject bluetooth = root["panels"].toObject()["bluetooth"].toObject();
+    QCOMPARE(bluetooth["opens"].toInt(), 1);
+    QCOMPARE(bluetooth["closes"].toInt(), 0);
+
+    // Reset while a panel is opening: nothing more is charged to it
+    stats->panelOpened("wifi");
+    stats->Reset();
+    QTest::qWait(10);
+
+    root = QJsonDocument::fromJson(stats->toJson()).object();
+    QCOMPARE(root["current"].toString(), QString("main"));
+    QVERIFY(!root["panels"].toObject().contains("wifi"));
+    QVERIFY(!root["panels"].toObject().contains("bluetooth"));
+}
+
+void PluginsTest::testDBusStats()
+{
+    QVERIFY(DBusStats::isEnabled());
+    DBusStats *stats = DBusStats::instance();
+    stats->Reset();
+    DBusStats::setCurrentPanel(QString());
+
+    QCOMPARE(DBusStats::bucket(0), 0);
+    QCOMPARE(DBusStats::bucket(1), 1);
+    QCOMPARE(DBusStats::bucket(3), 2);
+    QCOMPARE(DBusStats::bucket(1023), 10);
+    QCOMPARE(DBusStats::bucket(1024), 11);
+    QCOMPARE(DBusStats::bucket(60000), 11);
+
+    // Already answered, so no bus is needed
+    QDBusMessage message = QDBusMessage::createMethodCall(
+        "org.example.Test", "/", "org.example.Test", "Ping");
+    QDBusPendingCall call =
+        QDBusPendingCall::fromCompletedCall(message.createReply());
+
+    // Shared code, before any panel is opened
+    DBusStats::waitForFinished(call, 0, "org.example.Test", "Ping");
+
+    // Shared code, then the panel itself, while wifi is open
+    DBusStats::setCurrentPanel("wifi");
+    DBusStats::waitForFinished(call, 0, "org.example.Test", "Ping");
+    DBusStats::watch(call, 0, "org.example.Test", "Ping");
+    DBusStats::watch(call, "bluetooth", "org.example.Test", "Scan");
+    DBusStats::setCurrentPanel(QString());
+
+    // Asynchronous calls are counted when their replies are handled
+    auto readCalls = [stats]() {
+        return QJsonDocument::fromJson(stats->toJson())
+            .object()["calls"].toArray();
+    };
+    QTRY_COMPARE(readCalls().count(), 3);
+    QTRY_COMPARE(readCalls().at(2).toObject()["async"].toInt(), 1);
+
+    QJsonArray calls = readCalls();
+    QJsonObject root = QJsonDocument::fromJson(stats->toJson()).object();
+    QJsonArray buckets = root["bucketsMs"].toArray();
+    QCOMPARE(buckets.count(), 11);
+    QCOMPARE(buckets.first().toInt(), 1);
+    QCOMPARE(buckets.last().toInt(), 1024);
+
+    // Ordered by panel, service and member
+    QJsonObject bluetooth = calls.at(0).toObject();
+    QCOMPARE(bluetooth["panel"].toString(), QString("bluetooth"));
+    QCOMPARE(bluetooth["member"].toString(), QString("Scan"));
+    QCOMPARE(bluetooth["sync"].toInt(), 0);
+    QCOMPARE(bluetooth["async"].toInt(), 1);
+
+    QJsonObject main = calls.at(1).toObject();
+    QCOMPARE(main["panel"].toString(), QString("main"));
+    QCOMPARE(main["sync"].toInt(), 1);
+    QCOMPARE(main["async"].toInt(), 0);
+
+    QJsonObject wifi = calls.at(2).toObject();
+    QCOMPARE(wifi["panel"].toString(), QString("wifi"));
+    QCOMPARE(wifi["service"].toString(), QString("org.example.Test"));
+    QCOMPARE(wifi["member"].toString(), QString("Ping"));
+    QCOMPARE(wifi["sync"].toInt(), 1);
+    QCOMPARE(wifi["async"].toInt(), 1);
+    QVERIFY(wifi["longestMs"].toInt() <= wifi["totalMs"].toInt());
+    QJsonArray histogram = wifi["histogram"].toArray();
+    QCOMPARE(histogram.count(), 12);
+    int counted = 0;
+    Q_FOREACH(const QJsonValue &count, histogram)
+        counted += count.toInt();
+    QCOMPARE(counted, 2);
+
+    // Over the bus
+    QCOMPARE(stats->Dump(), QString::fromUtf8(stats->toJson()));
+    stats->Reset();
+    root = QJsonDocument::fromJson(stats->Dump().toUtf8()).object();
+    QVERIFY(root["calls"].toArray().isEmpty());
+}
+
+void PluginsTest::testMemoryBudget()
+{
+    const QString dir(PLUGIN_MANIFEST_DIR);
+    Plugin phone((QFileInfo(dir + "/phone.settings")));
+    Plugin sound((QFileInfo(dir + "/sound.settings")));
+    Plugin wireless((QFileInfo(dir + "/wireless.settings")));
+
+    StubBudget budget;
+    budget.size = 50;
+    budget.panelOpened(&phone);
+    budget.panelOpened(&sound);
+    budget.panelOpened(&wireless);
+    QTest::qWait(10);
+    QCOMPARE(budget.released, QStringList());
+
+    // Over budget: oldest first, until the measured size is within it
+    budget.frees[&phone] = 60;
+    budget.size = 150;
+    budget.enforce();
+    QCOMPARE(budget.released, QStringList() << "phone");
+    QCOMPARE(budget.size, qint64(90));
+
+    // A release that frees nothing stops the pass
+    budget.size = 150;
+    budget.panelOpened(&wireless);
+    budget.enforce();
+    QCOMPARE(budget.released, QStringList() << "phone" << "sound");
+
+    // No new pass until the process grows past where it stopped
+    budget.panelOpened(&phone);
+    QTest::qWait(10);
+    QCOMPARE(budget.released, QStringList() << "phone" << "sound");
+
+    // The current panel is never released
+    budget.size = 160;
+    budget.panelOpened(&sound);
+    QTest::qWait(10);
+    QCOMPARE(budget.released,
+             QStringList() << "phone" << "sound" << "wireless");
+    budget.size = 170;
+    budget.enforce();
+    QCOMPARE(budget.released,
+             QStringList() << "phone" << "sound" << "wireless" << "phone");
+    QTest::qWait(10);
+    QCOMPARE(budget.released.count(), 4);
+}
+
+void PluginsTest::testVisibilityPredicates()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString flag = dir.path() + "/flag";
+
+    QJsonObject visibleIf;
+    visibleIf["file-exists"] = flag;
+    QJsonObject json;
+    json["name"] = QString("Flagged");
+    json["category"] = QString("system");
+    json["visible-if"] = visibleIf;
+
+    QFile manifest(dir.path() + "/flagged.settings");
+    QVERIFY(manifest.open(QIODevice::WriteOnly));
+    manifest.write(QJsonDocument(json).toJson());
+    manifest.close();
+
+    Plugin plugin((QFileInfo(manifest.fileName())));
+    QVERIFY(plugin.hasVisibilityPredicates());
+    QSignalSpy spy(&plugin, SIGNAL(visibilityChanged()));
+
+    VisibilityPredicates predicates;
+    predicates.add(&plugin, plugin.visibilityPredicates());
+    predicates.start();
+    QTest::qWait(300);
+    QVERIFY(!plugin.isVisible());
+    QCOMPARE(spy.count(), 0);
+
+    // Creating the file flips it once, through the directory watch
+    QFile file(flag);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.close();
+    QVERIFY(spy.wait());
+    QVERIFY(plugin.isVisible());
+    QTest::qWait(300);
+    QCOMPARE(spy.count(), 1);
+
+    // File checks are seeded without waiting for the batch
+    Plugin seeded((QFileInfo(manifest.fileName())));
+    QVERIFY(seeded.isVisible());
+
+    QVERIFY(QFile::remove(flag));
+    QVERIFY(spy.wait());
+    QVERIFY(!plugin.isVisible());
+}
+
 QTEST_MAIN(PluginsTest)
 #include "tst_plugins.moc"
@@ -0,0 +1,196 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resident.h"
+
+#include <QEventLoop>
+#include <QFile>
+#include <QGuiApplication>
+#include <QObject>
+#include <QQmlContext>
+#include <QQuickItem>
+#include <QQuickView>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QTimer>
+
+#include <libqtdbustest/DBusTestRunner.h>
+
+using namespace SystemSettings;
+using namespace QtDBusTest;
+
+// Stands in for MainWindow.qml.
+static const char mainWindow[] =
+    "import QtQuick 2.4\n"
+    "Item {\n"
+    "    property string shown\n"
+    "    property var options\n"
+    "    function showMainPage() { shown = \"main\" }\n"
+    "    function loadPluginByName(name, pluginOptions) {\n"
+    "        if (name === \"missing\")\n"
+    "            return false\n"
+    "        shown = name\n"
+    "        options = pluginOptions\n"
+    "        return true\n"
+    "    }\n"
+    "}\n";
+
+class ResidentTest: public QObject
+{
+    Q_OBJECT
+
+public:
+    ResidentTest() {};
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void testRegister();
+    void testOpen();
+    void testHide();
+    void testOpenMissingPanel();
+    void testForward();
+    void testRelease();
+
+private:
+    QVariant rootProperty(const char *name) const;
+    bool releases();
+
+    DBusTestRunner *m_dbus = nullptr;
+    QTemporaryDir m_dir;
+    QQuickView *m_view = nullptr;
+    ResidentService *m_service = nullptr;
+};
+
+void ResidentTest::initTestCase()
+{
+    // A private session bus, before anything connects to the real one
+    m_dbus = new DBusTestRunner();
+    m_dbus->startServices();
+
+    QVERIFY(m_dir.isValid());
+    QFile qml(m_dir.path() + "/MainWindow.qml");
+    QVERIFY(qml.open(QIODevice::WriteOnly));
+    QVERIFY(qml.write(mainWindow) > 0);
+    qml.close();
+
+    m_view = new QQuickView();
+    m_view->setSource(QUrl::fromLocalFile(qml.fileName()));
+    QCOMPARE(m_view->status(), QQuickView::Ready);
+
+    m_service = new ResidentService(m_view, 3600);
+}
+
+void ResidentTest::cleanupTestCase()
+{
+    delete m_service;
+    delete m_view;
+    delete m_dbus;
+}
+
+QVariant ResidentTest::rootProperty(const char *name) const
+{
+    return m_view->rootObject()->property(name);
+}
+
+/* Whether Release() quits. QCoreApplication::quit() stops every event loop
+ * and keeps later ones from running, so only the last test may see it. */
+bool ResidentTest::releases()
+{
+    QEventLoop loop;
+    QTimer::singleShot(0, m_service, SLOT(Release()));
+    QTimer::singleShot(200, &loop, [&loop]() { loop.exit(1); });
+    return loop.exec() == 0;
+}
+
+void ResidentTest::testRegister()
+{
+    QVERIFY(QGuiApplication::quitOnLastWindowClosed());
+    QVERIFY(m_service->registerService());
+    QVERIFY(!QGuiApplication::quitOnLastWindowClosed());
+
+    // Another instance finds the name taken
+    ResidentService other(m_view, 3600);
+    QVERIFY(!other.registerService());
+}
+
+void ResidentTest::testOpen()
+{
+    m_service->Open(QStringList() << "system-settings" << "wifi"
+                                  << "--option" << "ssid=home");
+    QCOMPARE(rootProperty("shown").toString(), QString("wifi"));
+    QCOMPARE(rootProperty("options").toMap().value("ssid").toString(),
+             QString("home"));
+    QVERIFY(m_view->isVisible());
+
+    // What a fresh instance would have been started with
+    QQmlContext *context = m_view->rootContext();
+    QCOMPARE(context->contextProperty("defaultPlugin").toString(),
+             QString("wifi"));
+    QCOMPARE(context->contextProperty("pluginOptions").toMap()
+             .value("ssid").toString(), QString("home"));
+
+    // Without a panel, the main page
+    m_service->Open(QStringList() << "system-settings");
+    QCOMPARE(rootProperty("shown").toString(), QString("main"));
+    QCOMPARE(context->contextProperty("defaultPlugin").toString(), QString());
+    QVERIFY(m_view->isVisible());
+}
+
+void ResidentTest::testHide()
+{
+    m_view->show();
+    m_service->hide();
+    QVERIFY(!m_view->isVisible());
+
+    // Still running
+    QTest::qWait(10);
+    QVERIFY(m_view->rootObject());
+}
+
+void ResidentTest::testOpenMissingPanel()
+{
+    // A fresh instance would quit; the resident one stays hidden
+    m_service->hide();
+    m_service->Open(QStringList() << "system-settings" << "missing");
+    QVERIFY(!m_view->isVisible());
+    QCOMPARE(rootProperty("shown").toString(), QString("main"));
+}
+
+void ResidentTest::testForward()
+{
+    m_service->hide();
+    QVERIFY(ResidentService::forward(QStringList() << "system-settings"
+                                                   << "sound"));
+    QCOMPARE(rootProperty("shown").toString(), QString("sound"));
+    QVERIFY(m_view->isVisible());
+}
+
+void ResidentTest::testRelease()
+{
+    // Not while the window is shown
+    m_view->show();
+    QVERIFY(!releases());
+    QVERIFY(m_view->isVisible());
+
+    m_service->hide();
+    QVERIFY(releases());
+}
+
+QTEST_MAIN(ResidentTest)
+#include "tst_resident.moc"
@@ -0,0 +1,168 @@
+/*
+ * This file is part of system-settings
+ *
+ * Copyright (C) 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QBuffer>
+#include <QObject>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QThread>
+
+#include <SystemSettings/BlockingCall>
+
+#include "stall-watchdog.h"
+
+using namespace SystemSettings;
+
+class WorkerThread: public QThread
+{
+public:
+    const char *m_seen = 0;
+
+protected:
+    void run()
+    {
+        BlockingCall worker("Test::worker");
+        m_seen = BlockingCall::current();
+    }
+};
+
+class StallWatchdogTest: public QObject
+{
+    Q_OBJECT
+
+public:
+    StallWatchdogTest() {};
+
+private Q_SLOTS:
+    void testBlockingCallNesting();
+    void testBlockingCallOtherThread();
+    void testNoStalls();
+    void testStall();
+    void testReportRanking();
+    void testReportFile();
+
+private:
+    static QString report(const StallWatchdog &watchdog);
+    static void stall(const char *name, int duration);
+};
+
+QString StallWatchdogTest::report(const StallWatchdog &watchdog)
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    watchdog.writeReport(&buffer);
+    return QString::fromUtf8(buffer.data());
+}
+
+// Blocks the GUI thread inside a named call.
+void StallWatchdogTest::stall(const char *name, int duration)
+{
+    BlockingCall blocking(name);
+    QThread::msleep(duration);
+}
+
+void StallWatchdogTest::testBlockingCallNesting()
+{
+    QVERIFY(!BlockingCall::current());
+    {
+        BlockingCall outer("Test::outer");
+        QCOMPARE(BlockingCall::current(), "Test::outer");
+        {
+            BlockingCall inner("Test::inner");
+            QCOMPARE(BlockingCall::current(), "Test::inner");
+        }
+        QCOMPARE(BlockingCall::current(), "Test::outer");
+    }
+    QVERIFY(!BlockingCall::current());
+}
+
+void StallWatchdogTest::testBlockingCallOtherThread()
+{
+    BlockingCall outer("Test::outer");
+
+    // Calls on other threads neither show up nor disturb the GUI thread's
+    WorkerThread thread;
+    thread.start();
+    QVERIFY(thread.wait(5000));
+
+    QCOMPARE(thread.m_seen, "Test::outer");
+    QCOMPARE(BlockingCall::current(), "Test::outer");
+}
+
+void StallWatchdogTest::testNoStalls()
+{
+    StallWatchdog watchdog(1000);
+    QCOMPARE(report(watchdog),
+             QString("No GUI thread stalls over 1000 ms\n"));
+}
+
+void StallWatchdogTest::testStall()
+{
+    StallWatchdog watchdog(50);
+    QTest::qWait(100);
+
+    stall("Test::stall", 400);
+
+    // Recorded once the event loop beats again
+    QTRY_VERIFY(report(watchdog).contains("Test::stall"));
+
+    const QStringList lines = report(watchdog).split('\n');
+    QCOMPARE(lines.at(0), QString("GUI thread stalls over 50 ms, worst first:"));
+    QRegExp entry("(\\d+)\\. Test::stall: 1 stalls, (\\d+) ms in total, "
+                 "longest (\\d+) ms");
+    const int line = lines.indexOf(entry);
+    QVERIFY(line > 0);
+    QVERIFY(entry.cap(2).toInt() > 50);
+    QCOMPARE(entry.cap(3), entry.cap(2));
+
+    // The stack of the GUI thread follows, indented
+    QVERIFY(line + 1 < lines.size());
+    QVERIFY(lines.at(line + 1).startsWith("    "));
+}
+
+void StallWatchdogTest::testReportRanking()
+{
+    StallWatchdog watchdog(50);
+    QTest::qWait(100);
+
+    stall("Test::short", 150);
+    QTRY_VERIFY(report(watchdog).contains("Test::short"));
+    stall("Test::long", 500);
+    QTRY_VERIFY(report(watchdog).contains("Test::long"));
+
+    const QString text = report(watchdog);
+    QVERIFY(text.indexOf("Test::long") < text.indexOf("Test::short"));
+}
+
+void StallWatchdogTest::testReportFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.path() + "/stalls.txt";
+    qputenv("SS_STALL_REPORT", QFile::encodeName(path));
+
+    delete new StallWatchdog(1000);
+    qunsetenv("SS_STALL_REPORT");
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), QByteArray("No GUI thread stalls over 1000 ms\n"));
+}
+
+QTEST_GUILESS_MAIN(StallWatchdogTest)
+#include "tst_stallwatchdog.moc"
@@ -49,6 +49,7 @@ private Q_SLOTS:
             m_mock, SIGNAL(MethodCalled(const QString &, const QVariantList &))
         );
         m_systemImage = new QSystemImage(*m_dbus);
+        QTRY_VERIFY(m_systemImage->ready());
 
         /* The following connections help us test DBus signals that are not
         mockable. See https://github.com/martinpitt/python-dbusmock/issues/23
@@ -263,6 +264,30 @@ private Q_SLOTS:
         QTRY_COMPARE(checkingChangedSpy.count(), 2);
         QVERIFY(!m_systemImage->checkingForUpdates());
     }
+    void testReady()
+    {
+        QSystemImage si(*m_dbus);
+        QVERIFY(!si.ready());
+        QSignalSpy readySpy(&si, SIGNAL(readyChanged()));
+        QVERIFY(readySpy.wait());
+        QVERIFY(si.ready());
+        QCOMPARE(si.deviceName(), QString("test"));
+        QCOMPARE(si.downloadMode(), 0);
+        QCOMPARE(readySpy.count(), 1);
+    }
+    void testReadyResetOnOwnerChange()
+    {
+        QSignalSpy readySpy(m_systemImage, SIGNAL(readyChanged()));
+        QMetaObject::invokeMethod(
+            m_systemImage, "slotNameOwnerChanged",
+            Q_ARG(QString, "com.canonical.SystemImage"),
+            Q_ARG(QString, ":1.1"), Q_ARG(QString, ":1.2")
+        );
+        QVERIFY(!m_systemImage->ready());
+        QTRY_VERIFY(m_systemImage->ready());
+        QCOMPARE(readySpy.count(), 2);
+        QCOMPARE(m_systemImage->deviceName(), QString("test"));
+    }
     void testFailuresBeforeWarning()
     {
         // 3 is the default.